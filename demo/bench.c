@@ -0,0 +1,255 @@
+#include "ailien.h"
+#include "bench.h"
+#include "body.h"
+#include "collision.h"
+#include "layout.h"
+#include "map.h"
+#include "rng.h"
+#include "vec_list.h"
+#include "vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Benchmarks of the simulation's hot paths, run headless. Every input comes
+// from BENCH_SEED, so runs on different commits measure the same work.
+// Usage: bin/bench [output.json] [label]
+
+const uint64_t BENCH_SEED = 1;
+const char *DEFAULT_OUTPUT = "bench.json";
+const double BENCH_DT = 1.0 / 120;
+const vector_t BENCH_CENTER = {500, 500};
+const vector_t BENCH_ALIEN_OFFSET = {100, 100};
+const int BENCH_STALK_RADIUS = 15;
+// Inputs are cycled through so no single case gets lucky.
+#define NUM_PAIRS 64
+#define NUM_SIGHTS 64
+// How far from the alien the player is put for ai_can_see_player; past the
+// vision radius some of the time.
+const double SIGHT_RANGE = 100;
+const double BOX_SIDE = 10;
+// Square maps of other sizes, for how map setup and A* scale with the map.
+// Each is walled around the edge, with a wall along every WALL_EVERY-th row
+// that has a gap every WALL_EVERY columns. Searches there go between cells
+// at most SEARCH_REACH rows and columns apart, like the alien's do.
+typedef struct scale_case {
+  int size;
+  const char *init_name;
+  const char *star_name;
+  size_t init_iterations;
+} scale_case_t;
+const scale_case_t SCALES[] = {
+  {50, "map_init/50x50", "ai_star/50x50", 20},
+  {400, "map_init/400x400", "ai_star/400x400", 5},
+  {1000, "map_init/1000x1000", "ai_star/1000x1000", 2}};
+const size_t NUM_SCALES = sizeof(SCALES) / sizeof(SCALES[0]);
+const int WALL_EVERY = 10;
+const int SEARCH_REACH = 10;
+
+typedef struct bench_state {
+  map_t *map;
+  // what map_init_layout is timed on, for the scale cases
+  layout_t *layout;
+  alien_t *alien;
+  node_t *starts[NUM_PAIRS];
+  node_t *ends[NUM_PAIRS];
+  vector_t sights[NUM_SIGHTS];
+  vec_list_t *box;
+  vec_list_t *overlapping;
+  vec_list_t *apart;
+  size_t next;
+} bench_state_t;
+
+vec_list_t *bench_box(vector_t center){
+  vec_list_t *box = vec_list_init(4);
+  vec_list_add(box, vec_add(center, (vector_t){BOX_SIDE / 2, BOX_SIDE / 2}));
+  vec_list_add(box, vec_add(center, (vector_t){-BOX_SIDE / 2, BOX_SIDE / 2}));
+  vec_list_add(box, vec_add(center, (vector_t){-BOX_SIDE / 2, -BOX_SIDE / 2}));
+  vec_list_add(box, vec_add(center, (vector_t){BOX_SIDE / 2, -BOX_SIDE / 2}));
+  return box;
+}
+
+// Random pairs of open cells for A*, and random player spots for sight tests.
+void bench_pick_inputs(bench_state_t *state){
+  map_t *map = state->map;
+  rng_t rng;
+  rng_seed(&rng, BENCH_SEED);
+  list_t *open = list_init(list_size(map->struct_nodes), NULL);
+  for(size_t r = 0; r < list_size(map->struct_nodes); r++){
+    list_t *row = list_get(map->struct_nodes, r);
+    for(size_t c = 0; c < list_size(row); c++){
+      node_t *node = list_get(row, c);
+      if(strcmp(node->node->type, "node") == 0){
+        list_add(open, node);
+      }
+    }
+  }
+  assert(list_size(open) > 0);
+  for(size_t i = 0; i < NUM_PAIRS; i++){
+    state->starts[i] = list_get(open, rng_below(&rng, list_size(open)));
+    state->ends[i] = list_get(open, rng_below(&rng, list_size(open)));
+  }
+  list_free(open);
+  vector_t alien = body_get_centroid(map->alien->body);
+  for(size_t i = 0; i < NUM_SIGHTS; i++){
+    vector_t offset = {(2 * rng_double(&rng) - 1) * SIGHT_RANGE,
+                       (2 * rng_double(&rng) - 1) * SIGHT_RANGE};
+    state->sights[i] = vec_add(alien, offset);
+  }
+}
+
+// A size by size layout with the walls described at SCALES.
+layout_t *bench_layout(int size){
+  layout_t *layout = layout_init(size, size);
+  for(int r = 0; r < size; r++){
+    for(int c = 0; c < size; c++){
+      bool edge = r == 0 || c == 0 || r == size - 1 || c == size - 1;
+      bool inner = r % WALL_EVERY == 0 && c % WALL_EVERY != WALL_EVERY / 2;
+      layout_set_wall(layout, r, c, edge || inner);
+    }
+  }
+  return layout;
+}
+
+// Random pairs of open cells near each other, for A* on the scale maps.
+void bench_pick_near_pairs(bench_state_t *state, rng_t *rng){
+  map_t *map = state->map;
+  for(size_t i = 0; i < NUM_PAIRS; i++){
+    int r, c, end_r, end_c;
+    do{
+      r = rng_below(rng, map_rows(map));
+      c = rng_below(rng, map_cols(map));
+    } while(map_cell_kind(map, r, c) != CELL_NODE);
+    do{
+      end_r = r + (int)rng_below(rng, 2 * SEARCH_REACH + 1) - SEARCH_REACH;
+      end_c = c + (int)rng_below(rng, 2 * SEARCH_REACH + 1) - SEARCH_REACH;
+    } while(end_r < 0 || end_r >= map_rows(map) || end_c < 0
+      || end_c >= map_cols(map) || map_cell_kind(map, end_r, end_c) != CELL_NODE);
+    state->starts[i] = arr_get(map->struct_nodes, r, c);
+    state->ends[i] = arr_get(map->struct_nodes, end_r, end_c);
+  }
+}
+
+void run_map_init(void *aux){
+  bench_state_t *state = aux;
+  state->map = map_init_seeded(BENCH_SEED);
+}
+
+void run_map_init_layout(void *aux){
+  bench_state_t *state = aux;
+  state->map = map_init_layout(state->layout, BENCH_SEED);
+}
+
+void reset_map_init(void *aux){
+  bench_state_t *state = aux;
+  map_free(state->map);
+  state->map = NULL;
+}
+
+void run_ai_star(void *aux){
+  bench_state_t *state = aux;
+  size_t i = state->next++ % NUM_PAIRS;
+  ai_star(state->map, state->starts[i], state->ends[i]);
+}
+
+void run_ai_can_see_player(void *aux){
+  bench_state_t *state = aux;
+  size_t i = state->next++ % NUM_SIGHTS;
+  body_set_centroid(state->map->player->body, state->sights[i]);
+  ai_can_see_player(state->map, state->alien, BENCH_STALK_RADIUS);
+}
+
+void run_find_collision_overlap(void *aux){
+  bench_state_t *state = aux;
+  find_collision(state->box, state->overlapping);
+}
+
+void run_find_collision_apart(void *aux){
+  bench_state_t *state = aux;
+  find_collision(state->box, state->apart);
+}
+
+void run_scene_tick(void *aux){
+  bench_state_t *state = aux;
+  scene_tick(state->map->scene, BENCH_DT);
+}
+
+void run_bounce(void *aux){
+  bench_state_t *state = aux;
+  bounce(state->map);
+}
+
+// Drops whatever the last sample left in the frame scratch, as map_tick does.
+void reset_scratch(void *aux){
+  bench_state_t *state = aux;
+  arena_reset(state->map->scratch);
+}
+
+// Times setting up, then searching, one of SCALES.
+void bench_scale(bench_t *bench, const scale_case_t *scale){
+  bench_state_t state = {0};
+  state.layout = bench_layout(scale->size);
+  bench_run(bench, (bench_case_t){.name = scale->init_name,
+    .run = run_map_init_layout, .reset = reset_map_init, .aux = &state,
+    .batch = 1, .iterations = scale->init_iterations});
+  state.map = map_init_layout(state.layout, BENCH_SEED);
+  assert(state.map != NULL);
+  rng_t rng;
+  rng_seed(&rng, BENCH_SEED);
+  bench_pick_near_pairs(&state, &rng);
+  bench_run(bench, (bench_case_t){.name = scale->star_name, .run = run_ai_star,
+    .reset = reset_scratch, .aux = &state, .batch = 1, .iterations = NUM_PAIRS});
+  map_free(state.map);
+  layout_free(state.layout);
+}
+
+int main(int argc, char **argv){
+  const char *output = argc > 1 ? argv[1] : DEFAULT_OUTPUT;
+  const char *label = argc > 2 ? argv[2] : "";
+  bench_t *bench = bench_init();
+  bench_state_t state = {0};
+
+  bench_run(bench, (bench_case_t){.name = "map_init", .run = run_map_init,
+    .reset = reset_map_init, .aux = &state, .batch = 1, .iterations = 20});
+
+  // Everything else runs on one map laid out like the game's.
+  state.map = map_init_seeded(BENCH_SEED);
+  body_set_centroid(state.map->player->body, BENCH_CENTER);
+  body_set_centroid(state.map->alien->body, vec_add(BENCH_CENTER, BENCH_ALIEN_OFFSET));
+  state.alien = ai_init_bounds(state.map);
+  bench_pick_inputs(&state);
+  state.box = bench_box(VEC_ZERO);
+  state.overlapping = bench_box((vector_t){BOX_SIDE / 2, BOX_SIDE / 4});
+  state.apart = bench_box((vector_t){3 * BOX_SIDE, 0});
+
+  // each timed sample is one search, so every pair is timed once
+  bench_run(bench, (bench_case_t){.name = "ai_star", .run = run_ai_star,
+    .reset = reset_scratch, .aux = &state, .batch = 1, .iterations = NUM_PAIRS});
+  bench_run(bench, (bench_case_t){.name = "ai_can_see_player",
+    .run = run_ai_can_see_player, .reset = reset_scratch, .aux = &state,
+    .batch = 16, .iterations = 200});
+  body_set_centroid(state.map->player->body, BENCH_CENTER);
+  bench_run(bench, (bench_case_t){.name = "find_collision/overlap",
+    .run = run_find_collision_overlap, .aux = &state, .batch = 1000,
+    .iterations = 200});
+  bench_run(bench, (bench_case_t){.name = "find_collision/apart",
+    .run = run_find_collision_apart, .aux = &state, .batch = 1000,
+    .iterations = 200});
+  bench_run(bench, (bench_case_t){.name = "scene_tick", .run = run_scene_tick,
+    .reset = reset_scratch, .aux = &state, .batch = 1, .iterations = 200});
+  bench_run(bench, (bench_case_t){.name = "bounce", .run = run_bounce,
+    .reset = reset_scratch, .aux = &state, .batch = 1, .iterations = 200});
+
+  for(size_t i = 0; i < NUM_SCALES; i++){
+    bench_scale(bench, &SCALES[i]);
+  }
+
+  int status = bench_write_json(bench, output, label) ? 0 : 1;
+  vec_list_free(state.box);
+  vec_list_free(state.overlapping);
+  vec_list_free(state.apart);
+  ai_free(state.alien);
+  map_free(state.map);
+  bench_free(bench);
+  return status;
+}
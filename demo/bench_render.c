@@ -0,0 +1,95 @@
+#include "bench.h"
+#include "body.h"
+#include "game_render.h"
+#include "map.h"
+#include "renderer.h"
+#include "sdl_wrapper.h"
+#include "session.h"
+#include "snapshot.h"
+#include "timestep.h"
+#include "vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Benchmarks drawing the default map: the scene's polygons alone
+// (sdl_render_scene), and whole game frames (background, coins, player,
+// alien, HUD and polygons) at the game's zoom levels, drawn from a snapshot
+// by game_render_frame() just as the game draws them. Everything is drawn by
+// SDL's software renderer into memory (BACKEND_OFFSCREEN), so it runs
+// without a display and the same on every machine. After each frame case, a
+// checksum of the frame's pixels is recorded too, so a faster run can be
+// told apart from one that draws something else.
+// Run from the repository root, where images/ and fonts/ (or assets.pack)
+// are.
+// Usage: bin/bench_render [output.json] [label]
+
+const uint64_t BENCH_SEED = 1;
+const char *DEFAULT_OUTPUT = "bench_render.json";
+const size_t FRAMES = 100;
+// the game's zooms: around the player, half the map, and the whole map
+typedef struct zoom_case {
+  const char *scene_name;
+  const char *frame_name;
+  const char *check_name;
+  double zoom;
+} zoom_case_t;
+const zoom_case_t ZOOMS[] = {
+  {"sdl_render_scene/player", "frame/player", "checksum/frame/player", .1},
+  {"sdl_render_scene/dev", "frame/dev", "checksum/frame/dev", .5},
+  {"sdl_render_scene/all", "frame/all", "checksum/frame/all", 1}};
+const size_t NUM_ZOOMS = sizeof(ZOOMS) / sizeof(ZOOMS[0]);
+
+void run_render(void *aux){
+  sdl_clear();
+  sdl_render_scene(((map_t *)aux)->scene);
+}
+
+// What a frame case draws: the first snapshot of a new game.
+typedef struct frame_state {
+  game_render_t *render;
+  snapshot_t *snapshot;
+} frame_state_t;
+
+// One game frame, as the game draws it.
+void run_frame(void *aux){
+  frame_state_t *state = aux;
+  game_render_frame(state->render, state->snapshot, 1);
+}
+
+int main(int argc, char **argv){
+  const char *output = argc > 1 ? argv[1] : DEFAULT_OUTPUT;
+  const char *label = argc > 2 ? argv[2] : "";
+  // the player starts in the middle of the map
+  session_t *session = session_init(BENCH_SEED);
+  map_t *map = session->map;
+  sdl_init_backend(VEC_ZERO, map_extent(map), BACKEND_OFFSCREEN);
+  sdl_update_center(body_get_centroid(map->player->body));
+  message_init();
+  images_init();
+  renderer_set(&SNAPSHOT_RENDERER);
+  snapshot_session_start(session);
+  snapshot_buffer_t *snapshots = snapshot_buffer_init();
+  snapshot_capture(snapshot_write_begin(snapshots), session, timestep_now());
+  snapshot_publish(snapshots);
+  frame_state_t state = {game_render_init(map), snapshot_read(snapshots)};
+  bench_t *bench = bench_init();
+
+  for(size_t i = 0; i < NUM_ZOOMS; i++){
+    sdl_update_zoom(ZOOMS[i].zoom);
+    bench_run(bench, (bench_case_t){.name = ZOOMS[i].scene_name,
+      .run = run_render, .aux = map, .batch = 1, .iterations = FRAMES});
+    bench_run(bench, (bench_case_t){.name = ZOOMS[i].frame_name,
+      .run = run_frame, .aux = &state, .batch = 1, .iterations = FRAMES});
+    run_frame(&state);
+    bench_check(bench, ZOOMS[i].check_name, sdl_frame_checksum());
+  }
+
+  int status = bench_write_json(bench, output, label) ? 0 : 1;
+  bench_free(bench);
+  game_render_free(state.render);
+  snapshot_buffer_free(snapshots);
+  image_free();
+  message_free();
+  session_free(session);
+  return status;
+}
@@ -5,7 +5,15 @@
 #include "vector.h"
 #include "forces.h"
 #include "collision.h"
+#include "game_render.h"
 #include "map.h"
+#include "pacer.h"
+#include "profiler.h"
+#include "replay.h"
+#include "session.h"
+#include "snapshot.h"
+#include "timestep.h"
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -13,306 +21,184 @@
 #include <string.h>
 
 /////////////// CMDS ///////////////////////
-// 'q' quit, exit game (o/w resets at win/loss)
+// 'q' quit, exit game (once won or lost, the game stops until then)
 //  arrow keys to move
 // WASD to shoot
 // 'e' change to explosive bullets
 // 'g' change to grav gun // deprecated :(
+// 'z' zoom out (player, then half the map, then all of it) and back in
+// Usage: bin/game [recording], to also record the keys for bin/replay
 //////////////////////////////PARAMS and CONSTANTS//////////////////////////////
-// Frame bounds, should be 4x:3y
-const double WIN_DIM_X = 500.0;
-const double WIN_DIM_Y = 500.0;
-const vector_t MIN = (vector_t){0, 0};
-const vector_t MAX = (vector_t){2*WIN_DIM_X, 2*WIN_DIM_Y};
-const double VIEW_PLAYER = .1;
+// The frame is the whole map (see map_extent()). Its views: around the
+// player, VIEW_PLAYER_CELLS cells across whatever the map's size, then half
+// the map, then all of it.
+const double VIEW_PLAYER_CELLS = 10;
 const double VIEW_DEV = .5;
 const double VIEW_ALL = 1;
-const double PLAYER_VEL = 100;
-const double PLAYER_ANG = M_PI / 2;
-const double STAMINA_RATE = .03;
-const int MAX_STAMINA = 100;
-const int MIN_STAMINA = 50;
-double STAMINA = 100;
-
-int NUM_TOTAL_BULLETS;
-int NUM_EXPLOSIVES = 5;
-const rgb_color_t C_EXP = {255, 0, 0}; // red
-const double B_ELAS = 10;
-const double WIDTH_BULLET = 2;
-const double LENGTH_BULLET = 4;
-const int BULLET_SIDES = 4; // Rectangle
-const double B_MASS = 20;
-const double B_VEL = 200;
-const int STALK_RADIUS_EASY = 20;
-const int STALK_RADIUS_MEDIUM = 15;
-const int STALK_RADIUS_HARD = 10;
-// 'e' for explosive, 'g' for grav gun, .. gets changed.
-char *BULLET_TYPE = "e";
-body_t *BULLET;
+const size_t NUM_VIEWS = 3;
+// Simulation steps per second, and the most steps one slow frame may run.
+const int SIM_RATE = 120;
+const int MAX_CATCH_UP = 8;
+// Frames drawn per second at most, and whether to also wait for the
+// display's refresh. The simulation thread sleeps between steps as well.
+const double TARGET_FPS = 60;
+const bool VSYNC = false;
+const char *PROFILE_TRACE = "profile.json";
+// key events waiting for the simulation thread
+const size_t KEY_QUEUE_SIZE = 256;
+session_t *session;
 map_t *map;
-
-double PLAYER_ANGLE = 0.0;
+// set when a recording file is given on the command line
+recorder_t *recorder = NULL;
+// The simulation runs on its own thread and hands each new state to the
+// main thread, which draws it, through these.
+snapshot_buffer_t *snapshots;
+key_queue_t *keys;
+atomic_bool simulating;
+// which view is in use, 0 being the player's
+size_t view_index = 0;
+// draws the snapshots
+game_render_t *render;
 
 // Clean up
-void end_game(map_t * map){
-  map_free(map);
-  exit(0);
-}
-
-// Regain stamina faster when hiding, but still regain some when standing still. Otherwise, lose stamina.
-void set_stamina(map_t *map){
-  body_t *player = map->player->body;
-  vector_t cur_vel = body_get_velocity(player);
-  if(cur_vel.x == 0 && cur_vel.y == 0 && (STAMINA < MAX_STAMINA)){
-    if(is_hiding(map)){
-      STAMINA += 1.5 * STAMINA_RATE;
-    }
-    else{
-      STAMINA += STAMINA_RATE / 5;
-    }
-    update_stamina((int)(100 *(STAMINA - MIN_STAMINA)/MIN_STAMINA));
-  }
-  else if(STAMINA > MIN_STAMINA){
-    STAMINA -= STAMINA_RATE;
-    update_stamina((int)(100 *(STAMINA - MIN_STAMINA)/MIN_STAMINA));
+void end_game(){
+  if(recorder != NULL){
+    recorder_close(recorder, session->tick);
   }
+  PROFILE_DUMP(PROFILE_TRACE);
+  session_free(session);
+  exit(0);
 }
 
-// Make a bullet and assign to global variable (only shooting one at a time).
-// Bullet at center of screen, length by width w/ velocity in dir angle.
-void make_bullet(){
-  // Make bullet's points
-  list_t *points = list_init(BULLET_SIDES, vec_free);
-  vector_t *temp1 = malloc(sizeof(vector_t));
-  assert(temp1 != NULL);
-  *temp1 = (vector_t){LENGTH_BULLET / 2.0, WIDTH_BULLET / 2.0};
-  list_add(points, temp1);
-  vector_t *temp2 = malloc(sizeof(vector_t));
-  assert(temp2 != NULL);
-  *temp2 = (vector_t){LENGTH_BULLET / 2.0, - WIDTH_BULLET / 2.0};
-  list_add(points, temp2);
-  vector_t *temp3 = malloc(sizeof(vector_t));
-  assert(temp3 != NULL);
-  *temp3 = (vector_t){-LENGTH_BULLET / 2.0, -WIDTH_BULLET / 2.0};
-  list_add(points, temp3);
-  vector_t *temp4 = malloc(sizeof(vector_t));
-  assert(temp4 != NULL);
-  *temp4 = (vector_t){-LENGTH_BULLET / 2.0, WIDTH_BULLET / 2.0};
-  list_add(points, temp4);
-  // Set color, name
-  rgb_color_t col;
-  char *name = malloc(10*sizeof(char));
-  strcpy(name, BULLET_TYPE);
-  col = C_EXP;
-  BULLET = body_init_with_info(points, B_MASS, col, name, free);
-}
-
-// Spawns bullet, moves to correct position/orientation and adds collisions.
-void shoot(map_t *map, double angle){
-  NUM_TOTAL_BULLETS = NUM_EXPLOSIVES;
-  if(NUM_TOTAL_BULLETS > 0){
-    make_bullet();
-    body_t *bullet = BULLET;
-    // Set centroid, rotate, velocity
-    body_set_centroid(bullet, body_get_centroid(map->player->body));
-    body_set_rotation(bullet, angle);
-    vector_t vel = vec_multiply(B_VEL, vec_rotate((vector_t){1,0}, angle));
-    body_set_velocity(bullet, vel);
-    // Get rid of bullet and bounce alien back if they collide
-    NUM_EXPLOSIVES--;
-    create_physics_collision(map->scene, B_ELAS, bullet, map->alien->body, 3);
-    for(size_t i = 0; i < scene_bodies(map->scene); i++){
-      body_t *body = scene_get_body(map->scene, i);
-      // Get rid of bullet if it hits something else
-      if(strcmp((char *)body_get_info(body), "alien") != 0 && strcmp((char *)body_get_info(body), "player") != 0
-      && strcmp((char *)body_get_info(body), "g") != 0 && strcmp((char *)body_get_info(body), "e") != 0 ){
-        create_destructive_collision(map->scene, bullet, body, 1);
-      }
-    }
-    // Show it afterwards
-    scene_add_body(map->scene, bullet);
-    // Update text displaying number of bullets left
-    update_bullets(NUM_EXPLOSIVES);
+// How far a view zooms out, as sdl_update_zoom() takes it.
+double view_zoom(size_t view){
+  if(view == 0){
+    int cells = map_rows(map) > map_cols(map) ? map_rows(map) : map_cols(map);
+    double zoom = VIEW_PLAYER_CELLS / cells;
+    return zoom < VIEW_ALL ? zoom : VIEW_ALL;
   }
+  return view == 1 ? VIEW_DEV : VIEW_ALL;
 }
 
-// Handles key presses for motion, shooting. Movement velocity is constant and
-// then is halved once stamina reaches 0.
+// Passes key presses on to the simulation thread, which applies them to the
+// session (motion, shooting, quitting) before its next step.
 void key_handle(scene_t *scene, char key, key_event_type_t type, double dt, void *aux){
-  body_t *player = map->player->body;
-  vector_t vx, vy;
-  if(STAMINA > MIN_STAMINA){
-    vx = (vector_t){PLAYER_VEL, 0};
-    vy = (vector_t){0, PLAYER_VEL};
-  }
-  else{
-    vx = vec_multiply(.5, (vector_t){PLAYER_VEL, 0});
-    vy = vec_multiply(.5, (vector_t){0, PLAYER_VEL});
-  }
-  // Uncomment below if speed to scale down with stamina is desired
-  // vector_t vx = vec_multiply(STAMINA / 100.0, (vector_t){PLAYER_VEL, 0});
-  // vector_t vy = vec_multiply(STAMINA / 100.0, (vector_t){0, PLAYER_VEL});
-  if (type == KEY_PRESSED) {
-    switch(key) {
-      case 'q':
-        end_game(map);
-        break;
-      case LEFT_ARROW:
-        body_set_velocity(player, vec_negate(vx));
-        body_set_rotation(player, -2 * PLAYER_ANG);
-        PLAYER_ANGLE = 270.0;
-        break;
-      case RIGHT_ARROW:
-        body_set_velocity(player, vx);
-        body_set_rotation(player, 0 * PLAYER_ANG);
-        PLAYER_ANGLE = 90.0;
-        break;
-      case UP_ARROW:
-        body_set_velocity(player, vy);
-        body_set_rotation(player, PLAYER_ANG);
-        PLAYER_ANGLE = 0.0;
-        break;
-      case DOWN_ARROW:
-        body_set_velocity(player, vec_negate(vy));
-        body_set_rotation(player, -1 * PLAYER_ANG);
-        PLAYER_ANGLE = 180.0;
-        break;
-      // control weapon shooting with WASD, and have other keys to switch guns.
-      case 'w': // up
-        shoot(map, M_PI / 2);
-        break;
-      case 's': // down
-        shoot(map, 3 * M_PI / 2);
-        break;
-      case 'a': // left
-        shoot(map, M_PI);
-        break;
-      case 'd': // right
-        shoot(map, 0);
-        break;
+  if(key == 'z'){
+    // only the view changes, so the simulation never hears of it
+    if(type == KEY_PRESSED){
+      view_index = (view_index + 1) % NUM_VIEWS;
+      sdl_update_zoom(view_zoom(view_index));
     }
-  } else{
-    body_set_velocity(player, (VEC_ZERO));
+    return;
   }
+  key_queue_push(keys, key, type);
 }
 
-// True if image is in frame of window, false if it is not. To avoid spawning
-// images that are not needed.
-bool image_in_frame(map_t *map, body_t *image_body){
-  vector_t player_centroid = body_get_centroid(map->player->body);
-  vector_t image_centroid = body_get_centroid(image_body);
-  double delta_x = fabs(image_centroid.x - player_centroid.x);
-  double delta_y = fabs(image_centroid.y - player_centroid.y);
-  if(delta_x < 260 && delta_y < 260){
-    return 1;
-  }
-  else{
-    return 0;
-  }
-}
-
-// Renders images for hiding spots.
-void image_hiding_spots(map_t *map){
-  list_t *spots = map->hiding_spots;
-  for(size_t i = 0; i < list_size(spots); i++){
-    body_t *spots_body = ((object_t *)list_get(spots, i))->body;
-    vector_t spots_centroid = body_get_centroid(spots_body);
-    if(image_in_frame(map, spots_body) == 1){
-      if(strcmp(body_get_info(spots_body), "locker") == 0){
-        render_locker_image(spots_centroid);
-      }
-      else if(strcmp(body_get_info(spots_body), "dumpster") == 0){
-        render_dumpster_image(spots_centroid);
+// The simulation thread: applies the keys pressed so far, steps the session
+// at a fixed rate, and publishes a snapshot each time anything changed.
+// Once the game is won or lost, the session stops stepping.
+int simulate(void *aux){
+  timestep_t *ts = timestep_init(SIM_RATE, MAX_CATCH_UP);
+  pacer_t *pacer = pacer_init(SIM_RATE);
+  bool over = false;
+  bool changed = true;
+  while(atomic_load(&simulating)){
+    char key;
+    key_event_type_t type;
+    while(key_queue_pop(keys, &key, &type)){
+      if(recorder != NULL){
+        recorder_key(recorder, session->tick, key, type);
       }
+      session_key(session, key, type);
+      changed = true;
     }
-  }
-}
-
-// Renders images for coins.
-void image_coins(map_t *map){
-  list_t *coins = map->coins;
-  for(size_t i = 0; i < list_size(coins); i++){
-    body_t *coins_body = ((object_t *)list_get(coins, i))->body;
-    vector_t coins_centroid = body_get_centroid(coins_body);
-    if(image_in_frame(map, coins_body) == 1){
-      render_coin_image(coins_centroid);
+    int steps = timestep_tick(ts);
+    double dt = timestep_dt(ts);
+    for(int i = 0; i < steps && !over; i++){
+      session_step(session, dt);
+      changed = true;
+    }
+    if(!changed){
+      pacer_wait(pacer);
+      continue;
     }
+    // stamped with when the last step was due, so the renderer can
+    // interpolate from it by the wall clock
+    snapshot_t *snapshot = snapshot_write_begin(snapshots);
+    snapshot_capture(snapshot, session, timestep_now() - timestep_alpha(ts) * dt);
+    over = snapshot->won || snapshot->lost;
+    snapshot_publish(snapshots);
+    changed = false;
+    pacer_wait(pacer);
   }
+  pacer_print(pacer, "simulation", stdout);
+  pacer_free(pacer);
+  timestep_free(ts);
+  return 0;
 }
 
-// Renders images for walls.
- void image_walls(map_t *map){
-   list_t *walls = map->walls;
-   for(size_t i = 0; i < list_size(walls); i++){
-     body_t *walls_body = ((object_t *)list_get(walls, i))->body;
-     vector_t walls_centroid = body_get_centroid(walls_body);
-     if(image_in_frame(map, walls_body) == 1){
-       render_wall_image(walls_centroid);
-     }
-   }
- }
-
-// Renders images for doors.
- void image_doors(map_t *map){
-   list_t *doors = map->doors;
-   for(size_t i = 0; i < list_size(doors); i++){
-     body_t *doors_body = ((object_t *)list_get(doors, i))->body;
-     vector_t doors_centroid = body_get_centroid(doors_body);
-     if(image_in_frame(map, doors_body) == 1){
-       render_door_image(doors_centroid);
-     }
-   }
- }
+// Draws and shows one frame from a snapshot, interpolated by how long ago
+// its last step was due.
+void render_frame(snapshot_t *snapshot){
+  double alpha = (timestep_now() - snapshot->time) * SIM_RATE;
+  alpha = alpha < 0 ? 0 : alpha > 1 ? 1 : alpha;
+  game_render_frame(render, snapshot, alpha);
+  sdl_show();
+}
 
 // Setup and main loop.
-int main(){
+int main(int argc, char **argv){
   // Initialize everything:
-  map = map_init();
-  sdl_init(MIN, MAX);
-  vector_t center = (vector_t){WIN_DIM_X, WIN_DIM_Y};
-  body_set_centroid(map->player->body, center);
-  body_set_centroid(map->alien->body, vec_add(center, (vector_t){100, 100}));
-  alien_t *alien = ai_init_bounds(map);
-  sdl_update_zoom(VIEW_PLAYER);
+  session = session_init(rng_seed_from_time());
+  map = session->map;
+  if(argc > 1){
+    recorder = recorder_open(argv[1], map->seed, SIM_RATE);
+    if(recorder == NULL){
+      session_free(session);
+      return 1;
+    }
+  }
+  sdl_init(VEC_ZERO, map_extent(map));
+  sdl_update_zoom(view_zoom(view_index));
   sdl_on_key(key_handle);
   message_init(); // initialize TTF and font
   images_init(); // initialize image surface and textures
-  // While game is still running, update stamina and player velocity, direct
-  // the ailien, update sdl frame, check win/loss conditions, render text and
-  // images.
-  while (!sdl_is_done(map->scene, NULL)){
-    double dt = time_since_last_tick();
-    set_stamina(map);
-    ai_stalk(map, alien, STALK_RADIUS_MEDIUM, dt);
-    sdl_update_center(body_get_centroid(map->player->body));
-    sdl_clear();
-    if(map_lose(map)){
-      while (!sdl_is_done(map->scene, NULL)){
-        sdl_clear();
-        lose_message();
-        sdl_render_scene(map->scene);
-      }
+  render = game_render_init(map);
+  // The simulation (stamina, ailien, map) steps at a fixed rate on its own
+  // thread and reports to a snapshot rather than to the screen. SDL wants
+  // its window on the main thread, so this one polls keys and draws the
+  // latest snapshot, as often as it can, until the window closes or 'q'.
+  renderer_set(&SNAPSHOT_RENDERER);
+  snapshot_session_start(session);
+  snapshots = snapshot_buffer_init();
+  keys = key_queue_init(KEY_QUEUE_SIZE);
+  atomic_init(&simulating, true);
+  SDL_Thread *simulation = SDL_CreateThread(simulate, "simulation", NULL);
+  assert(simulation != NULL);
+  if(VSYNC && !sdl_set_vsync(true)){
+    fprintf(stderr, "vsync not available, pacing to %.0f fps only\n", TARGET_FPS);
+  }
+  pacer_t *pacer = pacer_init(TARGET_FPS);
+  while (!sdl_is_done(NULL, NULL)){
+    snapshot_t *snapshot = snapshot_read(snapshots);
+    if(snapshot != NULL && snapshot->quit){
+      break;
     }
-    else if(map_win(map)){
-      while (!sdl_is_done(map->scene, NULL)){
-        sdl_clear();
-        win_message();
-        sdl_render_scene(map->scene);
-      }
+    if(snapshot != NULL){
+      render_frame(snapshot);
+      PROFILE_FRAME();
     }
-    map_tick(map, dt);
-    render_player_image(PLAYER_ANGLE);
-    render_alien_image(body_get_centroid(map->alien->body));
-    image_hiding_spots(map);
-    image_coins(map);
-    image_walls(map);
-    image_doors(map);
-    render_text(0, 0);
-    sdl_render_scene(map->scene);
+    pacer_wait(pacer);
   }
   // Clean up.
+  atomic_store(&simulating, false);
+  SDL_WaitThread(simulation, NULL);
+  pacer_print(pacer, "render", stdout);
+  pacer_free(pacer);
+  snapshot_buffer_free(snapshots);
+  key_queue_free(keys);
+  game_render_free(render);
   image_free();
   message_free();
-  end_game(map);
-  ai_free(alien);
+  end_game();
 }
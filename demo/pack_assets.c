@@ -0,0 +1,19 @@
+#include "sdl_wrapper.h"
+#include <stdio.h>
+
+// Asset packer: decodes the game's images and rasterizes its fonts once,
+// offline, into one pre-decoded file (see asset_pack.h) that the game maps
+// at startup instead. Run from the repository root, where images/ and fonts/
+// are; "make assets.pack" does this whenever they change.
+// Usage: bin/pack_assets [pack]
+
+const char *DEFAULT_PACK = "assets.pack";
+
+int main(int argc, char **argv){
+  const char *path = argc > 1 ? argv[1] : DEFAULT_PACK;
+  if(!sdl_write_asset_pack(path)){
+    return 1;
+  }
+  printf("wrote %s\n", path);
+  return 0;
+}
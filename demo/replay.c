@@ -0,0 +1,96 @@
+#include "counters.h"
+#include "profiler.h"
+#include "replay.h"
+#include "session.h"
+#include "timestep.h"
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Headless replayer: plays a recording made with `bin/game <file>` back
+// through the same session code on the same fixed step, with no display,
+// timing every step and counting the work done (see counters.h). Prints the
+// final state hash, and if an expected hash is given, exits with 1 when it
+// differs so builds can be checked against a known-good run.
+// Built with make PROFILE=1, it also prints per-zone times per step and
+// writes a trace to profile.json.
+// Usage: bin/replay <recording> [expected_hash]
+
+int compare_doubles(const void *a, const void *b){
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+// The value below which the given fraction of the sorted samples fall.
+double percentile(double *sorted, size_t n, double fraction){
+  size_t i = (size_t)(fraction * (n - 1) + .5);
+  return sorted[i];
+}
+
+int main(int argc, char **argv){
+  if(argc < 2){
+    fprintf(stderr, "usage: %s <recording> [expected_hash]\n", argv[0]);
+    return 2;
+  }
+  replay_t *replay = replay_open(argv[1]);
+  if(replay == NULL){
+    return 2;
+  }
+  uint32_t ticks = replay_ticks(replay);
+  double dt = 1.0 / replay_rate(replay);
+  session_t *session = session_init(replay_seed(replay));
+  double *times = malloc((ticks > 0 ? ticks : 1) * sizeof(double));
+  assert(times != NULL);
+  double total = 0;
+  counters_reset();
+  replay_event_t event;
+  for(uint32_t t = 0; ; t++){
+    while(replay_next(replay, t, &event)){
+      session_key(session, event.key, event.type);
+    }
+    // the game stops stepping on 'q', so a replay does too
+    if(t == ticks || session->quit){
+      break;
+    }
+    double start = timestep_now();
+    session_step(session, dt);
+    times[t] = timestep_now() - start;
+    total += times[t];
+    PROFILE_FRAME();
+    counters_frame();
+  }
+  uint32_t steps = session->tick;
+  uint64_t hash = session_hash(session);
+  printf("seed %" PRIu64 " rate %d events %zu\n",
+    replay_seed(replay), replay_rate(replay), replay_events(replay));
+  printf("ticks %" PRIu32 " in %.3f s\n", steps, total);
+  if(steps > 0){
+    qsort(times, steps, sizeof(double), compare_doubles);
+    printf("us/tick mean %.1f p50 %.1f p99 %.1f max %.1f\n",
+      1e6 * total / steps, 1e6 * percentile(times, steps, .5),
+      1e6 * percentile(times, steps, .99), 1e6 * times[steps - 1]);
+  }
+  counters_print(stdout);
+  printf("hash %016" PRIx64 "\n", hash);
+#ifdef PROFILE
+  char text[2048];
+  prof_overlay_text(text, sizeof(text));
+  printf("per step over the last %d:\n%s", PROF_FRAMES, text);
+  PROFILE_DUMP("profile.json");
+#endif
+  int status = 0;
+  if(argc > 2){
+    uint64_t expected = strtoull(argv[2], NULL, 16);
+    if(hash != expected){
+      printf("hash mismatch: expected %016" PRIx64 "\n", expected);
+      status = 1;
+    }
+  }
+  free(times);
+  session_free(session);
+  replay_free(replay);
+  return status;
+}
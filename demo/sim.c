@@ -0,0 +1,90 @@
+#include "ailien.h"
+#include "body.h"
+#include "counters.h"
+#include "map.h"
+#include "vector.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+// Headless simulation: runs the game loop (ai_stalk + map_tick) with scripted
+// player movement and no display, as fast as possible, then reports timing.
+// Runs with the same seed are identical, down to the work counters printed
+// at the end (counted per tick, from the first tick on) and the pool sizes. The map is the town
+// unless a map file (see include/layout.h) is given.
+// Usage: bin/sim [ticks] [seed] [map]
+
+const int DEFAULT_TICKS = 10000;
+const uint64_t DEFAULT_SEED = 1;
+// Same step as the game's fixed-timestep loop.
+const double SIM_DT = 1.0 / 120;
+const int STALK_RADIUS = 15;
+const double SIM_PLAYER_VEL = 100;
+// The player walks a square, turning every LEG_TICKS ticks.
+const int LEG_TICKS = 150;
+const vector_t ALIEN_OFFSET = {100, 100};
+
+// One row of the pool table: how many are live now, the most ever live, and
+// the room the pool's slabs hold.
+void print_pool(const char *name, pool_stats_t stats){
+  printf("%-18s %14zu %12zu %10zu %10zu\n", name, stats.live, stats.peak,
+    stats.capacity, stats.slabs);
+}
+
+// Scripted input: which way the player is walking at a given tick.
+vector_t scripted_velocity(int tick){
+  switch((tick / LEG_TICKS) % 4){
+    case 0: return (vector_t){SIM_PLAYER_VEL, 0};
+    case 1: return (vector_t){0, SIM_PLAYER_VEL};
+    case 2: return (vector_t){-SIM_PLAYER_VEL, 0};
+    default: return (vector_t){0, -SIM_PLAYER_VEL};
+  }
+}
+
+int main(int argc, char **argv){
+  int ticks = argc > 1 ? atoi(argv[1]) : DEFAULT_TICKS;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 10) : DEFAULT_SEED;
+  map_t *map = argc > 3 ? map_init_from(argv[3], seed) : map_init_seeded(seed);
+  if(map == NULL){
+    return 1;
+  }
+  // start in the middle of the map, as the game does
+  vector_t center = vec_multiply(0.5, map_extent(map));
+  body_set_centroid(map->player->body, center);
+  // the alien a little way off, but still inside maps smaller than that
+  vector_t alien_start = vec_add(center, (vector_t){fmin(ALIEN_OFFSET.x, center.x / 2),
+                                                    fmin(ALIEN_OFFSET.y, center.y / 2)});
+  body_set_centroid(map->alien->body, alien_start);
+  alien_t *alien = ai_init_bounds(map);
+  int caught = 0;
+  counters_reset();
+  clock_t start = clock();
+  for(int t = 0; t < ticks; t++){
+    body_set_velocity(map->player->body, scripted_velocity(t));
+    ai_stalk(map, alien, STALK_RADIUS, SIM_DT);
+    map_tick(map, SIM_DT);
+    if(map_lose(map)){
+      // keep going so every run does the same amount of work
+      caught++;
+      body_set_centroid(map->alien->body, alien_start);
+    }
+    counters_frame();
+  }
+  double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+  vector_t p = body_get_centroid(map->player->body);
+  vector_t a = body_get_centroid(map->alien->body);
+  printf("seed %llu map %dx%d\n", (unsigned long long)seed, map_rows(map),
+    map_cols(map));
+  printf("ticks %d in %.3f s (%.1f us/tick)\n", ticks, secs, ticks > 0 ? 1e6 * secs / ticks : 0);
+  printf("player (%.2f, %.2f) alien (%.2f, %.2f) purse %d caught %d\n",
+    p.x, p.y, a.x, a.y, map->purse, caught);
+  counters_print(stdout);
+  printf("%-18s %14s %12s %10s %10s\n", "pool", "live", "peak", "capacity",
+    "slabs");
+  print_pool("bodies", body_pool_stats());
+  print_pool("objects", object_pool_stats());
+  print_pool("forces", force_pool_stats());
+  ai_free(alien);
+  map_free(map);
+  return 0;
+}
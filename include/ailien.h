@@ -48,6 +48,27 @@ void ai_free(alien_t *alien);
  */
 void ai_stalk(map_t *map, alien_t *alien, int stalk_radius, double tick);
 
+/**
+ * A* from one node to another.
+ *
+ * @param map the map
+ * @param start the node to start from
+ * @param end the node to reach
+ * @return the nodes from start to end. Lives in the map's frame scratch.
+ */
+list_t *ai_star(map_t *map, node_t *start, node_t *end);
+
+/**
+ * Whether the player is within the alien's vision radius and not hidden
+ * behind a wall or hiding spot.
+ *
+ * @param map the map
+ * @param alien alien
+ * @param stalk_radius, how far
+ * @return true if the alien can see the player
+ */
+bool ai_can_see_player(map_t *map, alien_t *alien, int stalk_radius);
+
 // AI just chases around to player's position. For testing purposes.
 /**
  * Setup and initialization. Pulls some items out of map for easy access.
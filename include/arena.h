@@ -0,0 +1,64 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * A region allocator. Hands out memory by bumping a pointer through large
+ * chunks, and releases everything at once in arena_reset() or arena_free().
+ * Individual allocations are never freed on their own, so anything put in an
+ * arena must share the arena's lifetime (e.g. the whole map, or one frame).
+ */
+typedef struct arena arena_t;
+
+/**
+ * Allocates a new, empty arena.
+ * Asserts that the required memory was allocated.
+ *
+ * @param chunk_size the size in bytes of each chunk requested from malloc.
+ *   Allocations larger than this get a chunk of their own.
+ * @return a pointer to the newly allocated arena
+ */
+arena_t *arena_init(size_t chunk_size);
+
+/**
+ * Releases every chunk owned by the arena, and the arena itself.
+ * All pointers handed out by the arena become invalid.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_free(arena_t *arena);
+
+/**
+ * Allocates size bytes from the arena, aligned for any type.
+ * Asserts that the required memory was allocated.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ * @param size the number of bytes to allocate
+ * @return a pointer to the uninitialized memory
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+// Same as arena_alloc(), but zeroes the memory.
+void *arena_calloc(arena_t *arena, size_t size);
+
+// Copies a string into the arena.
+char *arena_strdup(arena_t *arena, const char *str);
+
+/**
+ * Makes all memory in the arena available again without returning it to
+ * malloc. The first chunk is kept; any extra chunks are freed so that a
+ * single spike does not pin memory forever.
+ *
+ * @param arena a pointer to an arena returned from arena_init()
+ */
+void arena_reset(arena_t *arena);
+
+// Number of bytes handed out since the last reset.
+size_t arena_used(arena_t *arena);
+
+// Number of chunks currently held from malloc.
+size_t arena_chunks(arena_t *arena);
+
+#endif // #ifndef __ARENA_H__
@@ -0,0 +1,113 @@
+#ifndef __ASSET_PACK_H__
+#define __ASSET_PACK_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Longest entry name, with its terminating '\0'.
+#define ASSET_NAME_SIZE 64
+
+/**
+ * A single file of named, already-decoded assets: RGBA images ready to be
+ * made into textures, and plain data such as glyph metrics. It is written
+ * once by bin/pack_assets ("make assets.pack") and mapped into memory at
+ * startup, so loading needs no image codecs or font rasterizer, and every
+ * running game shares the same pages of it.
+ *
+ * The file is a header, an index of entries, then each entry's bytes,
+ * 16-byte aligned. Numbers are in the byte order of the machine that
+ * wrote it; a pack from a machine with the other order fails to open.
+ */
+typedef struct asset_pack asset_pack_t;
+
+// One entry of a pack. For images, data holds width * height RGBA32
+// pixels, row by row with no padding; for other data, width and height
+// are 0.
+typedef struct asset {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+    size_t size;
+    const void *data;
+} asset_t;
+
+/**
+ * Maps a pack file into memory, read-only.
+ *
+ * @param path the pack file, e.g. "assets.pack"
+ * @return the pack, or NULL if the file is missing or not a valid pack
+ */
+asset_pack_t *asset_pack_open(const char *path);
+
+// Unmaps the pack. Asset data from it is invalid afterwards.
+void asset_pack_close(asset_pack_t *pack);
+
+/**
+ * Looks up an entry by name.
+ *
+ * @param pack the pack, or NULL (which has no entries)
+ * @param name the entry's name
+ * @param asset set to the entry if found
+ * @return whether the entry was found
+ */
+bool asset_pack_find(asset_pack_t *pack, const char *name, asset_t *asset);
+
+/**
+ * Looks up an image by name, checking that it holds exactly its width *
+ * height pixels, so a damaged or mismatched entry is never read past its end.
+ *
+ * @param pack the pack, or NULL (which has no entries)
+ * @param name the entry's name
+ * @param asset set to the entry if found
+ * @return whether the entry was found and is a whole, non-empty image
+ */
+bool asset_pack_find_image(asset_pack_t *pack, const char *name, asset_t *asset);
+
+/**
+ * Collects entries in memory for a new pack, then writes them out at once:
+ * ```
+ * asset_pack_writer_t *writer = asset_pack_writer_init();
+ * asset_pack_add_image(writer, "images/coin.png", w, h, pixels, pitch);
+ * asset_pack_write(writer, "assets.pack");
+ * asset_pack_writer_free(writer);
+ * ```
+ */
+typedef struct asset_pack_writer asset_pack_writer_t;
+
+// Allocates a writer with no entries.
+asset_pack_writer_t *asset_pack_writer_init(void);
+
+// Frees the writer and its copies of the entries.
+void asset_pack_writer_free(asset_pack_writer_t *writer);
+
+/**
+ * Adds an image, copying its pixels.
+ *
+ * @param writer the writer
+ * @param name the entry's name, shorter than ASSET_NAME_SIZE
+ * @param width the image's width in pixels
+ * @param height the image's height in pixels
+ * @param pixels RGBA32 pixels
+ * @param pitch bytes from the start of one row of pixels to the next
+ */
+void asset_pack_add_image(asset_pack_writer_t *writer, const char *name,
+                          uint32_t width, uint32_t height, const void *pixels,
+                          size_t pitch);
+
+// Adds size bytes of data, copying them.
+void asset_pack_add_data(asset_pack_writer_t *writer, const char *name,
+                         const void *data, size_t size);
+
+/**
+ * Writes every entry added so far to a file, replacing it. The pack is
+ * written beside it as path.tmp and then renamed over it, so a game that
+ * has the old file mapped keeps reading the old pack.
+ *
+ * @param writer the writer
+ * @param path the file to write
+ * @return whether the file was written in full
+ */
+bool asset_pack_write(asset_pack_writer_t *writer, const char *path);
+
+#endif // #ifndef __ASSET_PACK_H__
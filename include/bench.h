@@ -0,0 +1,84 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A small benchmark harness. Each case is run for some untimed warmup
+ * samples, then for a fixed number of timed samples of a fixed number of
+ * calls each, on a monotonic wall clock. Results are reported per call
+ * (median, 99th percentile, min and mean, in nanoseconds), printed as they
+ * finish and saved together as JSON.
+ *
+ * Keep names, batches, iterations and inputs (seeds) fixed, and results from
+ * different commits can be compared directly.
+ */
+typedef struct bench bench_t;
+
+// Code under test. Takes the case's aux.
+typedef void (*bench_func_t)(void *aux);
+
+typedef struct bench_case {
+    // unique within a run, e.g. "find_collision/overlap"
+    const char *name;
+    // the call being measured
+    bench_func_t run;
+    // called untimed after every sample (warmup too), e.g. to free what run
+    // made; may be NULL
+    bench_func_t reset;
+    void *aux;
+    // calls to run per timed sample; raise it for calls much shorter than a
+    // microsecond so clock overhead doesn't dominate
+    size_t batch;
+    // timed samples. iterations / 10 (at least 1) untimed ones come first
+    size_t iterations;
+} bench_case_t;
+
+/**
+ * Allocates a harness with no results.
+ *
+ * @return a pointer to the newly allocated harness
+ */
+bench_t *bench_init(void);
+
+// Frees the harness and its results.
+void bench_free(bench_t *bench);
+
+/**
+ * Runs one case, records its result and prints it.
+ * Asserts that run is set and that batch and iterations are positive.
+ *
+ * @param bench a pointer to a harness returned from bench_init()
+ * @param test the case to run
+ */
+void bench_run(bench_t *bench, bench_case_t test);
+
+/**
+ * Records a value that should stay the same from run to run, such as a
+ * checksum of what the code under test produced, so a comparison can tell
+ * a faster run from one that does something else. Printed, and saved with
+ * the results.
+ *
+ * @param bench a pointer to a harness returned from bench_init()
+ * @param name unique within a run, e.g. "checksum/frame/all"
+ * @param value the value
+ */
+void bench_check(bench_t *bench, const char *name, uint64_t value);
+
+/**
+ * Writes every result and check so far as JSON:
+ * {"label": ..., "results": [{"name", "batch", "iterations", "median_ns",
+ * "p99_ns", "min_ns", "mean_ns"}, ...], "checks": [{"name", "value"}, ...]}
+ * Check values are written as hex strings, since JSON numbers can't hold
+ * every 64-bit value.
+ *
+ * @param bench a pointer to a harness returned from bench_init()
+ * @param path the file to write
+ * @param label saved alongside the results, e.g. the commit they came from
+ * @return whether the file was written
+ */
+bool bench_write_json(bench_t *bench, const char *path, const char *label);
+
+#endif // #ifndef __BENCH_H__
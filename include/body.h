@@ -9,6 +9,7 @@
 #include "list.h"
 #include "vector.h"
 #include "polygon.h"
+#include "pool.h"
 
 /**
  * A rigid body constrained to the plane.
@@ -30,11 +31,26 @@ typedef struct body body_t;
  */
 body_t *body_init(list_t *shape, double mass, rgb_color_t color);
 
+/**
+ * Same as body_init(), but the body, its polygon and its force lists live in
+ * an arena. The shape should come from the same arena (see vec_list_init_in())
+ * and is adopted rather than copied.
+ * body_free() on such a body only releases its info and force links.
+ *
+ * @param arena the arena to allocate from
+ * @param shape a list of vectors describing the initial shape of the body
+ * @param mass the mass of the body (if INFINITY, stops the body from moving)
+ * @param color the color of the body, used to draw it on the screen
+ * @return a pointer to the newly allocated body
+ */
+body_t *body_init_in(arena_t *arena, vec_list_t *shape, double mass, rgb_color_t color);
+
 // overload constr. that takes in void * aux info. body WILL NOT take responsibility for freeing info.
 body_t *body_init_with_info(list_t *shape, double mass, rgb_color_t color, void *aux, free_func_t freer);
 
 // puts info into body, regardless of whether there is info there already or not.
 // should free info if prior info is there and replaced. this shouldn't really happen ever though.
+// freer may be NULL if the body does not own the info (e.g. it lives in an arena).
 void body_put_info(void *body, void *aux, free_func_t freer);
 
 // get void * info...
@@ -42,11 +58,15 @@ void *body_get_info(body_t *body);
 
 /**
  * Releases the memory allocated for a body.
+ * Heap bodies go back to the body pool rather than to free().
  *
  * @param body a pointer to a body returned from body_init()
  */
 void body_free(void *body);
 
+// Live and peak counts of heap bodies.
+pool_stats_t body_pool_stats(void);
+
 /**
  * Gets the current shape of a body.
  * Returns a newly allocated vector list, which must be list_free()d.
@@ -56,6 +76,10 @@ void body_free(void *body);
  */
 list_t *body_get_shape(body_t *body);
 
+// Gets the body's own vertex list without copying it.
+// Must not be modified or freed by the caller.
+vec_list_t *body_get_points(body_t *body);
+
 /**
  * Gets the current center of mass of a body.
  * While this could be calculated with polygon_centroid(), that becomes too slow
@@ -67,6 +91,18 @@ list_t *body_get_shape(body_t *body);
  */
 vector_t body_get_centroid(body_t *body);
 
+/**
+ * Gets where to draw a body between its last two ticks.
+ * Bodies moved with body_set_centroid() (rather than body_tick()) are drawn
+ * at their new position straight away.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param alpha 0 for the position before the last tick, 1 for the current one
+ *   (see timestep_alpha())
+ * @return the interpolated center of mass
+ */
+vector_t body_get_interp_centroid(body_t *body, double alpha);
+
 /**
  * Gets the current velocity of a body.
  *
@@ -93,6 +129,18 @@ rgb_color_t body_get_color(body_t *body);
 
 void body_set_color(body_t *body, rgb_color_t color);
 
+/**
+ * Marks a body as drawn some other way (e.g. as an image), so
+ * sdl_render_scene() leaves it out. Bodies start out not hidden.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param hidden whether to leave the body's polygon undrawn
+ */
+void body_set_hidden(body_t *body, bool hidden);
+
+// Whether the body was hidden with body_set_hidden().
+bool body_is_hidden(body_t *body);
+
 /**
  * Translates a body to a new position.
  * The position is specified by the position of the body's center of mass.
@@ -132,7 +180,7 @@ void body_translate(body_t *body, vector_t diff);
  * @param body a pointer to a body returned from body_init()
  * @param force the force vector to apply
  */
-void body_add_force(body_t *body, vector_t *force);
+void body_add_force(body_t *body, vector_t force);
 
 /**
  * Applies an impulse to a body.
@@ -144,7 +192,7 @@ void body_add_force(body_t *body, vector_t *force);
  * @param body a pointer to a body returned from body_init()
  * @param impulse the impulse vector to apply
  */
-void body_add_impulse(body_t *body, vector_t *impulse);
+void body_add_impulse(body_t *body, vector_t impulse);
 
 /**
  * Updates the body after a given time interval has elapsed.
@@ -178,6 +226,23 @@ void body_remove(body_t *body);
  */
 bool body_is_removed(body_t *body);
 
+/**
+ * Records that a force creator acts on this body, so removing the body can
+ * find its forces without scanning the whole scene. The scene does this in
+ * scene_add_bodies_force_creator(); the body does not own the force.
+ *
+ * @param body the body the force acts on
+ * @param force the force_t registered with the scene
+ */
+void body_link_force(body_t *body, void *force);
+
+// Forgets a force recorded with body_link_force(). Order of links is not kept.
+void body_unlink_force(body_t *body, void *force);
+
+// The forces recorded with body_link_force(), or NULL if there never were any.
+// Must not be modified or freed.
+list_t *body_get_links(body_t *body);
+
 // /*
 //   Uses the bounding box method to check if two bodies need to check for collisions
 //   Returns true if the bodies' bounding boxes are inside each other
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include "list.h"
 #include "object.h"
+#include "vec_list.h"
 #include "vector.h"
 #include <assert.h>
 #include <stdio.h>
@@ -37,17 +38,19 @@ typedef struct {
  * @return whether the shapes are colliding, and if so, the collision axis.
  * The axis should be a unit vector pointing from shape1 towards shape2.
  */
-collision_info_t find_collision(list_t *shape1, list_t *shape2);
+collision_info_t find_collision(vec_list_t *shape1, vec_list_t *shape2);
 
 /**
  * Rendition of above method, but for objects. Uses object bounding box test.
+ * Temporaries come out of the given scratch arena (or the heap if NULL).
  *
+ * @param scratch a per-frame arena for temporaries, or NULL
  * @param shape1 the first shape
  * @param shape2 the second shape
  * @return whether the shapes are colliding, and if so, the collision axis.
  * The axis should be a unit vector pointing from shape1 towards shape2.
  */
-collision_info_t object_find_collision(list_t *shape1, list_t *shape2);
+collision_info_t object_find_collision(arena_t *scratch, vec_list_t *shape1, vec_list_t *shape2);
 
 /**
  * Tests if two objects are colliding via the bounding box method
@@ -63,6 +66,6 @@ bool object_test_bounding_box(object_t *one, object_t *two);
  * @param body_one the first body
  * @param body_two the second body
  */
-bool body_test_bounding_box(list_t *body_one, list_t *body_two);
+bool body_test_bounding_box(vec_list_t *body_one, vec_list_t *body_two);
 
 #endif // #ifndef __COLLISION_H__
@@ -0,0 +1,73 @@
+#ifndef __COUNTERS_H__
+#define __COUNTERS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Counts of work done on the hot paths, which unlike timings don't change
+ * from run to run, so a jump in one means the code changed, not the machine.
+ *
+ * Code bumps a counter with counter_add() (a running sum) or counter_peak()
+ * (the largest value seen). Whoever drives the frames calls counters_frame()
+ * once per frame, after which each counter can be read for the last frame,
+ * its worst frame, and in total (for peaks, the largest ever).
+ *
+ * The allocation counters only count when the program is linked with the
+ * allocator hook (library/alloc_hook.c and ALLOC_WRAP in the Makefile),
+ * as the headless programs are. Otherwise they stay 0.
+ */
+typedef enum counter_id {
+    // nodes taken off the open set in ai_star()
+    COUNTER_ASTAR_EXPANSIONS,
+    // largest open set in ai_star()
+    COUNTER_ASTAR_OPEN_PEAK,
+    // separating axis tests run (past the bounding box check)
+    COUNTER_SAT_TESTS,
+    // pairs whose bounding boxes don't overlap
+    COUNTER_BBOX_REJECTS,
+    // force creators run by scene_tick()
+    COUNTER_FORCES_RUN,
+    COUNTER_MALLOCS,
+    COUNTER_REALLOCS,
+    COUNTER_FREES,
+    NUM_COUNTERS
+} counter_id_t;
+
+// Adds to a summed counter.
+void counter_add(counter_id_t id, uint64_t amount);
+
+// Raises a peak counter to value if it is higher.
+void counter_peak(counter_id_t id, uint64_t value);
+
+// Ends the current frame, folding its counts into the totals.
+void counters_frame(void);
+
+// Zeroes every counter and the frame count.
+void counters_reset(void);
+
+// The counter's value over the last finished frame.
+uint64_t counter_frame(counter_id_t id);
+
+// The counter's highest value over any one finished frame.
+uint64_t counter_frame_max(counter_id_t id);
+
+// The counter's total over all finished frames (for peaks, the highest).
+uint64_t counter_total(counter_id_t id);
+
+// Frames finished since the start or the last counters_reset().
+size_t counters_frames(void);
+
+// The counter's name, e.g. "astar_expansions".
+const char *counter_name(counter_id_t id);
+
+/**
+ * Prints every counter's total, mean per frame, worst frame and last frame
+ * as a table.
+ *
+ * @param file where to print, e.g. stdout
+ */
+void counters_print(FILE *file);
+
+#endif // #ifndef __COUNTERS_H__
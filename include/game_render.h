@@ -0,0 +1,53 @@
+#ifndef __GAME_RENDER_H__
+#define __GAME_RENDER_H__
+
+#include "map.h"
+#include "snapshot.h"
+
+/**
+ * Draws game frames from snapshots: the background, coins, player, alien,
+ * HUD and bodies, or the zoomed out map of cells when the cells are only a
+ * few pixels across. The game (demo/game.c) and the rendering benchmark
+ * (demo/bench_render.c) both draw through it, so the benchmark measures
+ * what the game actually does.
+ *
+ * It keeps what it drew last, to redraw only what changed:
+ * ```
+ * game_render_t *render = game_render_init(map);
+ * while (running) {
+ *     game_render_frame(render, snapshot_read(buffer), alpha);
+ *     sdl_show();
+ * }
+ * game_render_free(render);
+ * ```
+ * sdl_init() (or sdl_init_backend()), message_init() and images_init()
+ * must come first.
+ */
+typedef struct game_render game_render_t;
+
+/**
+ * Sets up drawing for a map: registers its background with
+ * sdl_set_background() and colors its zoomed out cells.
+ *
+ * @param map the map the snapshots will come from; it must outlive the
+ *        game_render_t, though it may change on another thread
+ * @return a pointer to the newly allocated game_render_t
+ */
+game_render_t *game_render_init(map_t *map);
+
+// Frees what game_render_init() allocated.
+void game_render_free(game_render_t *render);
+
+/**
+ * Draws one frame from a snapshot into the renderer's target, centered on
+ * the player: the win or lose message once the game is over, otherwise the
+ * images, the HUD and the bodies. The caller shows it (see sdl_show()).
+ *
+ * @param render the game_render_t
+ * @param snapshot the state to draw
+ * @param alpha how far from the snapshot's previous step (0) to its latest
+ *        one (1) to draw moving bodies
+ */
+void game_render_frame(game_render_t *render, snapshot_t *snapshot, double alpha);
+
+#endif // #ifndef __GAME_RENDER_H__
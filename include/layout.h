@@ -0,0 +1,77 @@
+#ifndef __LAYOUT_H__
+#define __LAYOUT_H__
+
+#include <stdbool.h>
+
+/**
+ * The fixed walls of a map, read from a map file such as maps/town.map.
+ * Doors, coins and hiding spots are not part of it; they are placed from
+ * the map's seed (see map_init_seeded()).
+ *
+ * A map file is a line with the number of rows and columns, and optionally
+ * the side of a cell in scene units, then one line per row of the grid, top to
+ * bottom as it appears on screen, with one character per cell:
+ * ```
+ * 3 5 10
+ * #####
+ * #...#
+ * #####
+ * ```
+ * '#' is a wall and '.' is open floor. Rows are numbered from the bottom, as
+ * y grows upward in the scene, so the file's last line is row 0.
+ */
+typedef struct layout {
+    int rows;
+    int cols;
+    // 0 if the file doesn't give one
+    int cell_size;
+    // rows * cols cells, row by row from row 0, each a layout_cell_t
+    unsigned char *cells;
+} layout_t;
+
+// What a cell of a layout holds.
+typedef enum layout_cell { LAYOUT_FLOOR, LAYOUT_WALL } layout_cell_t;
+
+/**
+ * Reads a map file. The whole file is read at once and parsed in a single
+ * pass, so even very large maps load quickly.
+ *
+ * @param path the map file, e.g. "maps/town.map"
+ * @return the layout, or NULL (after printing why) if the file is missing or
+ *         malformed
+ */
+layout_t *layout_load(const char *path);
+
+/**
+ * Allocates a layout that is all floor, for building one in code.
+ *
+ * @param rows the number of rows
+ * @param cols the number of columns
+ * @return the layout, with no cell size given
+ */
+layout_t *layout_init(int rows, int cols);
+
+// Frees a layout returned by layout_load() or layout_init().
+void layout_free(layout_t *layout);
+
+/**
+ * Returns whether a cell of the layout is a wall.
+ *
+ * @param layout the layout
+ * @param r the cell's row
+ * @param c the cell's column
+ * @return whether the cell is a wall
+ */
+bool layout_is_wall(layout_t *layout, int r, int c);
+
+/**
+ * Makes a cell of the layout a wall or open floor.
+ *
+ * @param layout the layout
+ * @param r the cell's row
+ * @param c the cell's column
+ * @param wall whether the cell is a wall
+ */
+void layout_set_wall(layout_t *layout, int r, int c, bool wall);
+
+#endif // #ifndef __LAYOUT_H__
@@ -2,6 +2,8 @@
 #define __LIST_H__
 
 #include <stddef.h>
+#include <stdbool.h>
+#include "arena.h"
 
 
 /**
@@ -33,6 +35,29 @@ void *list_replace(list_t *list, size_t index, void *new_item);
  */
 list_t *list_init(size_t initial_size, free_func_t freer);
 
+/**
+ * Same as list_init(), but the list and its array are carved out of an arena.
+ * list_free() on such a list only calls freer on the elements; the memory
+ * itself goes away with the arena. Passing a NULL arena is list_init().
+ *
+ * @param arena the arena to allocate from, or NULL for the heap
+ * @param initial_size the number of elements to allocate space for
+ * @param freer if non-NULL, a function to call on elements in list_free()
+ * @return a pointer to the newly allocated list
+ */
+list_t *list_init_in(arena_t *arena, size_t initial_size, free_func_t freer);
+
+/**
+ * Same as list_init(), but the list is a ring buffer, so list_pop_front()
+ * (and list_remove() at index 0) is O(1). Everything else works as usual.
+ * Use for queues such as a path being walked from the front.
+ *
+ * @param initial_size the number of elements to allocate space for
+ * @param freer if non-NULL, a function to call on elements in list_free()
+ * @return a pointer to the newly allocated list
+ */
+list_t *list_init_deque(size_t initial_size, free_func_t freer);
+
 /**
  * Releases the memory allocated for a list.
  *
@@ -71,7 +96,8 @@ void *list_get(list_t *list, size_t index);
 
 /**
  * Collapses all elements to the right of ind one to the left, setting the
- * last element equal to null
+ * last element equal to null. Expects a list that does not wrap around
+ * (list_remove() takes care of that).
  *
  * @param list a pointer to a list returned from list_init()
  * @param index being removed
@@ -89,6 +115,37 @@ void collapse(list_t *list, size_t ind);
  */
 void *list_remove(list_t *list, size_t index);
 
+/**
+ * Removes the first element of a list and returns it, without calling the
+ * freer. O(1) for lists from list_init_deque(); otherwise same as
+ * list_remove(list, 0).
+ * Asserts that the list is not empty.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @return the first element in the list
+ */
+void *list_pop_front(list_t *list);
+
+/**
+ * Removes the element at a given index in O(1) by moving the last element
+ * into its place. Only for lists whose order does not matter.
+ * Asserts that the index is valid, given the list's current size.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param index the index of the element to remove
+ * @return the removed element
+ */
+void *list_swap_remove(list_t *list, size_t index);
+
+/**
+ * Drops every element from index size onwards without calling the freer.
+ * Asserts that size is no larger than the current size.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param size the new size of the list
+ */
+void list_truncate(list_t *list, size_t size);
+
 /**
  * Doubles the current capacity of list->data to make space for new
  * elements. Copies over elements that were already added.
@@ -97,6 +154,15 @@ void *list_remove(list_t *list, size_t index);
  */
 void resize(list_t *list);
 
+/**
+ * Grows the list's array to hold at least capacity elements, so that many
+ * list_add() calls in a row do not resize more than once. Never shrinks.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param capacity the number of elements to make space for
+ */
+void list_reserve(list_t *list, size_t capacity);
+
 /**
  * Appends an element to the end of a list.
  * If the list is filled to capacity, resizes the list to fit more elements
@@ -109,7 +175,8 @@ void resize(list_t *list);
 void list_add(list_t *list, void *value);
 
 /**
-* Clears all elements of given list. List capacity remains the same.
+* Clears all elements of given list, calling the freer on each in one pass.
+* List capacity remains the same.
 *
 * @param list to be cleared
 */
@@ -6,7 +6,9 @@
 #include "list.h"
 #include "object.h"
 #include "collision.h"
-#include "sdl_wrapper.h"
+#include "layout.h"
+#include "renderer.h"
+#include "rng.h"
 #include <math.h>
 #include <stdbool.h>
 #include <assert.h>
@@ -33,8 +35,50 @@
      list_t *hiding_spots;
      list_t *nodes;
      list_t *struct_nodes;
+     // the grid: its size in cells and the side of a cell. everything that
+     // turns cells into positions or walks the grid goes by these
+     int rows;
+     int cols;
+     double cell_size;
+     // what A* keeps per cell (see ai_star()); made by the first search
+     struct search *search;
+     // owns every wall, door, coin, hiding spot and node; freed in map_free
+     arena_t *arena;
+     // per-frame temporaries (pathfinding, visibility, collisions). reset at
+     // the end of map_tick, so nothing in it may be kept across frames
+     arena_t *scratch;
+     // all map generation and ai randomness comes from here, so a given seed
+     // always plays out the same way
+     rng_t rng;
+     uint64_t seed;
+     // per grid cell, row by row: its cell_kind_t and how many coins sit on
+     // it, so drawing can look cells up instead of scanning the lists
+     unsigned char *cell_kinds;
+     unsigned char *coin_counts;
+     // whether the player is in a hiding spot, and which one
+     bool hiding;
+     object_t *curr_spot;
  } map_t;
 
+// What fills a grid cell.
+ typedef enum cell_kind {
+   CELL_NODE,
+   CELL_WALL,
+   CELL_DOOR,
+   CELL_LOCKER,
+   CELL_DUMPSTER,
+   // a hiding spot of some other type
+   CELL_OTHER
+ } cell_kind_t;
+
+// A block of grid cells, bounds included. Empty when a min is past its max.
+ typedef struct cell_range {
+   int row_min;
+   int row_max;
+   int col_min;
+   int col_max;
+ } cell_range_t;
+
 // A node that builts off of object_t, for pathfinding purposes.
  typedef struct node {
    object_t *node;
@@ -58,6 +102,16 @@
  */
  list_t *arr_init(int height, int width, free_func_t freer);
 
+ /**
+  * Same as arr_init(), but the array lives in an arena and owns nothing.
+  *
+  * @param arena the arena to allocate from
+  * @param height the height of the array
+  * @param width the width of the array
+  * @return the initialized array
+  */
+ list_t *arr_init_in(arena_t *arena, int height, int width);
+
  /**
   * Returns a vector_t corresponding to the original array size
   *
@@ -107,35 +161,114 @@
   */
 vector_t map_ind_from_pos(map_t *map, vector_t position);
 
+ /**
+  * Returns the grid cells that overlap a rectangle, clipped to the map.
+  *
+  * @param map the map
+  * @param min the rectangle's corner with the smallest coordinates
+  * @param max the rectangle's corner with the largest coordinates
+  * @return the cells, possibly none
+  */
+ cell_range_t map_cell_range(map_t *map, vector_t min, vector_t max);
+
+ /**
+  * Returns what is in a grid cell.
+  *
+  * @param map the map
+  * @param r the row of the cell
+  * @param c the column of the cell
+  * @return the cell's kind
+  */
+ cell_kind_t map_cell_kind(map_t *map, int r, int c);
+
+ /**
+  * Returns how many uncollected coins are in a grid cell (usually 0 or 1).
+  *
+  * @param map the map
+  * @param r the row of the cell
+  * @param c the column of the cell
+  * @return the number of coins
+  */
+ int map_coins_at(map_t *map, int r, int c);
+
+ // The number of rows of grid cells.
+ int map_rows(map_t *map);
+
+ // The number of columns of grid cells.
+ int map_cols(map_t *map);
+
+ // The side of a grid cell. Cell (r, c) spans [c, c + 1] times the size
+ // across and [r, r + 1] times the size up.
+ double map_cell_size(map_t *map);
+
+ // How wide and tall the whole map is, in the same units as positions.
+ vector_t map_extent(map_t *map);
+
   /**
-   * Initializes a node with a specified object_t and priority
+   * Initializes a node with a specified object_t and priority. The node
+   * lives in an arena and is never freed alone.
    *
+   * @param arena the arena to allocate from
    * @param node the object
    * @param priority the priority
    * @return the initialized node
    */
- node_t *node_init(object_t *node, double priority);
+ node_t *node_init_in(arena_t *arena, object_t *node, double priority);
 
  /**
-  * Initializes the map with its instance variables
+  * Initializes the map with its instance variables, from a seed that changes
+  * from run to run (see map_init_seeded()). The seed used is kept in map->seed.
   *
   * @return the initialized map
   */
  map_t *map_init();
 
  /**
-  * Initializes the player
+  * Initializes the map from a given seed. The same seed gives the same doors,
+  * coins and hiding spots, and (given the same input) the same alien paths.
+  *
+  * @param seed the seed for map->rng
+  * @return the initialized map
+  */
+ map_t *map_init_seeded(uint64_t seed);
+
+ /**
+  * Initializes the map from a map file (see include/layout.h) and a seed.
+  * map_init_seeded() loads the town, maps/town.map.
   *
+  * @param path the map file
+  * @param seed the seed for map->rng
+  * @return the initialized map, or NULL (after printing why) if the file
+  *         could not be loaded or its map is too small to play on
+  */
+ map_t *map_init_from(const char *path, uint64_t seed);
+
+ /**
+  * Initializes the map from a layout and a seed. The map is as big as the
+  * layout, with cells of its cell size (or the town's, if it gives none).
+  *
+  * @param layout the walls; only read, so the caller still frees it
+  * @param seed the seed for map->rng
+  * @return the initialized map, or NULL (after printing why) if the layout
+  *         has too few open cells for the hiding spots and coins
+  */
+ map_t *map_init_layout(layout_t *layout, uint64_t seed);
+
+ /**
+  * Initializes the player, sized to the map's cells
+  *
+  * @param map the map the player will be in
   * @return the player
   */
- body_t *make_player();
+ body_t *make_player(map_t *map);
 
  /**
-  * Initializes the alien
+  * Initializes the alien, sized to the map's cells
   *
+  * @param map the map the alien will be in
   * @return the alien
   */
- body_t *make_alien();
+ body_t *make_alien(map_t *map);
 
  /**
   * Frees the map and its instance variables
@@ -216,11 +349,12 @@ vector_t map_ind_from_pos(map_t *map, vector_t position);
   * Tests if two objects are colliding using collision.c framework and
   * precalculated min and maxes for bounding box.
   *
+  * @param map the map, whose scratch arena holds the temporaries
   * @param o1 the first object to be tested
   * @param o2 the second object to be tested
   * @return a boolean true if the objects are colliding, false otherwise
   */
- bool object_collision(object_t *o1, object_t *o2);
+ bool object_collision(map_t *map, object_t *o1, object_t *o2);
 
  /**
   * Disallows a player from being where they shouldn't be
@@ -234,13 +368,15 @@ vector_t map_ind_from_pos(map_t *map, vector_t position);
  // some specialized methods for adding specific types
 
  // makes box at pos 0, no info. you can set centroid and info yourself. has generic 10*10 size
- body_t *make_box(rgb_color_t color);
+ // allocated from the map's arena, so it must stay in the map until map_free
+ body_t *make_box(map_t *map, rgb_color_t color);
 
  object_t *map_make_node(map_t *map);
 
- // should fill all spots in 2d array with a node. only to be used at start.
- // nodes are lowest priority -- will be replaced by anything else being placed at spot
- void map_add_nodes(map_t *map);
+ // fills all spots in 2d array with a wall or a node, as the layout says. only
+ // to be used at start. nodes are lowest priority -- will be replaced by
+ // anything else being placed at spot
+ void map_add_cells(map_t *map, layout_t *layout);
 
  // get rid of node at particular spot. only helper func.
  // assumes new item is already in scene. makes into object that belongs to backing array
@@ -249,12 +385,6 @@ vector_t map_ind_from_pos(map_t *map, vector_t position);
 
  object_t *map_make_wall(map_t *map);
 
- // create the wall when called in map_add_walls
- void create_walls(map_t *map, size_t r, size_t c);
-
- // need to add outline first. then some sort of design--way to rand generate or just make array of spots filled?
- void map_add_walls(map_t *map);
-
  // replace wall..probably only used to place doors.
   void map_replace_wall(map_t *map, int r, int c, object_t *new_ob);
 
@@ -18,12 +18,17 @@ typedef struct object{
   bool is_open;
   bool is_purchased;
   char *type;
-  double *coll_extrema;
+  double coll_extrema[4];
+  arena_t *arena;
 } object_t;
 
 // Initializes off of body.
 object_t *object_init(body_t *body);
 
+// Same as object_init(), but the object lives in an arena and object_free()
+// leaves it alone.
+object_t *object_init_in(arena_t *arena, body_t *body);
+
 // Recalculates min, max in order to keep updated for the moving objects.
 void object_calc_min_max(object_t *o);
 
@@ -33,4 +38,7 @@ double *object_get_min_max(object_t *o);
 // Frees things associated with object that aren't freed elsewhere.
 void object_free(void *o);
 
+// Live and peak counts of heap objects (object_init() allocates from a pool).
+pool_stats_t object_pool_stats(void);
+
 #endif // #ifndef __SCENE_H__
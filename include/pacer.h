@@ -0,0 +1,70 @@
+#ifndef __PACER_H__
+#define __PACER_H__
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * Paces a loop to a target rate by sleeping until each iteration is due,
+ * rather than spinning, so an idle game doesn't hold a whole core.
+ * Times come from the same monotonic wall clock as timestep_now().
+ *
+ * Typical loop:
+ * ```
+ * pacer_t *pacer = pacer_init(60);
+ * while (running) {
+ *     draw_frame();
+ *     pacer_wait(pacer);
+ * }
+ * pacer_print(pacer, "render", stdout);
+ * ```
+ * An iteration that ends after its deadline counts as missed, and the
+ * next deadline is counted from then: late frames are not made up for by
+ * running the following ones early.
+ */
+typedef struct pacer pacer_t;
+
+/**
+ * Allocates a new pacer.
+ *
+ * @param rate_hz iterations per second, or 0 to never sleep (only count)
+ * @return a pointer to the newly allocated pacer
+ */
+pacer_t *pacer_init(double rate_hz);
+
+// Releases the pacer.
+void pacer_free(pacer_t *pacer);
+
+/**
+ * Ends an iteration: sleeps until the next one is due. Most of the wait is
+ * a real sleep; only the last fraction of a millisecond, sized by how far
+ * past their end sleeps have been running, is spent checking the clock.
+ * The first call only starts the clock.
+ *
+ * @param pacer a pointer to a pacer returned from pacer_init()
+ */
+void pacer_wait(pacer_t *pacer);
+
+// Iterations ended so far.
+size_t pacer_frames(pacer_t *pacer);
+
+// Iterations that ended after their deadline.
+size_t pacer_missed(pacer_t *pacer);
+
+// Total seconds spent waiting in pacer_wait().
+double pacer_slept(pacer_t *pacer);
+
+// The latest any iteration ended past its deadline, in seconds.
+double pacer_worst_late(pacer_t *pacer);
+
+/**
+ * Prints one line of the pacer's counts, e.g.
+ * "render: 3600 frames at 60 Hz, 2 missed (worst 4.1 ms late), 71% asleep".
+ *
+ * @param pacer the pacer
+ * @param name what is being paced
+ * @param file where to print, e.g. stdout
+ */
+void pacer_print(pacer_t *pacer, const char *name, FILE *file);
+
+#endif // #ifndef __PACER_H__
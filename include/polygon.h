@@ -2,6 +2,7 @@
 #define __POLYGON_H__
 
 #include "list.h"
+#include "vec_list.h"
 #include "vector.h"
 
 typedef struct polygon polygon_t;
@@ -13,6 +14,16 @@ typedef struct polygon polygon_t;
  **/
 polygon_t *polygon_init(size_t num_pts);
 
+/**
+ * Allocates a polygon from an arena around an existing list of points,
+ * which the polygon takes ownership of.
+ * polygon_free() then does nothing; the arena owns all of it.
+ *
+ * @param arena the arena to allocate from
+ * @param points the vertices, made with vec_list_init_in() on the same arena
+ **/
+polygon_t *polygon_init_in(arena_t *arena, vec_list_t *points);
+
 /**
  * Free pointers of polygons. Is of type free_func_t and can be passed in as arg.
  */
@@ -25,17 +36,18 @@ polygon_t *polygon_init(size_t num_pts);
 void polygon_free(void *polygon);
 
 /**
- * Set points of polygon given vec_list_t
- * @param vec_list_t of points for each polygon
+ * Set points of polygon given a list of vector_t pointers.
+ * The values are copied in and the list is freed.
+ * @param list_t of points for each polygon
  * @param polygon_t * polygon
  */
 void polygon_set_points(polygon_t *polygon, list_t *points);
 
 /**
- * Returns list of the points in polygon
+ * Returns list of the points in polygon. Not a copy.
  * @param polygon_t *polygon
  */
-list_t *polygon_get_points(polygon_t *polygon);
+vec_list_t *polygon_get_points(polygon_t *polygon);
 
 /**
  * Computes the area of a polygon.
@@ -0,0 +1,66 @@
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A fixed-size object pool. Memory is requested from malloc a slab (many
+ * elements) at a time, and released elements go onto an intrusive free list
+ * to be handed out again, so steady-state create/destroy does not touch malloc.
+ * Slabs are only given back in pool_free().
+ *
+ * Every slot remembers whether its element is live, so releasing an element
+ * twice, or a pointer that never came from a pool, is caught.
+ */
+typedef struct pool pool_t;
+
+/**
+ * Counts for a pool. peak is the highest live count ever reached.
+ */
+typedef struct {
+    size_t live;
+    size_t peak;
+    size_t capacity;
+    size_t slabs;
+} pool_stats_t;
+
+/**
+ * Allocates an empty pool. No slab is allocated until the first pool_alloc().
+ * Asserts that the required memory was allocated.
+ *
+ * @param elem_size the size of one element, e.g. sizeof(body_t)
+ * @param slab_count how many elements to allocate from malloc at once
+ * @return a pointer to the newly allocated pool
+ */
+pool_t *pool_init(size_t elem_size, size_t slab_count);
+
+/**
+ * Releases every slab, and the pool itself.
+ * Any elements still live become invalid.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ */
+void pool_free(pool_t *pool);
+
+/**
+ * Takes an element from the free list, adding a slab if it is empty.
+ *
+ * @param pool a pointer to a pool returned from pool_init()
+ * @return a pointer to elem_size bytes of uninitialized memory
+ */
+void *pool_alloc(pool_t *pool);
+
+/**
+ * Puts an element back on the free list.
+ * Asserts that the element is live.
+ *
+ * @param pool the pool the element was allocated from
+ * @param elem a pointer returned from pool_alloc()
+ */
+void pool_release(pool_t *pool, void *elem);
+
+// Live, peak and capacity counts for a pool.
+pool_stats_t pool_stats(pool_t *pool);
+
+#endif // #ifndef __POOL_H__
@@ -0,0 +1,101 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A frame profiler. Code is split into named zones, each timed on the
+ * monotonic clock from where it is declared to the end of its block:
+ * ```
+ * void bounce(map_t *map){
+ *   PROFILE_ZONE("bounce");
+ *   ...
+ * }
+ * ```
+ * and PROFILE_FRAME() marks the end of each frame. Per-zone totals for the
+ * last PROF_FRAMES frames are kept in a ring buffer for the stats overlay
+ * (prof_overlay_text()), and the last PROF_EVENTS zone runs are kept for a
+ * Chrome trace dump (PROFILE_DUMP(path), open it in chrome://tracing or
+ * Perfetto).
+ *
+ * Zones may run on up to PROF_MAX_THREADS threads. Each thread is numbered
+ * from 1 in the order it first opens a zone, gets its own track in the
+ * trace, and has its own totals; a frame holds whatever each thread ran
+ * between two PROFILE_FRAME() calls, which may come from any one thread.
+ *
+ * Build with -DPROFILE (make PROFILE=1) to turn it on. Without it every
+ * macro here expands to nothing and none of the code below exists.
+ */
+
+#define PROF_FRAMES 240
+#define PROF_EVENTS 65536
+#define PROF_MAX_ZONES 32
+#define PROF_MAX_THREADS 4
+
+#ifdef PROFILE
+
+#include <stdatomic.h>
+
+// An open zone. Only made by PROFILE_ZONE().
+typedef struct prof_zone {
+    int id;
+    uint64_t start;
+} prof_zone_t;
+
+/**
+ * Opens a zone. Use PROFILE_ZONE() instead.
+ *
+ * @param id where the zone's id is cached, -1 until first use; shared by
+ *        every thread that runs the zone
+ * @param name the zone's name; must be a string that outlives the profiler
+ * @return the open zone
+ */
+prof_zone_t prof_zone_begin(atomic_int *id, const char *name);
+
+// Closes a zone and records it. Called by the cleanup attribute.
+void prof_zone_end(prof_zone_t *zone);
+
+// Ends the current frame, pushing every thread's per-zone totals into the
+// ring.
+void prof_frame(void);
+
+/**
+ * Writes the recorded zone runs as Chrome trace-event JSON.
+ *
+ * @param path the file to write
+ * @return whether the file was written
+ */
+bool prof_write_trace(const char *path);
+
+/**
+ * Formats the average and worst time per frame of whole frames, then of
+ * each zone on each thread that ran it ("bounce t2"), over the frames in
+ * the ring: one line each.
+ *
+ * @param buf where to write the text
+ * @param size the size of buf; the text is cut short to fit
+ * @return the number of lines written
+ */
+size_t prof_overlay_text(char *buf, size_t size);
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+#define PROFILE_ZONE(name)                                                    \
+    static atomic_int PROF_CAT(prof_id_, __LINE__) = -1;                             \
+    prof_zone_t PROF_CAT(prof_zone_, __LINE__)                                \
+        __attribute__((cleanup(prof_zone_end), unused)) =                     \
+            prof_zone_begin(&PROF_CAT(prof_id_, __LINE__), name)
+#define PROFILE_FRAME() prof_frame()
+#define PROFILE_DUMP(path) prof_write_trace(path)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_DUMP(path) ((void)0)
+
+#endif // #ifdef PROFILE
+
+#endif // #ifndef __PROFILER_H__
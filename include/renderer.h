@@ -0,0 +1,50 @@
+#ifndef __RENDERER_H__
+#define __RENDERER_H__
+
+#include "vector.h"
+
+/**
+ * The display hooks the simulation calls into, so the core library does not
+ * depend on SDL. Any hook may be NULL. Until a renderer is set (sdl_init()
+ * sets the SDL one), the null renderer is used and every hook is a no-op,
+ * which is what headless builds run with.
+ */
+typedef struct renderer {
+    // the player's purse changed
+    void (*money_changed)(int money);
+    // the number of bullets left changed
+    void (*bullets_changed)(int bullets);
+    // the player's stamina changed, as a percentage
+    void (*stamina_changed)(int stamina);
+    // part of the map that never moves (a door, a hiding spot) changed,
+    // within the scene rectangle from min to max
+    void (*background_changed)(vector_t min, vector_t max);
+} renderer_t;
+
+// A renderer that ignores everything.
+extern const renderer_t NULL_RENDERER;
+
+/**
+ * Sets the renderer the HUD functions below forward to.
+ * The renderer is not copied, so it must outlive its use.
+ *
+ * @param renderer the renderer to use, or NULL for the null renderer
+ */
+void renderer_set(const renderer_t *renderer);
+
+// The renderer currently in use (never NULL).
+const renderer_t *renderer_get(void);
+
+// Tells the renderer the purse is now money.
+void hud_update_money(int money);
+
+// Tells the renderer the number of bullets left.
+void hud_update_bullets(int bullets);
+
+// Tells the renderer the player's stamina percentage.
+void hud_update_stamina(int stamina);
+
+// Tells the renderer the static map changed between min and max.
+void background_update(vector_t min, vector_t max);
+
+#endif // #ifndef __RENDERER_H__
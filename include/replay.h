@@ -0,0 +1,94 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include "input.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Recordings of a session's input, for replaying it step for step.
+ *
+ * A recording is a small binary file, little-endian throughout:
+ *   header (16 bytes): "ALRP", u16 version, u16 step rate in Hz, u64 seed
+ *   events (6 bytes each): u32 tick, u8 key, u8 type (0 pressed, 1 released)
+ * in tick order, ending with an event whose key is 0 at the tick the session
+ * ended on. An event at tick t was applied after t steps had run and before
+ * step t + 1, which is where a replay applies it again.
+ */
+#define REPLAY_VERSION 1
+
+typedef struct recorder recorder_t;
+typedef struct replay replay_t;
+
+typedef struct replay_event {
+    uint32_t tick;
+    char key;
+    key_event_type_t type;
+} replay_event_t;
+
+/**
+ * Creates a recording file and writes its header.
+ *
+ * @param path the file to write; any existing file is replaced
+ * @param seed the seed the session's map was made from
+ * @param rate_hz fixed steps per second the session runs at
+ * @return a new recorder, or NULL if the file could not be opened
+ */
+recorder_t *recorder_open(const char *path, uint64_t seed, int rate_hz);
+
+/**
+ * Appends a key event. Ticks must not go backwards.
+ *
+ * @param recorder a recorder returned from recorder_open()
+ * @param tick steps run before the event
+ * @param key the key, as passed to a key_handler_t; must not be 0
+ * @param type KEY_PRESSED or KEY_RELEASED
+ */
+void recorder_key(recorder_t *recorder, uint32_t tick, char key,
+                  key_event_type_t type);
+
+/**
+ * Writes the end marker, closes the file and frees the recorder.
+ *
+ * @param recorder a recorder returned from recorder_open()
+ * @param tick steps run when the session ended
+ */
+void recorder_close(recorder_t *recorder, uint32_t tick);
+
+/**
+ * Reads a whole recording into memory.
+ * Prints why and returns NULL if the file is missing, not a recording,
+ * a different version, or cut short.
+ *
+ * @param path the file to read
+ * @return the recording, or NULL
+ */
+replay_t *replay_open(const char *path);
+
+// Frees a recording.
+void replay_free(replay_t *replay);
+
+// The seed the recorded session was made from.
+uint64_t replay_seed(replay_t *replay);
+
+// Fixed steps per second the recorded session ran at.
+int replay_rate(replay_t *replay);
+
+// Steps the recorded session ran for.
+uint32_t replay_ticks(replay_t *replay);
+
+// Number of key events, not counting the end marker.
+size_t replay_events(replay_t *replay);
+
+/**
+ * Gets the next event due at a tick, if any. Call it until it returns 0
+ * before running each step, with ticks counting up from 0.
+ *
+ * @param replay a recording returned from replay_open()
+ * @param tick steps run so far
+ * @param event set to the event when one is returned
+ * @return 1 if an event was returned, 0 if none are left for this tick
+ */
+int replay_next(replay_t *replay, uint32_t tick, replay_event_t *event);
+
+#endif // #ifndef __REPLAY_H__
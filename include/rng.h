@@ -0,0 +1,42 @@
+#ifndef __RNG_H__
+#define __RNG_H__
+
+#include <stdint.h>
+
+/**
+ * A small, fast pseudo-random number generator (xoshiro256**).
+ * All state lives in the struct, so two generators seeded the same way give
+ * the same sequence on every machine, independent of rand() and of each other.
+ * Meant to be embedded by value, e.g. one per map.
+ */
+typedef struct rng {
+    uint64_t s[4];
+} rng_t;
+
+/**
+ * Seeds a generator. Any seed (including 0) is fine.
+ *
+ * @param rng the generator to seed
+ * @param seed the seed; the same seed always gives the same sequence
+ */
+void rng_seed(rng_t *rng, uint64_t seed);
+
+// Next 64 random bits.
+uint64_t rng_next(rng_t *rng);
+
+/**
+ * A uniformly distributed integer in [0, bound), without modulo bias.
+ * Asserts that bound is positive.
+ *
+ * @param rng a seeded generator
+ * @param bound one past the largest value to return
+ */
+uint32_t rng_below(rng_t *rng, uint32_t bound);
+
+// A uniformly distributed double in [0, 1).
+double rng_double(rng_t *rng);
+
+// A seed that differs from run to run, for when reproducibility is not wanted.
+uint64_t rng_seed_from_time(void);
+
+#endif // #ifndef __RNG_H__
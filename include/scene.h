@@ -30,6 +30,7 @@ typedef struct force {
     void *aux;
     free_func_t aux_free;
     list_t *bodies;
+    bool dead;
 } force_t;
 
 /**
@@ -42,6 +43,11 @@ force_t *force_init(force_creator_t func, void *aux, list_t *bodies, free_func_t
 */
 void force_free(void * force);
 
+/**
+* Live and peak counts of force_t structs, which force_init() takes from a pool.
+*/
+pool_stats_t force_pool_stats(void);
+
 /**
  * Allocates memory for an empty scene.
  * Makes a reasonable guess of the number of bodies to allocate space for.
@@ -91,7 +97,8 @@ void scene_add_body(scene_t *scene, body_t *body);
 /**
  * @deprecated Use body_remove() instead
  *
- * Removes and frees the body at a given index from a scene.
+ * Removes and frees the body at a given index from a scene, along with any
+ * force creators acting on it. Other bodies may change index.
  * Asserts that the index is valid.
  *
  * @param scene a pointer to a scene returned from scene_init()
@@ -145,10 +152,10 @@ void scene_add_bodies_force_creator(
  */
 void scene_tick(scene_t *scene, double dt);
 
-// returns bool of whether body rem is associated with force
-bool force_is_removed(force_t *force, body_t *rem);
-
-// updates scene by removing any flagged bodies and their ass. forces
+// updates scene by removing any flagged bodies and their ass. forces.
+// forces of removed bodies are found through the bodies' links, marked dead,
+// then dropped in a single pass that keeps the rest in order. removed bodies
+// are dropped the same way, so bodies keep their order too.
 void update(scene_t *scene);
 
 #endif // #ifndef __SCENE_H__
@@ -3,8 +3,10 @@
 
 #include <stdbool.h>
 #include "color.h"
+#include "input.h"
 #include "list.h"
 // #include "map.h"
+#include "renderer.h"
 #include "scene.h"
 #include "vector.h"
 #include <SDL2/SDL.h>
@@ -18,45 +20,53 @@
 #include <SDL2/SDL_image.h>
 // https://www.libsdl.org/projects/SDL_ttf/
 
-// Values passed to a key handler when the given arrow key is pressed
-#define LEFT_ARROW 1
-#define UP_ARROW 2
-#define RIGHT_ARROW 3
-#define DOWN_ARROW 4
-
-void sdl_update_zoom(double zoom_n);
-
-/**
- * The possible types of key events.
- * Enum types in C are much more primitive than in Java; this is equivalent to:
- * typedef unsigned int KeyEventType;
- * #define KEY_PRESSED 0
- * #define KEY_RELEASED 1
- */
-typedef enum { KEY_PRESSED, KEY_RELEASED } key_event_type_t;
+// Key codes and key_handler_t live in input.h, which does not need SDL.
 
 /**
- * A keypress handler.
- * When a key is pressed or released, the handler is passed its char value.
- * Most keys are passed as their char value, e.g. 'a', '1', or '\r'.
- * Arrow keys have the special values listed above.
+ * Sets how far the view is zoomed in: the window shows the scene from
+ * sdl_init() scaled by zoom about the center (e.g. 0.1 shows a tenth of it).
  *
- * @param key a character indicating which key was pressed
- * @param type the type of key event (KEY_PRESSED or KEY_RELEASED)
- * @param held_time if a press event, the time the key has been held in seconds
+ * @param zoom_n the zoom, where 1 shows the whole scene
  */
-typedef void (*key_handler_t)(scene_t *scene, char key, key_event_type_t type,
-                              double held_time, void *aux);
+void sdl_update_zoom(double zoom_n);
 
 /**
  * Initializes the SDL window and renderer.
  * Must be called once before any of the other SDL functions.
+ * Also makes the SDL HUD the current renderer_t (see renderer.h).
  *
  * @param min the x and y coordinates of the bottom left of the scene
  * @param max the x and y coordinates of the top right of the scene
  */
 void sdl_init(vector_t min, vector_t max);
 
+// Where sdl_init_backend() has everything drawn.
+typedef enum render_backend {
+    // a window on the display, with whichever renderer SDL picks
+    BACKEND_WINDOW,
+    // SDL's software renderer, into a window-sized framebuffer in memory;
+    // needs no display, so it runs on machines without one
+    BACKEND_OFFSCREEN
+} render_backend_t;
+
+/**
+ * Same as sdl_init(), but drawing to the given backend.
+ *
+ * @param min the x and y coordinates of the bottom left of the scene
+ * @param max the x and y coordinates of the top right of the scene
+ * @param backend where to draw
+ */
+void sdl_init_backend(vector_t min, vector_t max, render_backend_t backend);
+
+/**
+ * A 64-bit FNV-1a hash of the offscreen framebuffer's pixels, i.e. of the
+ * last frame drawn. Equal frames hash equal, so a rendering change can be
+ * checked by comparing one number. Only for BACKEND_OFFSCREEN.
+ *
+ * @return the hash
+ */
+uint64_t sdl_frame_checksum(void);
+
 /**
  * Processes all SDL events and returns whether the window has been closed.
  * This function must be called in order to handle keypresses.
@@ -72,12 +82,26 @@ void sdl_clear(void);
 
 /**
  * Draws a polygon from the given list of vertices and a color.
+ * The polygon must be convex. It is queued, with every other polygon drawn
+ * until the frame is shown, and all of them are drawn in one call.
  *
  * @param points the list of vertices of the polygon
  * @param color the color used to fill in the polygon
  */
 void sdl_draw_polygon(list_t *points, rgb_color_t color);
 
+/**
+ * Same as sdl_draw_polygon(), but from an array of vertices moved by an
+ * offset, e.g. a body's points copied into a snapshot.
+ *
+ * @param points the vertices of the polygon
+ * @param n the number of vertices, at least 3
+ * @param offset added to every vertex
+ * @param color the color used to fill in the polygon
+ */
+void sdl_draw_points(const vector_t *points, size_t n, vector_t offset,
+                     rgb_color_t color);
+
 /**
  * Displays the rendered frame on the SDL window.
  * Must be called after drawing the polygons in order to show them.
@@ -85,7 +109,8 @@ void sdl_draw_polygon(list_t *points, rgb_color_t color);
 void sdl_show(void);
 
 /**
- * Draws all bodies in a scene.
+ * Draws all bodies in a scene, at their current positions (game frames are
+ * drawn between steps by game_render_frame() instead).
  * This internally calls sdl_clear(), sdl_draw_polygon(), and sdl_show(),
  * so those functions should not be called directly.
  *
@@ -124,17 +149,44 @@ void sdl_on_key(key_handler_t handler);
 void sdl_update_center(vector_t center);
 
 /**
- * Gets the amount of time that has passed since the last time
+ * Gets the part of the scene the window currently shows, padded by the
+ * size of the largest image so anything partly on screen is included.
+ *
+ * @param min set to the view's corner with the smallest coordinates
+ * @param max set to the view's corner with the largest coordinates
+ */
+void sdl_get_view(vector_t *min, vector_t *max);
+
+/**
+ * Maps scene coordinates to window pixel coordinates, many at a time,
+ * with the camera set by sdl_update_center() and sdl_update_zoom().
+ * The results are not rounded to whole pixels.
+ *
+ * @param scene the points to map
+ * @param pixels where to put the n mapped points
+ * @param n the number of points
+ */
+void sdl_scene_to_window(const vector_t *scene, SDL_FPoint *pixels, size_t n);
+
+/**
+ * Gets the amount of wall time that has passed since the last time
  * this function was called, in seconds.
  *
  * @return the number of seconds that have elapsed
  */
 double time_since_last_tick(void);
 
-// create rectangle for text rendering
-void make_rect(int x, int y, int w, int h);
+/**
+ * Turns waiting for the display's refresh in sdl_show() on or off.
+ * Call after sdl_init().
+ *
+ * @param vsync whether to wait
+ * @return whether the renderer could do it
+ */
+bool sdl_set_vsync(bool vsync);
 
-// initialize TTF and fonts
+// load each font's glyph atlas, from the asset pack if it has it or else
+// by rasterizing the font with TTF (call after sdl_init())
 void message_init();
 
 void update_bullets(int bullets);
@@ -148,18 +200,40 @@ void update_money(int money);
 // updates stamina when the player's stamina changes
 void update_stamina(int stamina);
 
-// updates the old text when money or stamina changes
+// lays the HUD line out again from the current values
 void replace_text();
 
-// adds texture to renderer to display text
+// draws the HUD line with its top left corner at (x, y), laying it out
+// again only if a value on it changed since the last call
 void render_text(int x, int y);
 
-// frees or closes surfaces, textures, fonts, and TTF
+// draws multi-line debug text (e.g. profiler stats) in a small font, with
+// its top left corner at (x, y) in pixels
+void render_overlay(const char *text, int x, int y);
+
+// frees the glyph atlases, and closes TTF if it was needed
 void message_free();
 
-// create image surfaces and textures
+// loads every image into one atlas texture, from the asset pack if it has
+// them or else by decoding images/
 void images_init();
 
+/**
+ * Decodes every sprite and rasterizes every font's glyphs as the game uses
+ * them, and writes the results to an asset pack (see asset_pack.h), which
+ * images_init() and message_init() then load instead. Needs no window.
+ *
+ * @param path the pack to write, e.g. "assets.pack"
+ * @return whether it was written
+ */
+bool sdl_write_asset_pack(const char *path);
+
+// Draws the sprites queued by the render_*_image() functions in one batch,
+// and the polygons queued by sdl_draw_polygon() in another. Drawing text or
+// showing the frame does this first, and queueing a sprite flushes the
+// polygons (and the other way around), so the draw order is kept.
+void flush_sprites(void);
+
 // create surface, texture, and rectangle for player image
 void create_image();
 
@@ -185,7 +259,65 @@ void render_wall_image(vector_t location);
 // adds image of door
 void render_door_image(vector_t location);
 
-// frees image texture
+/**
+ * Draws the images in the part of the scene from min to max,
+ * with the render_*_image() functions.
+ */
+typedef void (*background_drawer_t)(vector_t min, vector_t max, void *aux);
+
+/**
+ * Sets what sdl_render_background() draws: the images that never move.
+ * They are drawn into an off-screen texture once and then only copied,
+ * until the view moves too far, the zoom changes, or the renderer_t's
+ * background_changed hook (sdl_background_invalidate()) marks part of
+ * them as changed.
+ *
+ * @param drawer draws the background images in a given part of the scene
+ * @param aux passed to drawer
+ */
+void sdl_set_background(background_drawer_t drawer, void *aux);
+
+// Marks the background from min to max (scene coordinates) to be redrawn.
+void sdl_background_invalidate(vector_t min, vector_t max);
+
+// Copies the visible part of the background to the window, redrawing
+// any of it that is out of date first. Does nothing until
+// sdl_set_background() is called.
+void sdl_render_background(void);
+
+/**
+ * Sets up a picture of the map at one pixel per grid cell, for drawing it
+ * when zoomed far out (sdl_render_cells()) and for the minimap. Each cell
+ * starts out clear; set them with sdl_set_cell_color(). Only the cells that
+ * change are sent to the GPU again. The render_*_image() sprites are sized
+ * in cells too, so call this before drawing any.
+ *
+ * @param rows the number of rows of cells
+ * @param cols the number of columns of cells
+ * @param size the side of a cell. Cell (r, c) spans [c, c + 1] times the
+ *   size across and [r, r + 1] times the size up.
+ */
+void sdl_set_cell_grid(int rows, int cols, double size);
+
+// Sets the color of the cell at row r and column c.
+void sdl_set_cell_color(int r, int c, rgb_color_t color);
+
+// Makes the cell at row r and column c clear (nothing is drawn there).
+void sdl_clear_cell(int r, int c);
+
+// Whether cells are now so small on screen that they should be drawn with
+// sdl_render_cells() rather than one image each.
+bool sdl_cells_coarse(void);
+
+// Draws the grid from sdl_set_cell_grid(), one cell per pixel of the
+// picture, scaled into place.
+void sdl_render_cells(void);
+
+// Draws the grid from sdl_set_cell_grid() size pixels wide in the top
+// right corner, with the part the window shows outlined.
+void sdl_render_minimap(int size);
+
+// frees the atlas, the background, the cell map, and the sprite queue
 void image_free();
 
 // prints win message. yay!
@@ -0,0 +1,85 @@
+#ifndef __SESSION_H__
+#define __SESSION_H__
+
+#include "ailien.h"
+#include "input.h"
+#include "map.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * One play-through of the game: the map, the alien chasing the player, and
+ * the player's stamina and bullets. This is everything the game does between
+ * reading a key and drawing a frame, with no SDL, so the game, the headless
+ * replayer and anything else can drive it the same way:
+ * ```
+ * session_t *session = session_init(seed);
+ * while (running) {
+ *     // for each key event: session_key(session, key, type);
+ *     // for each fixed step: session_step(session, dt);
+ * }
+ * session_free(session);
+ * ```
+ * Given the same seed and the same keys on the same steps, two sessions end
+ * in the same state (see session_hash()).
+ */
+typedef struct session {
+    map_t *map;
+    alien_t *alien;
+    double stamina;
+    int explosives;
+    // what shoot() fires: "e" for explosive, "g" for grav gun
+    const char *bullet_type;
+    // direction the player faces, in degrees clockwise from up
+    double player_angle;
+    // steps run so far
+    uint32_t tick;
+    // set once 'q' is pressed
+    bool quit;
+} session_t;
+
+/**
+ * Makes a new map from a seed and puts the player and alien at their
+ * starting spots.
+ *
+ * @param seed the map's random seed, e.g. from rng_seed_from_time()
+ * @return a pointer to the newly allocated session
+ */
+session_t *session_init(uint64_t seed);
+
+// Frees the session along with its map and alien.
+void session_free(session_t *session);
+
+// The player's stamina as the percentage the HUD shows.
+int session_stamina_percent(session_t *session);
+
+/**
+ * Applies one key event: arrows move the player, WASD shoot, 'q' sets quit.
+ * Has the same shape as a key_handler_t minus the unused arguments.
+ *
+ * @param session the session to apply the key to
+ * @param key the key, as passed to a key_handler_t
+ * @param type KEY_PRESSED or KEY_RELEASED
+ */
+void session_key(session_t *session, char key, key_event_type_t type);
+
+/**
+ * Runs one fixed step: stamina, the alien, then the map.
+ *
+ * @param session the session to step
+ * @param dt the step length in seconds
+ */
+void session_step(session_t *session, double dt);
+
+/**
+ * A 64-bit FNV-1a hash of the state that matters to the player: the tick,
+ * player and alien positions and velocities, purse, stamina, bullets left and
+ * number of bodies. Equal sessions hash equal, so a replay can be checked
+ * against a known-good run by comparing one number.
+ *
+ * @param session the session to hash
+ * @return the hash
+ */
+uint64_t session_hash(session_t *session);
+
+#endif // #ifndef __SESSION_H__
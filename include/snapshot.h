@@ -0,0 +1,169 @@
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include "color.h"
+#include "input.h"
+#include "renderer.h"
+#include "session.h"
+#include "typed_list.h"
+#include "vec_list.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Everything a frame needs to draw the game, copied out of a session after
+ * a step, so a renderer on another thread never touches the live scene.
+ *
+ * The simulation fills the back snapshot of a snapshot_buffer_t and
+ * publishes it; the renderer reads whichever one was published last:
+ * ```
+ * // simulation thread
+ * snapshot_capture(snapshot_write_begin(buffer), session, timestep_now());
+ * snapshot_publish(buffer);
+ * // render thread
+ * snapshot_t *snapshot = snapshot_read(buffer);
+ * ```
+ * There are three snapshots, so neither side ever waits for the other: the
+ * writer always has a free one to fill, and the reader keeps the one it is
+ * drawing until it asks for a newer one.
+ */
+
+// A body drawn as a polygon: its vertices are points[first, first + count).
+typedef struct snapshot_polygon {
+    size_t first;
+    size_t count;
+    // where the body was the step before, and where it is now
+    vector_t prev_centroid;
+    vector_t centroid;
+    rgb_color_t color;
+} snapshot_polygon_t;
+
+DECLARE_LIST(snapshot_polygon_list, snapshot_polygon_t)
+
+// A part of the background that changed (scene coordinates), and the
+// background_version it changed it to.
+typedef struct snapshot_change {
+    uint32_t version;
+    vector_t min;
+    vector_t max;
+} snapshot_change_t;
+
+DECLARE_LIST(snapshot_change_list, snapshot_change_t)
+
+typedef struct snapshot {
+    // steps run when this was captured, and the wall time (timestep_now())
+    uint32_t tick;
+    double time;
+    vector_t player_prev;
+    vector_t player;
+    double player_angle;
+    vector_t alien_prev;
+    vector_t alien;
+    // HUD values as last reported to the renderer, or -1 if never reported
+    int money;
+    int stamina;
+    int bullets;
+    // bumped whenever part of the background changes
+    uint32_t background_version;
+    // the latest background changes, oldest first, up to background_version.
+    // only the last few dozen are kept, so a reader that has fallen further
+    // behind than the first one must redraw all of the background
+    snapshot_change_list_t *background_changes;
+    bool won;
+    bool lost;
+    bool quit;
+    // uncollected coins per grid cell, row by row
+    int rows;
+    int cols;
+    unsigned char *coins;
+    // every body that isn't drawn as an image
+    vec_list_t *points;
+    snapshot_polygon_list_t *polygons;
+} snapshot_t;
+
+/**
+ * Copies the render-relevant state of a session into a snapshot, reusing
+ * the snapshot's storage from the last time it was filled.
+ * HUD values and background changes come from SNAPSHOT_RENDERER, so it must
+ * be the renderer in use (see renderer_set()).
+ *
+ * @param snapshot the snapshot to fill, e.g. from snapshot_write_begin()
+ * @param session the session to copy
+ * @param time the wall time of the capture, e.g. timestep_now()
+ */
+void snapshot_capture(snapshot_t *snapshot, session_t *session, double time);
+
+// The uncollected coins in a grid cell, as of the snapshot.
+int snapshot_coins_at(snapshot_t *snapshot, int r, int c);
+
+/**
+ * A renderer that only remembers what it is told, for snapshot_capture() to
+ * copy. The simulation reports to it instead of to the screen when it runs
+ * on its own thread.
+ */
+extern const renderer_t SNAPSHOT_RENDERER;
+
+/**
+ * Sets the money, stamina and bullets SNAPSHOT_RENDERER remembers to a
+ * session's own, so nothing carries over from an earlier session. Call it
+ * when a session starts, before capturing it.
+ *
+ * @param session the session that is starting
+ */
+void snapshot_session_start(session_t *session);
+
+// Three snapshots handed from one writer thread to one reader thread.
+typedef struct snapshot_buffer snapshot_buffer_t;
+
+// Allocates a buffer of three empty snapshots.
+snapshot_buffer_t *snapshot_buffer_init(void);
+
+// Frees the buffer and its snapshots.
+void snapshot_buffer_free(snapshot_buffer_t *buffer);
+
+/**
+ * Returns the snapshot the writer may fill next. Only the writer may call
+ * this, and the snapshot is its own until snapshot_publish().
+ *
+ * @param buffer the buffer
+ * @return the back snapshot, holding whatever it held when last published
+ */
+snapshot_t *snapshot_write_begin(snapshot_buffer_t *buffer);
+
+// Makes the back snapshot the latest one. Never blocks.
+void snapshot_publish(snapshot_buffer_t *buffer);
+
+/**
+ * Returns the latest published snapshot. Only the reader may call this, and
+ * the snapshot stays valid and unchanged until its next call. Never blocks.
+ *
+ * @param buffer the buffer
+ * @return the latest snapshot, or NULL if none was published yet
+ */
+snapshot_t *snapshot_read(snapshot_buffer_t *buffer);
+
+/**
+ * Key events going the other way, from the thread that polls the window to
+ * the simulation: a fixed-size ring with one pushing and one popping thread.
+ */
+typedef struct key_queue key_queue_t;
+
+/**
+ * Allocates an empty queue.
+ *
+ * @param capacity the most events it holds, a power of 2
+ * @return a pointer to the newly allocated queue
+ */
+key_queue_t *key_queue_init(size_t capacity);
+
+// Frees the queue.
+void key_queue_free(key_queue_t *queue);
+
+// Adds a key event. Returns false (and drops it) if the queue is full.
+bool key_queue_push(key_queue_t *queue, char key, key_event_type_t type);
+
+// Takes the oldest key event. Returns false if the queue is empty.
+bool key_queue_pop(key_queue_t *queue, char *key, key_event_type_t *type);
+
+#endif // #ifndef __SNAPSHOT_H__
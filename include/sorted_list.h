@@ -12,6 +12,7 @@
 
 typedef struct slist{
   list_t *list;
+  arena_t *arena;
 } slist_t;
 
 /**
@@ -23,6 +24,17 @@ typedef struct slist{
  */
 slist_t *sl_init(int size, free_func_t freer);
 
+/**
+ * Initializes a sorted list inside an arena, e.g. the map's per-frame scratch.
+ * sl_free() on it only calls freer on the elements.
+ *
+ * @param arena the arena to allocate from
+ * @param size the size of the sorted list
+ * @param freer the free function
+ * @return the initialized sorted list
+ */
+slist_t *sl_init_in(arena_t *arena, int size, free_func_t freer);
+
 /**
  * Frees the sorted list
  *
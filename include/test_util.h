@@ -33,17 +33,7 @@ bool vec_equal(vector_t v1, vector_t v2);
  */
 bool vec_isclose(vector_t v1, vector_t v2);
 
-/**
- * Returns whether two double values are nearly equal,
- * where the acceptable difference is specified by epsilon.
- */
-bool within(double epsilon, double d1, double d2);
-
-/**
- * Returns whether two vectors are nearly equal,
- * where the acceptable difference of each component is specified by epsilon.
- */
-bool vec_within(double epsilon, vector_t v1, vector_t v2);
+// within() and vec_within() come from vector.h.
 
 /**
  * Open the file 'filename', read one word into 'testname', and close the file.
@@ -0,0 +1,74 @@
+#ifndef __TIMESTEP_H__
+#define __TIMESTEP_H__
+
+#include <stddef.h>
+
+/**
+ * A fixed-timestep accumulator. Real frame time is added in, and comes back
+ * out as a whole number of simulation steps of exactly the same length, so
+ * the simulation behaves the same at any frame rate. Whatever is left over
+ * (less than one step) is reported as an interpolation factor for rendering.
+ *
+ * Typical loop:
+ * ```
+ * timestep_t *ts = timestep_init(120, 8);
+ * while (running) {
+ *     int steps = timestep_tick(ts);
+ *     for (int i = 0; i < steps; i++) {
+ *         map_tick(map, timestep_dt(ts));
+ *     }
+ *     render(timestep_alpha(ts));
+ * }
+ * ```
+ */
+typedef struct timestep timestep_t;
+
+/**
+ * Allocates a new accumulator.
+ * Asserts that the rate and step cap are positive.
+ *
+ * @param rate_hz simulation steps per second, e.g. 120
+ * @param max_steps the most steps a single frame may ask for. Time beyond
+ *   that is dropped (the game slows down) rather than spent catching up.
+ * @return a pointer to the newly allocated accumulator
+ */
+timestep_t *timestep_init(double rate_hz, int max_steps);
+
+// Releases the accumulator.
+void timestep_free(timestep_t *ts);
+
+/**
+ * Adds elapsed time and takes out as many whole steps as fit, up to the cap.
+ *
+ * @param ts a pointer to an accumulator returned from timestep_init()
+ * @param frame_time seconds since the last call; negative values count as 0
+ * @return the number of steps of timestep_dt() to simulate now
+ */
+int timestep_advance(timestep_t *ts, double frame_time);
+
+/**
+ * Same as timestep_advance(), but measures the frame time itself with a
+ * monotonic wall clock. The first call only starts the clock and returns 0.
+ *
+ * @param ts a pointer to an accumulator returned from timestep_init()
+ * @return the number of steps of timestep_dt() to simulate now
+ */
+int timestep_tick(timestep_t *ts);
+
+// Length of one step in seconds.
+double timestep_dt(timestep_t *ts);
+
+// How far the leftover time is into the next step, in [0, 1).
+// Render at prev + alpha * (current - prev) to hide the step rate.
+double timestep_alpha(timestep_t *ts);
+
+// Total steps handed out so far.
+size_t timestep_steps(timestep_t *ts);
+
+// Total seconds thrown away because a frame hit the step cap.
+double timestep_dropped(timestep_t *ts);
+
+// Seconds on a monotonic wall clock (not CPU time), from an arbitrary start.
+double timestep_now(void);
+
+#endif // #ifndef __TIMESTEP_H__
@@ -0,0 +1,174 @@
+#ifndef __TYPED_LIST_H__
+#define __TYPED_LIST_H__
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/**
+ * Macros that stamp out a growable array of values of one type, for element
+ * types that list_t would otherwise need a malloc (and a pointer chase) per
+ * element for, e.g. vector_t. The API follows list_t:
+ *
+ *   name_t *name_init(size_t initial_size);
+ *   name_t *name_init_in(arena_t *arena, size_t initial_size);
+ *   void name_free(void *list);
+ *   size_t name_size(name_t *list);
+ *   size_t name_capacity(name_t *list);
+ *   type name_get(name_t *list, size_t index);
+ *   type *name_at(name_t *list, size_t index);      // pointer into the array
+ *   void name_set(name_t *list, size_t index, type value);
+ *   void name_add(name_t *list, type value);
+ *   type name_remove(name_t *list, size_t index);   // keeps order
+ *   type name_swap_remove(name_t *list, size_t index);
+ *   void name_truncate(name_t *list, size_t size);
+ *   void name_clear(name_t *list);
+ *   void name_reserve(name_t *list, size_t capacity);
+ *   type *name_data(name_t *list);                  // all elements, in order
+ *
+ * Elements are stored by value, so there is no freer; the array owns nothing
+ * but its own memory. As with list_init_in(), arena lists are never freed on
+ * their own and leave old arrays in the arena when they grow.
+ *
+ * Put DECLARE_LIST(name, type) in a header and DEFINE_LIST(name, type) in
+ * exactly one .c file.
+ */
+
+#define DECLARE_LIST(name, type)                                              \
+    typedef struct name {                                                     \
+        type *data;                                                           \
+        size_t size;                                                          \
+        size_t capacity;                                                      \
+        arena_t *arena;                                                       \
+    } name##_t;                                                               \
+                                                                              \
+    name##_t *name##_init(size_t initial_size);                               \
+    name##_t *name##_init_in(arena_t *arena, size_t initial_size);            \
+    void name##_free(void *list);                                             \
+    size_t name##_size(name##_t *list);                                       \
+    size_t name##_capacity(name##_t *list);                                   \
+    type name##_get(name##_t *list, size_t index);                            \
+    type *name##_at(name##_t *list, size_t index);                            \
+    void name##_set(name##_t *list, size_t index, type value);                \
+    void name##_add(name##_t *list, type value);                              \
+    type name##_remove(name##_t *list, size_t index);                         \
+    type name##_swap_remove(name##_t *list, size_t index);                    \
+    void name##_truncate(name##_t *list, size_t size);                        \
+    void name##_clear(name##_t *list);                                        \
+    void name##_reserve(name##_t *list, size_t capacity);                     \
+    type *name##_data(name##_t *list);
+
+#define DEFINE_LIST(name, type)                                               \
+    name##_t *name##_init(size_t initial_size) {                              \
+        return name##_init_in(NULL, initial_size);                            \
+    }                                                                         \
+                                                                              \
+    name##_t *name##_init_in(arena_t *arena, size_t initial_size) {           \
+        name##_t *list;                                                       \
+        if (initial_size == 0) {                                              \
+            initial_size = 1;                                                 \
+        }                                                                     \
+        if (arena != NULL) {                                                  \
+            list = arena_alloc(arena, sizeof(name##_t));                      \
+            list->data = arena_alloc(arena, initial_size * sizeof(type));     \
+        } else {                                                              \
+            list = malloc(sizeof(name##_t));                                  \
+            assert(list != NULL);                                             \
+            list->data = malloc(initial_size * sizeof(type));                 \
+            assert(list->data != NULL);                                       \
+        }                                                                     \
+        list->size = 0;                                                       \
+        list->capacity = initial_size;                                        \
+        list->arena = arena;                                                  \
+        return list;                                                          \
+    }                                                                         \
+                                                                              \
+    void name##_free(void *list) {                                            \
+        if (((name##_t *)list)->arena != NULL) {                              \
+            return;                                                           \
+        }                                                                     \
+        free(((name##_t *)list)->data);                                       \
+        free(list);                                                           \
+    }                                                                         \
+                                                                              \
+    size_t name##_size(name##_t *list) {                                      \
+        return list->size;                                                    \
+    }                                                                         \
+                                                                              \
+    size_t name##_capacity(name##_t *list) {                                  \
+        return list->capacity;                                                \
+    }                                                                         \
+                                                                              \
+    type name##_get(name##_t *list, size_t index) {                           \
+        assert(index < list->size);                                           \
+        return list->data[index];                                             \
+    }                                                                         \
+                                                                              \
+    type *name##_at(name##_t *list, size_t index) {                           \
+        assert(index < list->size);                                           \
+        return &list->data[index];                                            \
+    }                                                                         \
+                                                                              \
+    void name##_set(name##_t *list, size_t index, type value) {               \
+        assert(index < list->size);                                           \
+        list->data[index] = value;                                            \
+    }                                                                         \
+                                                                              \
+    void name##_reserve(name##_t *list, size_t capacity) {                    \
+        if (capacity <= list->capacity) {                                     \
+            return;                                                           \
+        }                                                                     \
+        type *new_data;                                                       \
+        if (list->arena != NULL) {                                            \
+            new_data = arena_alloc(list->arena, capacity * sizeof(type));     \
+        } else {                                                              \
+            new_data = malloc(capacity * sizeof(type));                       \
+            assert(new_data != NULL);                                         \
+        }                                                                     \
+        memcpy(new_data, list->data, list->size * sizeof(type));              \
+        if (list->arena == NULL) {                                            \
+            free(list->data);                                                 \
+        }                                                                     \
+        list->data = new_data;                                                \
+        list->capacity = capacity;                                            \
+    }                                                                         \
+                                                                              \
+    void name##_add(name##_t *list, type value) {                             \
+        if (list->size >= list->capacity) {                                   \
+            name##_reserve(list, 2 * list->capacity);                         \
+        }                                                                     \
+        list->data[list->size++] = value;                                     \
+    }                                                                         \
+                                                                              \
+    type name##_remove(name##_t *list, size_t index) {                        \
+        assert(index < list->size);                                           \
+        type temp = list->data[index];                                        \
+        memmove(list->data + index, list->data + index + 1,                   \
+                (list->size - index - 1) * sizeof(type));                     \
+        list->size--;                                                         \
+        return temp;                                                          \
+    }                                                                         \
+                                                                              \
+    type name##_swap_remove(name##_t *list, size_t index) {                   \
+        assert(index < list->size);                                           \
+        type temp = list->data[index];                                        \
+        list->data[index] = list->data[--list->size];                         \
+        return temp;                                                          \
+    }                                                                         \
+                                                                              \
+    void name##_truncate(name##_t *list, size_t size) {                       \
+        assert(size <= list->size);                                           \
+        list->size = size;                                                    \
+    }                                                                         \
+                                                                              \
+    void name##_clear(name##_t *list) {                                       \
+        list->size = 0;                                                       \
+    }                                                                         \
+                                                                              \
+    type *name##_data(name##_t *list) {                                       \
+        return list->data;                                                    \
+    }
+
+#endif // #ifndef __TYPED_LIST_H__
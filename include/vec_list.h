@@ -0,0 +1,14 @@
+#ifndef __VEC_LIST_H__
+#define __VEC_LIST_H__
+
+#include "typed_list.h"
+#include "vector.h"
+
+/**
+ * A growable array of vector_t values (see typed_list.h for the API).
+ * Used for polygon vertices, body forces and impulses, and collision axes,
+ * so each of those is one contiguous block rather than a list of pointers.
+ */
+DECLARE_LIST(vec_list, vector_t)
+
+#endif // #ifndef __VEC_LIST_H__
@@ -108,6 +108,10 @@ double vec_distance(vector_t v1, vector_t v2);
 // length of a vector
 double vec_magnitude(vector_t v);
 
-bool vec_isclose(double epsilon, vector_t v1, vector_t v2);
+// Whether two doubles are less than epsilon apart.
+bool within(double epsilon, double d1, double d2);
+
+// Whether each component of two vectors is less than epsilon apart.
+bool vec_within(double epsilon, vector_t v1, vector_t v2);
 
 #endif // #ifndef __VECTOR_H__
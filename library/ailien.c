@@ -1,13 +1,70 @@
 #include "ailien.h"
+#include "counters.h"
+#include "profiler.h"
 
-const int VISION_RADIUS = 75;
+// how far the alien sees, in cells of the map
+const double VISION_CELLS = 7.5;
 // const double LOOK_TIME = 5.00;
 const double LOOK_TIME = 1.00;
 const double VEL_STALK = 50;
 // const double VEL_STALK = 400;
 const double VEL_CHASE = 75;
 const int MAX_PATH = 3;
-const int MAX_NODES = 10000;
+const size_t PATH_SIZE = 100;
+
+// What A* knows about one grid cell during a search. Only meaningful when
+// stamp is the search's; anything older reads as unvisited, so a search
+// doesn't have to clear every cell of a big map first.
+typedef struct search_cell {
+  uint32_t stamp;
+  // Stores whether the node has been added into the queue so far.
+  bool open;
+  // g represents distance from start to current node
+  double g;
+  // Equivalent to f, the heuristic combining dist from start and dist to end
+  double priority;
+  // Stores parents; kept here so don't have to clear a field in node
+  node_t *parent;
+} search_cell_t;
+
+struct search {
+  uint32_t stamp;
+  // map->rows * map->cols of them, row by row
+  search_cell_t *cells;
+};
+
+// Starts a new search on the map, making its cells the first time.
+struct search *search_begin(map_t *map){
+  struct search *search = map->search;
+  size_t count = (size_t)map->rows * map->cols;
+  if(search == NULL){
+    search = arena_alloc(map->arena, sizeof(struct search));
+    search->cells = arena_calloc(map->arena, count * sizeof(search_cell_t));
+    search->stamp = 0;
+    map->search = search;
+  }
+  search->stamp++;
+  if(search->stamp == 0){
+    // wrapped around: stamps from 2^32 searches ago would look current
+    memset(search->cells, 0, count * sizeof(search_cell_t));
+    search->stamp = 1;
+  }
+  return search;
+}
+
+// The search's entry for the cell a node is in, fresh if not yet visited.
+search_cell_t *search_cell(map_t *map, struct search *search, node_t *node){
+  vector_t ind = map_ind_from_pos(map, body_get_centroid(node->node->body));
+  search_cell_t *cell = &search->cells[(size_t)ind.x * map->cols + (int)ind.y];
+  if(cell->stamp != search->stamp){
+    cell->stamp = search->stamp;
+    cell->open = false;
+    cell->g = INFINITY;
+    cell->priority = INFINITY;
+    cell->parent = NULL;
+  }
+  return cell;
+}
 
 // Computes the diagonal distance heuristic between two nodes based on their centroids.
 double diagonal_distance(node_t *start, node_t *end){
@@ -21,38 +78,26 @@ double diagonal_distance(node_t *start, node_t *end){
 }
 
 // A*. Uses priority queue defined by sorted_list. Reverses list ordering at end.
+// The returned path lives in the map's frame scratch; copy out what you keep.
 list_t *ai_star(map_t *map, node_t *start, node_t *end){
-  // Stores which nodes have been added into the queue so far.
-  bool open_arr[100][100];
-  // g represents distance from start to current node
-  double g_vals[100][100];
-  // Equivalent to f, the heuristic combining dist from start and dist to end
-  double priorities[100][100];
-  // Stores parents; reinit every time so don't have to clear a field in node
-  node_t *parents[100][100];
-  for(int i = 0; i < 100; i++){
-    for(int j = 0; j < 100; j++){
-      open_arr[i][j] = false;
-      g_vals[i][j] = INFINITY;
-      priorities[i][j] = INFINITY;
-      parents[i][j] = NULL;
-    }
-  }
-  // Adds first node to the queue and init its g
-  slist_t *open = sl_init(MAX_NODES, NULL);
+  struct search *search = search_begin(map);
+  // Adds first node to the queue and init its g. The queue grows as needed;
+  // it rarely holds more than a few rows' worth of cells
+  slist_t *open = sl_init_in(map->scratch, map->rows + map->cols, NULL);
   sl_enqueue(open, start);
-  vector_t start_ind = map_ind_from_pos(map, body_get_centroid(start->node->body));
-  priorities[(int)start_ind.x][(int)start_ind.y] = diagonal_distance(start, end);
-  open_arr[(int)start_ind.x][(int)start_ind.y] = true;
-  g_vals[(int)start_ind.x][(int)start_ind.y] = 0;
+  search_cell_t *start_cell = search_cell(map, search, start);
+  start_cell->priority = diagonal_distance(start, end);
+  start_cell->open = true;
+  start_cell->g = 0;
   bool done = false;
   // Main loop. run until no more nodes in the queue and the end has been found
   while(sl_size(open) > 0 && !done){
     // Get next node (lowest priority/distance) and calc coord in backing arr
     node_t *curr = (node_t *) sl_dequeue(open);
-    vector_t inds = map_ind_from_pos(map, body_get_centroid(curr->node->body));
-    open_arr[(int)inds.x][(int)inds.y] = false;
-    double old_dist = priorities[(int)inds.x][(int)inds.y];
+    counter_add(COUNTER_ASTAR_EXPANSIONS, 1);
+    search_cell_t *curr_cell = search_cell(map, search, curr);
+    curr_cell->open = false;
+    double old_dist = curr_cell->priority;
     // If we have end, exit
     if(node_compare(curr, end)){
       done = true;
@@ -63,35 +108,35 @@ list_t *ai_star(map_t *map, node_t *start, node_t *end){
       node_t *node = curr->neighbors[i];
       if(node == NULL)
         break;
-      vector_t pos = map_ind_from_pos(map, body_get_centroid(node->node->body));
+      search_cell_t *cell = search_cell(map, search, node);
       double g = old_dist + curr->distances[i];
       double f = g + diagonal_distance(node, end);
       // If shorter dist traveled from start, add to queue/replace priority
-      if(g < g_vals[(int)pos.x][(int)pos.y]){
-        parents[(int)pos.x][(int)pos.y] = curr;
-        g_vals[(int)pos.x][(int)pos.y] = g;
-        priorities[(int)pos.x][(int)pos.y] = f;
-        if(!open_arr[(int)pos.x][(int)pos.y]){
+      if(g < cell->g){
+        cell->parent = curr;
+        cell->g = g;
+        cell->priority = f;
+        if(!cell->open){
           sl_enqueue(open, node);
-          open_arr[(int)pos.x][(int)pos.y] = true;
+          counter_peak(COUNTER_ASTAR_OPEN_PEAK, sl_size(open));
+          cell->open = true;
         } else {
           sl_change_priority(open, node, f);
         }
       }
     }
   }
-  list_t *path = list_init(100, NULL);
+  list_t *path = list_init_in(map->scratch, PATH_SIZE, NULL);
   node_t *temp = end;
   assert(temp != NULL);
   assert(start != NULL);
   // Reconstruct path from parents; basically a linked list
   while(temp != NULL){
     list_add(path, temp);
-    vector_t pos = map_ind_from_pos(map, body_get_centroid(temp->node->body));
-    temp = parents[(int)pos.x][(int)pos.y];
+    temp = search_cell(map, search, temp)->parent;
   }
   // Reverse path to adjust for fact that parent reconstruction is end->start
-  list_t *adj_path = list_init(100, NULL);
+  list_t *adj_path = list_init_in(map->scratch, PATH_SIZE, NULL);
   for(size_t i = list_size(path); i > 0; i--){
     node_t *elem = (node_t *)list_get(path, i-1);
     list_add(adj_path, elem);
@@ -109,7 +154,8 @@ alien_t *ai_init_bounds(map_t *map){
   a->is_moving_toward_node = false;
   a->wait_time = 0;
   a->player_last_seen = NULL;
-  a->path = list_init(30, NULL);
+  // Walked from the front, so a deque keeps popping reached nodes O(1)
+  a->path = list_init_deque(30, NULL);
   return a;
 }
 
@@ -126,26 +172,27 @@ double get_angle(vector_t one, vector_t two){
 }
 
 
-// Helper method to extract nodes from map backing array of nodes.
+// Helper method to extract nodes from map backing array of nodes: those
+// within stalk_radius cells of the player. List is frame scratch.
 list_t *get_nodes(map_t *map, object_t *player, int stalk_radius){
   vector_t centroid = body_get_centroid(player->body);
-  list_t *ans = list_init(stalk_radius * stalk_radius, NULL);
+  list_t *ans = list_init_in(map->scratch, stalk_radius * stalk_radius, NULL);
   vector_t arr_ind = map_ind_from_pos(map, centroid);
   list_t *nodets = map->struct_nodes;
   for(int i = arr_ind.x - stalk_radius; i < arr_ind.x + stalk_radius; i++){
     for(int j = arr_ind.y - stalk_radius; j < arr_ind.y + stalk_radius; j++){
       // Buffer of 1 to avoid walls
       object_t *o;
-      if(i > 0 && i < 100 -1 && j > 0 && j < 100 -1){
+      if(i > 0 && i < map->rows - 1 && j > 0 && j < map->cols - 1){
         o = (object_t *)arr_get(map->backing_array, i, j);
       } else
         continue;
       if(strcmp(o->type, "wall") != 0){
-        if(i > 0 && i < 100 -1 && j > 0 && j < 100 -1){
+        if(i > 0 && i < map->rows - 1 && j > 0 && j < map->cols - 1){
             node_t *target = (node_t *)arr_get(nodets, i, j);
             vector_t n_cent = body_get_centroid(target->node->body);
             double dist = vec_distance(n_cent, body_get_centroid(player->body));
-            if(dist < stalk_radius*100){
+            if(dist < stalk_radius * map->cell_size){
               list_add(ans, arr_get(nodets, i, j));
             }
           }
@@ -158,12 +205,14 @@ list_t *get_nodes(map_t *map, object_t *player, int stalk_radius){
 // Helper method to determine if player is withing alien's vision radius AND
 // line of vision is not blocked. Can be blocked by walls and hiding spots.
 bool ai_can_see_player(map_t *map, alien_t *alien, int stalk_radius){
+  double vision_radius = VISION_CELLS * map->cell_size;
   if(is_hiding(map) || vec_distance(body_get_centroid(alien->alien->body),
-    body_get_centroid(alien->player->body)) > VISION_RADIUS){
+    body_get_centroid(alien->player->body)) > vision_radius){
       return false;
   } else{
     // Maybe change to only see in one direction?
-    list_t *nodes = get_nodes(map, alien->alien, VISION_RADIUS);
+    // a spot can only block the player if it is nearer, so within vision
+    list_t *nodes = get_nodes(map, alien->alien, (int)ceil(VISION_CELLS) + 1);
     double angle = get_angle(body_get_centroid(alien->player->body),
       body_get_centroid(alien->alien->body));
     // Hiding spots
@@ -172,9 +221,9 @@ bool ai_can_see_player(map_t *map, alien_t *alien, int stalk_radius){
       if(strcmp(node->node->type, "dumpster") == 0 || strcmp(node->node->type, "locker") == 0){
         double min_angle = INFINITY;
         double max_angle = -INFINITY;
-        list_t *points = body_get_shape(node->node->body);
-        for(size_t i = 0; i < list_size(points); i++){
-          vector_t *point = (vector_t *) list_get(points, i);
+        vec_list_t *points = body_get_points(node->node->body);
+        for(size_t i = 0; i < vec_list_size(points); i++){
+          vector_t *point = vec_list_at(points, i);
           double ang = get_angle(*point, body_get_centroid(alien->alien->body));
           if(ang < min_angle)
             min_angle = ang;
@@ -184,12 +233,10 @@ bool ai_can_see_player(map_t *map, alien_t *alien, int stalk_radius){
         if(min_angle < angle && angle < max_angle){
           if(vec_distance(body_get_centroid(alien->alien->body), body_get_centroid(alien->player->body))
             >= vec_distance(body_get_centroid(alien->alien->body), body_get_centroid(node->node->body))){
-              list_free(points);
               list_free(nodes);
               return false;
             }
         }
-        list_free(points);
       }
     }
     list_free(nodes);
@@ -201,9 +248,9 @@ bool ai_can_see_player(map_t *map, alien_t *alien, int stalk_radius){
       object_t *wall = (object_t *) list_get(walls, i);
       double min_angle = INFINITY;
       double max_angle = -INFINITY;
-      list_t *points = body_get_shape(wall->body);
-      for(size_t i = 0; i < list_size(points); i++){
-        vector_t *point = (vector_t *) list_get(points, i);
+      vec_list_t *points = body_get_points(wall->body);
+      for(size_t i = 0; i < vec_list_size(points); i++){
+        vector_t *point = vec_list_at(points, i);
         double ang = get_angle(*point, body_get_centroid(alien->alien->body));
         if(ang < min_angle)
           min_angle = ang;
@@ -213,11 +260,9 @@ bool ai_can_see_player(map_t *map, alien_t *alien, int stalk_radius){
       if(min_angle < angle && angle < max_angle){
         if(vec_distance(body_get_centroid(alien->alien->body), body_get_centroid(alien->player->body))
           >= vec_distance(body_get_centroid(alien->alien->body), body_get_centroid(wall->body))){
-            list_free(points);
             return false;
           }
       }
-      list_free(points);
     }
     return true;
   }
@@ -233,10 +278,9 @@ void direct_alien(body_t *alien, vector_t dest, double velocity){
 }
 
 // Shuffles a list. To make alien's stalking more realistic.
-list_t *shuffle(list_t *arr){
-  srand(time(0));
+list_t *shuffle(rng_t *rng, list_t *arr){
   for(size_t i = 0; i < list_size(arr); ++i){
-    int ind = (int)(rand() % (list_size(arr)-i))+i;
+    int ind = (int)rng_below(rng, list_size(arr)-i)+i;
     node_t *new = (node_t *) list_get(arr, ind);
     node_t *old = list_replace(arr, i, new);
     list_replace(arr, ind, old);
@@ -248,10 +292,10 @@ list_t *shuffle(list_t *arr){
 // Calls A* multiple times to create a path between several chosen destination nodes.
 void ai_create_next_path(map_t *map, alien_t *alien, int stalk_radius){
   object_t *player = alien->player;
-  list_t *temp_path = list_init(MAX_PATH, NULL);
+  list_t *temp_path = list_init_in(map->scratch, MAX_PATH, NULL);
   list_t *path = alien->path;
   list_t *path_extension = get_nodes(map, player, stalk_radius);
-  path_extension = shuffle(path_extension);
+  path_extension = shuffle(&map->rng, path_extension);
   for(size_t i = 0; i < (list_size(path_extension)<MAX_PATH ? list_size(path_extension) : MAX_PATH); i++){
     node_t *path_elem = (node_t *) list_get(path_extension, i);
     list_add(temp_path, path_elem);
@@ -287,6 +331,7 @@ void ai_create_next_path(map_t *map, alien_t *alien, int stalk_radius){
 }
 
 void ai_stalk(map_t *map, alien_t *alien, int stalk_radius, double tick){
+  PROFILE_ZONE("ai_stalk");
   if(ai_can_see_player(map, alien, stalk_radius)){
     // Actively chasing the player
     basic_follow(map, VEL_CHASE);
@@ -305,6 +350,7 @@ void ai_stalk(map_t *map, alien_t *alien, int stalk_radius, double tick){
     vector_t inds = map_ind_from_pos(map, a_cent);
     node_t *last = (node_t *)arr_get(map->struct_nodes, inds.x, inds.y);
     list_t *vals = ai_star(map, last, alien->player_last_seen);
+    list_reserve(alien->path, list_size(vals));
     for(size_t j = 0; j < list_size(vals); j++){
       node_t *next = (node_t *) list_get(vals, j);
       list_add(alien->path, next);
@@ -332,8 +378,8 @@ void ai_stalk(map_t *map, alien_t *alien, int stalk_radius, double tick){
         vector_t n_pos = body_get_centroid(((node_t *)list_get(alien->path, 0))->node->body);
         direct_alien(alien->alien->body, n_pos, VEL_STALK);
         vector_t a_pos = body_get_centroid(alien->alien->body);
-        if(vec_isclose(5, a_pos, n_pos)){
-          list_remove(alien->path, 0);
+        if(vec_within(map->cell_size / 2, a_pos, n_pos)){
+          list_pop_front(alien->path);
         }
       }
       else{
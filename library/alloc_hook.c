@@ -0,0 +1,34 @@
+#include "counters.h"
+#include <stdlib.h>
+
+// Counts every malloc/calloc/realloc/free made by code linked with
+//   -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free
+// (ALLOC_WRAP in the Makefile). The linker sends those calls here, and
+// __real_* reach the actual allocator. Only link this file with those flags.
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) {
+    counter_add(COUNTER_MALLOCS, 1);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    counter_add(COUNTER_MALLOCS, 1);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    counter_add(ptr == NULL ? COUNTER_MALLOCS : COUNTER_REALLOCS, 1);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr != NULL) {
+        counter_add(COUNTER_FREES, 1);
+    }
+    __real_free(ptr);
+}
@@ -0,0 +1,114 @@
+#include "arena.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every allocation is rounded up to this so any type can live in the arena.
+const size_t ARENA_ALIGN = alignof(max_align_t);
+
+typedef struct chunk {
+    struct chunk *next;
+    size_t capacity;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+} chunk_t;
+
+typedef struct arena {
+    chunk_t *head;
+    size_t chunk_size;
+    size_t used;
+    size_t num_chunks;
+} arena_t;
+
+chunk_t *chunk_init(size_t capacity) {
+    chunk_t *chunk = malloc(sizeof(chunk_t) + capacity);
+    assert(chunk != NULL);
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    return chunk;
+}
+
+arena_t *arena_init(size_t chunk_size) {
+    arena_t *arena = malloc(sizeof(arena_t));
+    assert(arena != NULL);
+    arena->chunk_size = chunk_size;
+    arena->head = chunk_init(chunk_size);
+    arena->used = 0;
+    arena->num_chunks = 1;
+    return arena;
+}
+
+void arena_free(arena_t *arena) {
+    chunk_t *chunk = arena->head;
+    while (chunk != NULL) {
+        chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    chunk_t *chunk = arena->head;
+    if (chunk->used + size > chunk->capacity) {
+        // Oversized requests get their own chunk behind the head so the
+        // partially used head chunk keeps serving small allocations.
+        if (size > arena->chunk_size) {
+            chunk_t *big = chunk_init(size);
+            big->next = chunk->next;
+            chunk->next = big;
+            big->used = size;
+            arena->used += size;
+            arena->num_chunks++;
+            return big->data;
+        }
+        chunk = chunk_init(arena->chunk_size);
+        chunk->next = arena->head;
+        arena->head = chunk;
+        arena->num_chunks++;
+    }
+    void *ans = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    return ans;
+}
+
+void *arena_calloc(arena_t *arena, size_t size) {
+    void *ans = arena_alloc(arena, size);
+    memset(ans, 0, size);
+    return ans;
+}
+
+char *arena_strdup(arena_t *arena, const char *str) {
+    size_t len = strlen(str) + 1;
+    char *ans = arena_alloc(arena, len);
+    memcpy(ans, str, len);
+    return ans;
+}
+
+void arena_reset(arena_t *arena) {
+    // The head is always a regular sized chunk; keep it and drop the rest.
+    chunk_t *keep = arena->head;
+    chunk_t *chunk = keep->next;
+    while (chunk != NULL) {
+        chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    keep->next = NULL;
+    keep->used = 0;
+    arena->head = keep;
+    arena->used = 0;
+    arena->num_chunks = 1;
+}
+
+size_t arena_used(arena_t *arena) {
+    return arena->used;
+}
+
+size_t arena_chunks(arena_t *arena) {
+    return arena->num_chunks;
+}
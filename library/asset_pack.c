@@ -0,0 +1,231 @@
+#include "asset_pack.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char ASSET_MAGIC[4] = {'A', 'P', 'A', 'K'};
+const uint32_t ASSET_VERSION = 1;
+// written as is, so it reads back differently on a machine of the other
+// byte order
+const uint32_t ASSET_BYTE_ORDER = 0x01020304;
+const size_t ASSET_ALIGN = 16;
+const size_t ASSET_WRITER_SIZE = 16;
+// added to a pack's path for the file it is written to before the rename
+#define ASSET_TEMP_SUFFIX ".tmp"
+
+typedef struct asset_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t count;
+} asset_header_t;
+
+typedef struct asset_entry {
+    char name[ASSET_NAME_SIZE];
+    uint32_t width;
+    uint32_t height;
+    // from the start of the file
+    uint64_t offset;
+    uint64_t size;
+} asset_entry_t;
+
+struct asset_pack {
+    const unsigned char *bytes;
+    size_t size;
+    const asset_entry_t *entries;
+    uint32_t count;
+};
+
+struct asset_pack_writer {
+    asset_entry_t *entries;
+    unsigned char **data;
+    size_t count;
+    size_t capacity;
+};
+
+// Rounds an offset up to the next multiple of ASSET_ALIGN.
+size_t asset_align(size_t offset) {
+    return (offset + ASSET_ALIGN - 1) / ASSET_ALIGN * ASSET_ALIGN;
+}
+
+asset_pack_t *asset_pack_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(asset_header_t)) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = info.st_size;
+    // shared, so every process mapping the file reads the same cached pages
+    void *bytes = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED) {
+        return NULL;
+    }
+    const asset_header_t *header = bytes;
+    const asset_entry_t *entries =
+        (const asset_entry_t *)((const unsigned char *)bytes + sizeof(asset_header_t));
+    bool valid = memcmp(header->magic, ASSET_MAGIC, sizeof(ASSET_MAGIC)) == 0 &&
+                 header->version == ASSET_VERSION &&
+                 header->byte_order == ASSET_BYTE_ORDER &&
+                 header->count <= (size - sizeof(asset_header_t)) / sizeof(asset_entry_t);
+    for (uint32_t i = 0; valid && i < header->count; i++) {
+        valid = entries[i].name[ASSET_NAME_SIZE - 1] == '\0' &&
+                entries[i].offset <= size && entries[i].size <= size - entries[i].offset;
+    }
+    if (!valid) {
+        munmap(bytes, size);
+        return NULL;
+    }
+    asset_pack_t *pack = malloc(sizeof(asset_pack_t));
+    assert(pack != NULL);
+    pack->bytes = bytes;
+    pack->size = size;
+    pack->entries = entries;
+    pack->count = header->count;
+    return pack;
+}
+
+void asset_pack_close(asset_pack_t *pack) {
+    munmap((void *)pack->bytes, pack->size);
+    free(pack);
+}
+
+bool asset_pack_find(asset_pack_t *pack, const char *name, asset_t *asset) {
+    if (pack == NULL) {
+        return false;
+    }
+    // a few dozen entries at most, looked up once each at startup
+    for (uint32_t i = 0; i < pack->count; i++) {
+        const asset_entry_t *entry = &pack->entries[i];
+        if (strcmp(entry->name, name) == 0) {
+            asset->name = entry->name;
+            asset->width = entry->width;
+            asset->height = entry->height;
+            asset->size = entry->size;
+            asset->data = pack->bytes + entry->offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool asset_pack_find_image(asset_pack_t *pack, const char *name, asset_t *asset) {
+    if (!asset_pack_find(pack, name, asset) || asset->width == 0 || asset->height == 0) {
+        return false;
+    }
+    // each factor is below 2^32, so the product can't overflow 64 bits
+    return (uint64_t)asset->width * asset->height <= SIZE_MAX / 4 &&
+           asset->size == (size_t)asset->width * asset->height * 4;
+}
+
+asset_pack_writer_t *asset_pack_writer_init(void) {
+    asset_pack_writer_t *writer = malloc(sizeof(asset_pack_writer_t));
+    assert(writer != NULL);
+    writer->entries = malloc(ASSET_WRITER_SIZE * sizeof(asset_entry_t));
+    writer->data = malloc(ASSET_WRITER_SIZE * sizeof(unsigned char *));
+    assert(writer->entries != NULL && writer->data != NULL);
+    writer->count = 0;
+    writer->capacity = ASSET_WRITER_SIZE;
+    return writer;
+}
+
+void asset_pack_writer_free(asset_pack_writer_t *writer) {
+    for (size_t i = 0; i < writer->count; i++) {
+        free(writer->data[i]);
+    }
+    free(writer->entries);
+    free(writer->data);
+    free(writer);
+}
+
+// Adds an entry of size bytes and returns its (uninitialized) data.
+unsigned char *asset_pack_add(asset_pack_writer_t *writer, const char *name,
+                              uint32_t width, uint32_t height, size_t size) {
+    assert(strlen(name) < ASSET_NAME_SIZE);
+    if (writer->count == writer->capacity) {
+        writer->capacity *= 2;
+        writer->entries =
+            realloc(writer->entries, writer->capacity * sizeof(asset_entry_t));
+        writer->data =
+            realloc(writer->data, writer->capacity * sizeof(unsigned char *));
+        assert(writer->entries != NULL && writer->data != NULL);
+    }
+    asset_entry_t *entry = &writer->entries[writer->count];
+    memset(entry, 0, sizeof(asset_entry_t));
+    strcpy(entry->name, name);
+    entry->width = width;
+    entry->height = height;
+    entry->size = size;
+    unsigned char *data = malloc(size > 0 ? size : 1);
+    assert(data != NULL);
+    writer->data[writer->count++] = data;
+    return data;
+}
+
+void asset_pack_add_image(asset_pack_writer_t *writer, const char *name,
+                          uint32_t width, uint32_t height, const void *pixels,
+                          size_t pitch) {
+    size_t row = (size_t)width * 4;
+    assert(pitch >= row);
+    unsigned char *data = asset_pack_add(writer, name, width, height, row * height);
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(data + y * row, (const unsigned char *)pixels + y * pitch, row);
+    }
+}
+
+void asset_pack_add_data(asset_pack_writer_t *writer, const char *name,
+                         const void *data, size_t size) {
+    memcpy(asset_pack_add(writer, name, 0, 0, size), data, size);
+}
+
+bool asset_pack_write(asset_pack_writer_t *writer, const char *path) {
+    // truncating the file in place would fault any process that has it mapped
+    size_t length = strlen(path);
+    char *temp = malloc(length + sizeof(ASSET_TEMP_SUFFIX));
+    assert(temp != NULL);
+    memcpy(temp, path, length);
+    memcpy(temp + length, ASSET_TEMP_SUFFIX, sizeof(ASSET_TEMP_SUFFIX));
+    FILE *file = fopen(temp, "wb");
+    if (file == NULL) {
+        perror(temp);
+        free(temp);
+        return false;
+    }
+    size_t offset = asset_align(sizeof(asset_header_t) +
+                                writer->count * sizeof(asset_entry_t));
+    for (size_t i = 0; i < writer->count; i++) {
+        writer->entries[i].offset = offset;
+        offset = asset_align(offset + writer->entries[i].size);
+    }
+    asset_header_t header = {{0}, ASSET_VERSION, ASSET_BYTE_ORDER, writer->count};
+    memcpy(header.magic, ASSET_MAGIC, sizeof(ASSET_MAGIC));
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(writer->entries, sizeof(asset_entry_t), writer->count, file) ==
+                  writer->count;
+    for (size_t i = 0; ok && i < writer->count; i++) {
+        // zeroes up to the entry's aligned start
+        ok = fseek(file, writer->entries[i].offset, SEEK_SET) == 0 &&
+             fwrite(writer->data[i], 1, writer->entries[i].size, file) ==
+                 writer->entries[i].size;
+    }
+    ok = fclose(file) == 0 && ok;
+    if (ok && rename(temp, path) != 0) {
+        perror(path);
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: could not write the asset pack\n", path);
+        remove(temp);
+    }
+    free(temp);
+    return ok;
+}
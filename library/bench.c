@@ -0,0 +1,148 @@
+#include "bench.h"
+#include "list.h"
+#include "timestep.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const size_t NUM_RESULTS = 16;
+const size_t WARMUP_DIVISOR = 10;
+const double NS_PER_S = 1e9;
+
+typedef struct bench_result {
+    const char *name;
+    size_t batch;
+    size_t iterations;
+    double median_ns;
+    double p99_ns;
+    double min_ns;
+    double mean_ns;
+} bench_result_t;
+
+typedef struct bench_check {
+    const char *name;
+    uint64_t value;
+} bench_check_t;
+
+typedef struct bench {
+    list_t *results;
+    list_t *checks;
+} bench_t;
+
+bench_t *bench_init(void) {
+    bench_t *bench = malloc(sizeof(bench_t));
+    assert(bench != NULL);
+    bench->results = list_init(NUM_RESULTS, free);
+    bench->checks = list_init(NUM_RESULTS, free);
+    return bench;
+}
+
+void bench_free(bench_t *bench) {
+    list_free(bench->results);
+    list_free(bench->checks);
+    free(bench);
+}
+
+int bench_compare(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples.
+double bench_percentile(double *sorted, size_t n, double fraction) {
+    size_t rank = (size_t)(fraction * n + .999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[(rank > n ? n : rank) - 1];
+}
+
+// Runs one sample of the case and returns its time per call in ns.
+double bench_sample(bench_case_t *test) {
+    double start = timestep_now();
+    for (size_t i = 0; i < test->batch; i++) {
+        test->run(test->aux);
+    }
+    double elapsed = timestep_now() - start;
+    if (test->reset != NULL) {
+        test->reset(test->aux);
+    }
+    return elapsed * NS_PER_S / test->batch;
+}
+
+void bench_run(bench_t *bench, bench_case_t test) {
+    assert(test.run != NULL);
+    assert(test.batch > 0 && test.iterations > 0);
+    size_t warmup = test.iterations / WARMUP_DIVISOR;
+    if (warmup < 1) {
+        warmup = 1;
+    }
+    for (size_t i = 0; i < warmup; i++) {
+        bench_sample(&test);
+    }
+    double *samples = malloc(test.iterations * sizeof(double));
+    assert(samples != NULL);
+    double total = 0;
+    for (size_t i = 0; i < test.iterations; i++) {
+        samples[i] = bench_sample(&test);
+        total += samples[i];
+    }
+    qsort(samples, test.iterations, sizeof(double), bench_compare);
+
+    bench_result_t *result = malloc(sizeof(bench_result_t));
+    assert(result != NULL);
+    result->name = test.name;
+    result->batch = test.batch;
+    result->iterations = test.iterations;
+    result->median_ns = bench_percentile(samples, test.iterations, .5);
+    result->p99_ns = bench_percentile(samples, test.iterations, .99);
+    result->min_ns = samples[0];
+    result->mean_ns = total / test.iterations;
+    list_add(bench->results, result);
+    free(samples);
+    printf("%-32s median %12.0f ns  p99 %12.0f ns  (%zu x %zu)\n", result->name,
+           result->median_ns, result->p99_ns, result->iterations,
+           result->batch);
+}
+
+void bench_check(bench_t *bench, const char *name, uint64_t value) {
+    bench_check_t *check = malloc(sizeof(bench_check_t));
+    assert(check != NULL);
+    check->name = name;
+    check->value = value;
+    list_add(bench->checks, check);
+    printf("%-32s %016llx\n", name, (unsigned long long)value);
+}
+
+bool bench_write_json(bench_t *bench, const char *path, const char *label) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    // names and labels are plain identifiers, so nothing needs escaping
+    fprintf(file, "{\n  \"label\": \"%s\",\n  \"results\": [\n", label);
+    size_t size = list_size(bench->results);
+    for (size_t i = 0; i < size; i++) {
+        bench_result_t *result = list_get(bench->results, i);
+        fprintf(file,
+                "    {\"name\": \"%s\", \"batch\": %zu, \"iterations\": %zu, "
+                "\"median_ns\": %.1f, \"p99_ns\": %.1f, \"min_ns\": %.1f, "
+                "\"mean_ns\": %.1f}%s\n",
+                result->name, result->batch, result->iterations,
+                result->median_ns, result->p99_ns, result->min_ns,
+                result->mean_ns, i + 1 < size ? "," : "");
+    }
+    fprintf(file, "  ],\n  \"checks\": [\n");
+    size = list_size(bench->checks);
+    for (size_t i = 0; i < size; i++) {
+        bench_check_t *check = list_get(bench->checks, i);
+        fprintf(file, "    {\"name\": \"%s\", \"value\": \"%016llx\"}%s\n",
+                check->name, (unsigned long long)check->value,
+                i + 1 < size ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return true;
+}
@@ -1,9 +1,13 @@
 #include <math.h>
 #include "body.h"
 
-const int NUM_FORCES = 50;
-const int NUM_IMP = 5;
+// Starting room; forces are stored by value so these only grow if needed.
+const int NUM_FORCES = 8;
+const int NUM_IMP = 4;
+const int NUM_LINKS = 4;
 const double AVG = .5;
+// Bodies per slab in the body pool.
+const size_t BODY_SLAB = 64;
 
 typedef struct body {
     polygon_t *shape;
@@ -11,52 +15,104 @@ typedef struct body {
     rgb_color_t color;
     double orientation;
     double mass;
-    list_t *forces;
-    list_t *impulses;
+    vec_list_t *forces;
+    vec_list_t *impulses;
     void *info;
     bool has_info;
     free_func_t freer;
     bool rem;
     vector_t centroid;
+    // centroid before the last body_tick(), for interpolated rendering
+    vector_t prev_centroid;
+    arena_t *arena;
+    list_t *links;
+    // drawn some other way, so sdl_render_scene() skips it
+    bool hidden;
 } body_t;
 
+// Heap bodies come from here instead of malloc; made on first use and freed
+// at exit.
+pool_t *BODY_POOL = NULL;
+
+void body_pool_free(void) {
+    pool_free(BODY_POOL);
+    BODY_POOL = NULL;
+}
+
+pool_t *body_pool(void) {
+    if (BODY_POOL == NULL) {
+        BODY_POOL = pool_init(sizeof(body_t), BODY_SLAB);
+        atexit(body_pool_free);
+    }
+    return BODY_POOL;
+}
+
+pool_stats_t body_pool_stats(void) {
+    return pool_stats(body_pool());
+}
+
 body_t *body_init(list_t *shape, double mass, rgb_color_t color) {
-    body_t *body = malloc(sizeof(body_t));
-    assert(body != NULL);
+    body_t *body = pool_alloc(body_pool());
     body->shape = polygon_init(list_size(shape));
     polygon_set_points(body->shape, shape);
     body->velocity = (vector_t){0.0, 0.0};
     body->color = color;
     body->mass = mass;
     body->orientation = 0;
-    body->forces = list_init(NUM_FORCES, vec_free);
-    body->impulses = list_init(NUM_IMP, vec_free);
+    body->forces = vec_list_init(NUM_FORCES);
+    body->impulses = vec_list_init(NUM_IMP);
     body->rem = false;
     body->centroid = polygon_centroid(body->shape);
+    body->prev_centroid = body->centroid;
     body->has_info = false;
+    body->arena = NULL;
+    body->links = NULL;
+    body->hidden = false;
+    return body;
+}
+
+body_t *body_init_in(arena_t *arena, vec_list_t *shape, double mass, rgb_color_t color) {
+    body_t *body = arena_alloc(arena, sizeof(body_t));
+    body->shape = polygon_init_in(arena, shape);
+    body->velocity = (vector_t){0.0, 0.0};
+    body->color = color;
+    body->mass = mass;
+    body->orientation = 0;
+    body->forces = vec_list_init_in(arena, NUM_FORCES);
+    body->impulses = vec_list_init_in(arena, NUM_IMP);
+    body->rem = false;
+    body->centroid = polygon_centroid(body->shape);
+    body->prev_centroid = body->centroid;
+    body->has_info = false;
+    body->arena = arena;
+    body->links = NULL;
+    body->hidden = false;
     return body;
 }
 
 body_t *body_init_with_info(list_t *shape, double mass, rgb_color_t color, void *aux, free_func_t freer) {
-    body_t *body = malloc(sizeof(body_t));
-    assert(body != NULL);
+    body_t *body = pool_alloc(body_pool());
     body->shape = polygon_init(list_size(shape));
     polygon_set_points(body->shape, shape);
     body->velocity = (vector_t){0.0, 0.0};
     body->color = color;
     body->mass = mass;
     body->orientation = 0;
-    body->forces = list_init(NUM_FORCES, vec_free);
-    body->impulses = list_init(NUM_IMP, vec_free);
+    body->forces = vec_list_init(NUM_FORCES);
+    body->impulses = vec_list_init(NUM_IMP);
     body->rem = false;
     body->has_info = false;
+    body->arena = NULL;
+    body->links = NULL;
+    body->hidden = false;
     body_put_info(body, aux, freer);
     body->centroid = polygon_centroid(body->shape);
+    body->prev_centroid = body->centroid;
     return body;
 }
 
 void body_put_info(void *body, void *aux, free_func_t freer){
-  if(((body_t *)body)->has_info){
+  if(((body_t *)body)->has_info && ((body_t *)body)->freer != NULL){
     ((body_t *)body)->freer(body_get_info(body));
   }
   ((body_t *)body)->info = aux;
@@ -73,12 +129,17 @@ void *body_get_info(body_t *body){
 
 void body_free(void *body) {
     polygon_free(((body_t *)body)->shape);
-    list_free(((body_t *)body)->forces);
-    list_free(((body_t *)body)->impulses);
-    if(((body_t *)body)->has_info){
+    vec_list_free(((body_t *)body)->forces);
+    vec_list_free(((body_t *)body)->impulses);
+    if(((body_t *)body)->links != NULL){
+      list_free(((body_t *)body)->links);
+    }
+    if(((body_t *)body)->has_info && ((body_t *)body)->freer != NULL){
       ((body_t *)body)->freer(body_get_info(body));
     }
-    free(((body_t *)body));
+    if(((body_t *)body)->arena == NULL){
+      pool_release(body_pool(), body);
+    }
 }
 
 double body_get_mass(body_t *body){
@@ -86,17 +147,21 @@ double body_get_mass(body_t *body){
 }
 
 list_t *body_get_shape(body_t *body) {
-    list_t *points = polygon_get_points(body->shape);
-    size_t size = list_size(points);
+    vec_list_t *points = polygon_get_points(body->shape);
+    size_t size = vec_list_size(points);
     list_t *copy = list_init(size, vec_free);
     for (size_t i = 0; i < size; i++) {
         vector_t *temp = malloc(sizeof(vector_t));
-        *temp = *(vector_t *)list_get(points, i);
+        *temp = vec_list_get(points, i);
         list_add(copy, temp);
     }
     return copy;
 }
 
+vec_list_t *body_get_points(body_t *body) {
+    return polygon_get_points(body->shape);
+}
+
 vector_t body_get_centroid(body_t *body) {
     // return polygon_centroid(body->shape);
     return body->centroid;
@@ -114,9 +179,24 @@ void body_set_color(body_t *body, rgb_color_t color) {
     body->color = color;
 }
 
+void body_set_hidden(body_t *body, bool hidden) {
+    body->hidden = hidden;
+}
+
+bool body_is_hidden(body_t *body) {
+    return body->hidden;
+}
+
 void body_set_centroid(body_t *body, vector_t x) {
     polygon_translate(body->shape, vec_subtract(x, body->centroid));
     body->centroid = x;
+    // a teleport should not be drawn as a slide
+    body->prev_centroid = x;
+}
+
+vector_t body_get_interp_centroid(body_t *body, double alpha) {
+    return vec_add(body->prev_centroid,
+                   vec_multiply(alpha, vec_subtract(body->centroid, body->prev_centroid)));
 }
 
 void body_set_velocity(body_t *body, vector_t v) {
@@ -133,36 +213,38 @@ void body_translate(body_t *body, vector_t diff) {
     polygon_translate(body->shape, diff);
 }
 
-void body_add_force(body_t *body, vector_t *force) {
-  list_add(body->forces, force);
+void body_add_force(body_t *body, vector_t force) {
+  vec_list_add(body->forces, force);
 }
 
-void body_add_impulse(body_t *body, vector_t *impulse) {
-  list_add(body->impulses, impulse);
+void body_add_impulse(body_t *body, vector_t impulse) {
+  vec_list_add(body->impulses, impulse);
 }
 
 void body_tick(body_t *body, double dt) {
     vector_t velocity = body->velocity;
     vector_t vel_new = body->velocity;
     // handle forces
-    for(size_t i = 0; i < list_size(body->forces); i++){
-      vector_t force = *(vector_t *)list_get(body->forces, i);
+    for(size_t i = 0; i < vec_list_size(body->forces); i++){
+      vector_t force = vec_list_get(body->forces, i);
       // f = ma
       vector_t accel = vec_multiply(1.0 / body->mass, force);
       vector_t dv = vec_multiply(dt, accel);
       vel_new = vec_add(vel_new, dv);
     }
     // handle impulses by just adding imp/mass
-    for(size_t i = 0; i < list_size(body->impulses); i++){
-      vel_new = vec_add(vel_new, vec_multiply(1 / body->mass, *(vector_t *)list_get(body->impulses, i)));
+    for(size_t i = 0; i < vec_list_size(body->impulses); i++){
+      vel_new = vec_add(vel_new, vec_multiply(1 / body->mass, vec_list_get(body->impulses, i)));
     }
     vector_t vel_avg = vec_multiply(AVG, vec_add(velocity, vel_new));
     vector_t trans = (vector_t)vec_multiply(dt, vel_avg);
     vector_t new_c = vec_add(body->centroid, trans);
+    vector_t prev = body->centroid;
     body_set_centroid(body, new_c);
+    body->prev_centroid = prev;
     body_set_velocity(body, vel_new);
-    list_clear(body->forces);
-    list_clear(body->impulses);
+    vec_list_clear(body->forces);
+    vec_list_clear(body->impulses);
 }
 
 void body_remove(body_t *body){
@@ -172,3 +254,26 @@ void body_remove(body_t *body){
 bool body_is_removed(body_t *body){
   return body->rem;
 }
+
+void body_link_force(body_t *body, void *force){
+  // made on first use (most map bodies never get a force); always on the heap
+  // since links come and go with every bullet
+  if(body->links == NULL){
+    body->links = list_init(NUM_LINKS, NULL);
+  }
+  list_add(body->links, force);
+}
+
+void body_unlink_force(body_t *body, void *force){
+  list_t *links = body->links;
+  for(size_t i = 0; links != NULL && i < list_size(links); i++){
+    if(list_get(links, i) == force){
+      list_swap_remove(links, i);
+      return;
+    }
+  }
+}
+
+list_t *body_get_links(body_t *body){
+  return body->links;
+}
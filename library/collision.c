@@ -1,14 +1,15 @@
 #include "collision.h"
+#include "counters.h"
 
-double *get_mins_and_maxes(list_t *inp){
+void get_mins_and_maxes(vec_list_t *inp, double *ans){
   // Index returned of 0 is min x, index 1 is max x, 2 is min y, 3 is max y
-  double *ans = malloc(4 * sizeof(double));
   double min_x, min_y, max_x, max_y;
   min_x = min_y = INFINITY;
   max_x = max_y = -INFINITY;
-  for(size_t i = 0; i < list_size(inp); i++){
-    double x = ((vector_t *)list_get(inp, i))->x;
-    double y = ((vector_t *)list_get(inp, i))->y;
+  vector_t *pts = vec_list_data(inp);
+  for(size_t i = 0; i < vec_list_size(inp); i++){
+    double x = pts[i].x;
+    double y = pts[i].y;
     if(x < min_x){
       min_x = x;
     } else if (x > max_x){
@@ -24,7 +25,6 @@ double *get_mins_and_maxes(list_t *inp){
   ans[1] = max_x;
   ans[2] = min_y;
   ans[3] = max_y;
-  return ans;
 }
 
 bool object_test_bounding_box(object_t *one, object_t *two){
@@ -38,100 +38,90 @@ bool object_test_bounding_box(object_t *one, object_t *two){
         return true;
     }
   }
+  counter_add(COUNTER_BBOX_REJECTS, 1);
   return false;
 }
 
-bool body_test_bounding_box(list_t *body_one, list_t *body_two){
+bool body_test_bounding_box(vec_list_t *body_one, vec_list_t *body_two){
   // Tests if two objects' bounding are within each other
-  double *temp1 = get_mins_and_maxes(body_one);
-  double *temp2 = get_mins_and_maxes(body_two);
+  double temp1[4];
+  double temp2[4];
+  get_mins_and_maxes(body_one, temp1);
+  get_mins_and_maxes(body_two, temp2);
   if((temp1[0] <= temp2[0] && temp2[0] <= temp1[1]) ||
     (temp2[0] <= temp1[0] && temp1[0] <= temp2[1])){
     if((temp1[2] <= temp2[2] && temp2[2] <= temp1[3]) ||
       (temp2[2] <= temp1[2] && temp1[2] <= temp2[3])){
-        free(temp1);
-        free(temp2);
         return true;
     }
   }
-  free(temp1);
-  free(temp2);
+  counter_add(COUNTER_BBOX_REJECTS, 1);
   return false;
 }
 
-// Helper method to get all perpendicular vectors to both shapes for the
-// separating axis method
-list_t *get_perp(list_t *shape1, list_t *shape2){
-  // Gets the perpendicular vectors for the separating axis method
-  list_t *all_perpendicular = list_init(list_size(shape1)+list_size(shape2), vec_free);
-  int counter = 0;
-  for(size_t i = 0; i < list_size(shape1); i++){
-    vector_t vec_one = (vector_t) {0, 0};
-    if(i != 0)
-      vec_one = vec_subtract(*(vector_t *) list_get(shape1, i), *(vector_t *) list_get(shape1, i-1));
-    else
-      vec_one = vec_subtract(*(vector_t *) list_get(shape1, 0), *(vector_t *) list_get(shape1, list_size(shape1)-1));
-    vector_t *perp = malloc(sizeof(vector_t));
-    *perp = (vector_t){-vec_one.y, vec_one.x};
-    double distance = pow(pow(vec_one.x, 2) + pow(vec_one.y, 2), 0.5);
-    if(distance != 0)
-      *perp = vec_multiply(1/distance, *perp);
-    list_add(all_perpendicular, perp);
-    counter++;
-  }
-  for(size_t i = 0; i < list_size(shape2); i++){
-    vector_t vec_two = (vector_t) {0, 0};
-    if(i != 0)
-      vec_two = vec_subtract(*(vector_t *)list_get(shape2, i),*(vector_t *)list_get(shape2, i-1));
-    else
-      vec_two = vec_subtract(*(vector_t *)list_get(shape2, 0),*(vector_t *)list_get(shape2, list_size(shape2)-1));
-    vector_t *perp = malloc(sizeof(vector_t));
-    *perp = (vector_t){-vec_two.y, vec_two.x};
-    double distance = pow(pow(vec_two.x, 2) + pow(vec_two.y, 2), 0.5);
+// Adds the unit normal of every edge of shape to axes.
+void add_edge_normals(vec_list_t *axes, vec_list_t *shape){
+  vector_t *pts = vec_list_data(shape);
+  size_t n = vec_list_size(shape);
+  for(size_t i = 0; i < n; i++){
+    vector_t edge = vec_subtract(pts[i], pts[i != 0 ? i-1 : n-1]);
+    vector_t perp = (vector_t){-edge.y, edge.x};
+    double distance = pow(pow(edge.x, 2) + pow(edge.y, 2), 0.5);
     if(distance != 0)
-      *perp = vec_multiply(1/distance, *perp);
-    list_add(all_perpendicular, perp);
+      perp = vec_multiply(1/distance, perp);
+    vec_list_add(axes, perp);
   }
+}
+
+// Helper method to get all perpendicular vectors to both shapes for the
+// separating axis method. Allocates from scratch if given, the heap otherwise.
+vec_list_t *get_perp(arena_t *scratch, vec_list_t *shape1, vec_list_t *shape2){
+  // Gets the perpendicular vectors for the separating axis method
+  size_t num_axes = vec_list_size(shape1) + vec_list_size(shape2);
+  vec_list_t *all_perpendicular = vec_list_init_in(scratch, num_axes);
+  add_edge_normals(all_perpendicular, shape1);
+  add_edge_normals(all_perpendicular, shape2);
   return all_perpendicular;
 }
 
 
-double get_max_scale(list_t *inp, vector_t *perp){
+double get_max_scale(vec_list_t *inp, vector_t *perp){
   // Index 0 is min scale, 1 is max scale (project inp onto perp)
   double max_scale = -INFINITY;
-  for(size_t j = 0; j < list_size(inp); j++){
-    vector_t *vec_one = (vector_t *) list_get(inp, j);
-    double scale = vec_dot(*vec_one, *perp);
+  vector_t *pts = vec_list_data(inp);
+  for(size_t j = 0; j < vec_list_size(inp); j++){
+    double scale = vec_dot(pts[j], *perp);
     if(scale > max_scale)
       max_scale = scale;
   }
   return max_scale;
 }
 
-double get_min_scale(list_t *inp, vector_t *perp){
+double get_min_scale(vec_list_t *inp, vector_t *perp){
   double min_scale = INFINITY;
-  for(size_t j = 0; j < list_size(inp); j++){
-    vector_t *vec_one = (vector_t *) list_get(inp, j);
-    double scale = vec_dot(*vec_one, *perp);
+  vector_t *pts = vec_list_data(inp);
+  for(size_t j = 0; j < vec_list_size(inp); j++){
+    double scale = vec_dot(pts[j], *perp);
     if(scale < min_scale)
       min_scale = scale;
   }
   return min_scale;
 }
 
-collision_info_t find_collision(list_t *shape1, list_t *shape2){
+collision_info_t find_collision(vec_list_t *shape1, vec_list_t *shape2){
   collision_info_t info;
   if(!body_test_bounding_box(shape1, shape2)){
     info.collided = false;
     return info;
   }
   else{
+    counter_add(COUNTER_SAT_TESTS, 1);
     double scale = INFINITY;
     vector_t axis = (vector_t) {0,0};
-    list_t *all_perpendicular = get_perp(shape1, shape2);
+    vec_list_t *all_perpendicular = get_perp(NULL, shape1, shape2);
     // Compare the points of each polygon to the unit vectors (get closest, farthest)
-    for(size_t i = 0; i < list_size(all_perpendicular); i++){
-      vector_t *side = (vector_t *) list_get(all_perpendicular, i);
+    for(size_t i = 0; i < vec_list_size(all_perpendicular); i++){
+      vector_t *side = vec_list_at(all_perpendicular, i);
       double magnitude = pow(pow(side->x, 2) + pow(side->y, 2), 0.5);
 
       double val1_min = get_min_scale(shape1, side);
@@ -140,7 +130,7 @@ collision_info_t find_collision(list_t *shape1, list_t *shape2){
       double val2_max = get_max_scale(shape2, side);
 
       if(!(val2_min < val1_max && val1_min < val2_max)){
-        list_free(all_perpendicular);
+        vec_list_free(all_perpendicular);
         info.collided = false;
         return info;
       } else { // all true cases
@@ -160,7 +150,7 @@ collision_info_t find_collision(list_t *shape1, list_t *shape2){
           }
       }
     }
-    list_free(all_perpendicular);
+    vec_list_free(all_perpendicular);
     info.collided = true;
     info.axis = axis;
   }
@@ -168,15 +158,16 @@ collision_info_t find_collision(list_t *shape1, list_t *shape2){
 }
 
 
-collision_info_t object_find_collision(list_t *shape1, list_t *shape2){
+collision_info_t object_find_collision(arena_t *scratch, vec_list_t *shape1, vec_list_t *shape2){
   // For objects only; skips bounding box calc
+  counter_add(COUNTER_SAT_TESTS, 1);
   collision_info_t info;
   double scale = INFINITY;
   vector_t axis = (vector_t) {0,0};
-  list_t *all_perpendicular = get_perp(shape1, shape2);
+  vec_list_t *all_perpendicular = get_perp(scratch, shape1, shape2);
   // Compare the points of each polygon to the unit vectors (get closest, farthest)
-  for(size_t i = 0; i < list_size(all_perpendicular); i++){
-    vector_t *side = (vector_t *) list_get(all_perpendicular, i);
+  for(size_t i = 0; i < vec_list_size(all_perpendicular); i++){
+    vector_t *side = vec_list_at(all_perpendicular, i);
     double magnitude = pow(pow(side->x, 2) + pow(side->y, 2), 0.5);
 
     double val1_min = get_min_scale(shape1, side);
@@ -185,7 +176,7 @@ collision_info_t object_find_collision(list_t *shape1, list_t *shape2){
     double val2_max = get_max_scale(shape2, side);
 
     if(!(val2_min < val1_max && val1_min < val2_max)){
-      list_free(all_perpendicular);
+      vec_list_free(all_perpendicular);
       info.collided = false;
       return info;
     } else { // all true cases
@@ -205,7 +196,7 @@ collision_info_t object_find_collision(list_t *shape1, list_t *shape2){
         }
     }
   }
-  list_free(all_perpendicular);
+  vec_list_free(all_perpendicular);
   info.collided = true;
   info.axis = axis;
   return info;
@@ -0,0 +1,98 @@
+#include "counters.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+const char *COUNTER_NAMES[NUM_COUNTERS] = {
+    [COUNTER_ASTAR_EXPANSIONS] = "astar_expansions",
+    [COUNTER_ASTAR_OPEN_PEAK] = "astar_open_peak",
+    [COUNTER_SAT_TESTS] = "sat_tests",
+    [COUNTER_BBOX_REJECTS] = "bbox_rejects",
+    [COUNTER_FORCES_RUN] = "forces_run",
+    [COUNTER_MALLOCS] = "mallocs",
+    [COUNTER_REALLOCS] = "reallocs",
+    [COUNTER_FREES] = "frees"};
+// Peaks are maxed rather than summed across frames.
+const bool COUNTER_IS_PEAK[NUM_COUNTERS] = {[COUNTER_ASTAR_OPEN_PEAK] = true};
+
+uint64_t counters_current[NUM_COUNTERS];
+uint64_t counters_last[NUM_COUNTERS];
+uint64_t counters_max[NUM_COUNTERS];
+uint64_t counters_total[NUM_COUNTERS];
+size_t counters_num_frames = 0;
+
+void counter_add(counter_id_t id, uint64_t amount) {
+    counters_current[id] += amount;
+}
+
+void counter_peak(counter_id_t id, uint64_t value) {
+    if (value > counters_current[id]) {
+        counters_current[id] = value;
+    }
+}
+
+void counters_frame(void) {
+    for (size_t i = 0; i < NUM_COUNTERS; i++) {
+        uint64_t value = counters_current[i];
+        counters_last[i] = value;
+        if (value > counters_max[i]) {
+            counters_max[i] = value;
+        }
+        if (COUNTER_IS_PEAK[i]) {
+            counters_total[i] = counters_max[i];
+        } else {
+            counters_total[i] += value;
+        }
+        counters_current[i] = 0;
+    }
+    counters_num_frames++;
+}
+
+void counters_reset(void) {
+    memset(counters_current, 0, sizeof(counters_current));
+    memset(counters_last, 0, sizeof(counters_last));
+    memset(counters_max, 0, sizeof(counters_max));
+    memset(counters_total, 0, sizeof(counters_total));
+    counters_num_frames = 0;
+}
+
+uint64_t counter_frame(counter_id_t id) {
+    assert(id < NUM_COUNTERS);
+    return counters_last[id];
+}
+
+uint64_t counter_frame_max(counter_id_t id) {
+    assert(id < NUM_COUNTERS);
+    return counters_max[id];
+}
+
+uint64_t counter_total(counter_id_t id) {
+    assert(id < NUM_COUNTERS);
+    return counters_total[id];
+}
+
+size_t counters_frames(void) {
+    return counters_num_frames;
+}
+
+const char *counter_name(counter_id_t id) {
+    assert(id < NUM_COUNTERS);
+    return COUNTER_NAMES[id];
+}
+
+void counters_print(FILE *file) {
+    fprintf(file, "%-18s %14s %12s %10s %10s\n", "counter", "total",
+            "per frame", "max", "last");
+    for (size_t i = 0; i < NUM_COUNTERS; i++) {
+        // a mean of peaks says little, so peaks leave that column blank
+        char mean[32] = "-";
+        if (counters_num_frames > 0 && !COUNTER_IS_PEAK[i]) {
+            snprintf(mean, sizeof(mean), "%.1f",
+                     (double)counters_total[i] / counters_num_frames);
+        }
+        fprintf(file, "%-18s %14llu %12s %10llu %10llu\n", COUNTER_NAMES[i],
+                (unsigned long long)counters_total[i], mean,
+                (unsigned long long)counters_max[i],
+                (unsigned long long)counters_last[i]);
+    }
+}
@@ -77,12 +77,8 @@ void gravity(void *aux){
     grav_magnitude = G * body_get_mass(body_1) * body_get_mass(body_2) / pow(distance, 2);
   }
   diff = vec_multiply(grav_magnitude, diff);
-  vector_t *gravity = malloc(sizeof(vector_t));
-  *gravity = diff;
-  vector_t *neg_gravity = malloc(sizeof(vector_t));
-  *neg_gravity = vec_negate(*gravity);
-  body_add_force(body_1, gravity);
-  body_add_force(body_2, neg_gravity);
+  body_add_force(body_1, diff);
+  body_add_force(body_2, vec_negate(diff));
 }
 
 void create_newtonian_gravity(scene_t *scene, double G, body_t *body1, body_t *body2) {
@@ -101,12 +97,9 @@ void spring(void *aux){
   vector_t b2 = body_get_centroid(body_2);
   double k = data->constant;
   // Positive if b1 is higher than b2
-  vector_t *force_on_one = malloc(sizeof(vector_t));
-  *force_on_one = (vector_t){-k*(b1.x - b2.x), -k*(b1.y - b2.y)};
-  vector_t *force_on_two = malloc(sizeof(vector_t));
-  *force_on_two = vec_negate(*force_on_one);
+  vector_t force_on_one = (vector_t){-k*(b1.x - b2.x), -k*(b1.y - b2.y)};
   body_add_force(body_1, force_on_one);
-  body_add_force(body_2, force_on_two);
+  body_add_force(body_2, vec_negate(force_on_one));
 }
 
 void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
@@ -123,9 +116,7 @@ void drag(void *aux) {
   body_t *body = (body_t *)list_get(data->bodies, 0);
   double gamma = data->constant;
   vector_t velocity = body_get_velocity(body);
-  vector_t *force = malloc(sizeof(vector_t));
-  *force = vec_multiply(gamma, vec_negate(velocity));
-  body_add_force(body, force);
+  body_add_force(body, vec_multiply(gamma, vec_negate(velocity)));
 }
 
 void drag_fade(void *aux) {
@@ -140,9 +131,7 @@ void drag_fade(void *aux) {
   body_t *body = (body_t *)list_get(data->bodies, 0);
   double gamma = data->constant;
   vector_t velocity = body_get_velocity(body);
-  vector_t *force = malloc(sizeof(vector_t));
-  *force = vec_multiply(gamma, vec_negate(velocity));
-  body_add_force(body, force);
+  body_add_force(body, vec_multiply(gamma, vec_negate(velocity)));
 }
 
 void create_drag(scene_t *scene, double gamma, body_t *body, int id) {
@@ -163,11 +152,7 @@ void collision(void *aux){
   collision_handler_t func = data->handler;
   body_t *body1 = (body_t *) list_get(data->bodies, 0);
   body_t *body2 = (body_t *) list_get(data->bodies, 1);
-  list_t *pts1 = body_get_shape(body1);
-  list_t *pts2 = body_get_shape(body2);
-  collision_info_t coll = find_collision(pts1, pts2);
-  list_free(pts1);
-  list_free(pts2);
+  collision_info_t coll = find_collision(body_get_points(body1), body_get_points(body2));
   if(coll.collided){
     if(data->collided == false){
       data->collided = true;
@@ -235,12 +220,9 @@ void impulse(body_t *body1, body_t *body2, vector_t axis, void *aux){
   else if(mass2 != INFINITY){
     reduced_mass = mass2;
   }
-  vector_t *imp = malloc(sizeof(vector_t));
-  *imp = vec_multiply(reduced_mass* (1.0 + elas) * (u2 - u1), axis);
-  vector_t *neg_imp = malloc(sizeof(vector_t));
-  *neg_imp = vec_negate(*imp);
+  vector_t imp = vec_multiply(reduced_mass* (1.0 + elas) * (u2 - u1), axis);
   body_add_impulse(body1, imp);
-  body_add_impulse(body2, neg_imp);
+  body_add_impulse(body2, vec_negate(imp));
 }
 
 void destroy_brick(body_t *body1, body_t *body2, vector_t axis, void *aux){
@@ -264,12 +246,10 @@ void destroy_brick(body_t *body1, body_t *body2, vector_t axis, void *aux){
   else if(mass2 != INFINITY){
     reduced_mass = mass2;
   }
-  vector_t *imp = malloc(sizeof(vector_t));
-  *imp = vec_multiply(reduced_mass* (1.0 + elas) * (u2 - u1), axis);
+  vector_t imp = vec_multiply(reduced_mass* (1.0 + elas) * (u2 - u1), axis);
   if(strcmp((char *)body_get_info(body1), "brick") == 0){
     body_remove(body1);
-    *imp = vec_negate(*imp);
-    body_add_impulse(body2, imp);
+    body_add_impulse(body2, vec_negate(imp));
   }
   else if (strcmp((char *)body_get_info(body2), "brick") == 0){
     body_remove(body2);
@@ -298,12 +278,10 @@ void bullet_explosive(body_t *body1, body_t *body2, vector_t axis, void *aux){
   else if(mass2 != INFINITY){
     reduced_mass = mass2;
   }
-  vector_t *imp = malloc(sizeof(vector_t));
-  *imp = vec_multiply(reduced_mass* (1.0 + elas) * (u2 - u1), axis);
+  vector_t imp = vec_multiply(reduced_mass* (1.0 + elas) * (u2 - u1), axis);
   if(strcmp((char *)body_get_info(body1), "e") == 0){
     body_remove(body1);
-    *imp = vec_negate(*imp);
-    body_add_impulse(body2, imp);
+    body_add_impulse(body2, vec_negate(imp));
   }
   else if (strcmp((char *)body_get_info(body2), "e") == 0){
     body_remove(body2);
@@ -0,0 +1,225 @@
+#include "game_render.h"
+#include "profiler.h"
+#include "sdl_wrapper.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Colors of the grid cells in the zoomed out map and the minimap, and
+// how wide the minimap is.
+const rgb_color_t CELL_COLORS[] = {
+    [CELL_WALL] = {120, 120, 120},
+    [CELL_DOOR] = {150, 90, 40},
+    [CELL_LOCKER] = {60, 100, 200},
+    [CELL_DUMPSTER] = {40, 140, 60}};
+const rgb_color_t CELL_COIN = {240, 200, 30};
+const int MINIMAP_SIZE = 150;
+// where the profiler overlay goes (make PROFILE=1), below the HUD text
+const int PROFILE_OVERLAY_Y = 80;
+
+typedef struct game_render {
+    map_t *map;
+    // the last background_version drawn
+    uint32_t background_version;
+    // coins per cell as last given to sdl_set_cell_color()
+    unsigned char *cell_coins;
+} game_render_t;
+
+// Linear interpolation from prev (alpha 0) to current (alpha 1).
+vector_t interpolate(vector_t prev, vector_t current, double alpha) {
+    return vec_add(prev, vec_multiply(alpha, vec_subtract(current, prev)));
+}
+
+// Colors one cell of the zoomed out map: a coin over whatever is there.
+void color_cell(map_t *map, int r, int c, int coins) {
+    cell_kind_t kind = map_cell_kind(map, r, c);
+    if (coins > 0) {
+        sdl_set_cell_color(r, c, CELL_COIN);
+    } else if (kind == CELL_WALL || kind == CELL_DOOR || kind == CELL_LOCKER ||
+               kind == CELL_DUMPSTER) {
+        sdl_set_cell_color(r, c, CELL_COLORS[kind]);
+    } else {
+        sdl_clear_cell(r, c);
+    }
+}
+
+// Recolors the cells whose coins changed since the last snapshot drawn.
+void cells_update(game_render_t *render, snapshot_t *snapshot) {
+    size_t cells = (size_t)snapshot->rows * snapshot->cols;
+    if (memcmp(render->cell_coins, snapshot->coins, cells) == 0) {
+        return;
+    }
+    for (int r = 0; r < snapshot->rows; r++) {
+        for (int c = 0; c < snapshot->cols; c++) {
+            int coins = snapshot_coins_at(snapshot, r, c);
+            if (render->cell_coins[r * snapshot->cols + c] != coins) {
+                render->cell_coins[r * snapshot->cols + c] = coins;
+                color_cell(render->map, r, c, coins);
+            }
+        }
+    }
+}
+
+// Renders the images for one kind of grid cell, looking only at the cells
+// in view, so the cost follows the window rather than the map.
+void image_cells(map_t *map, cell_range_t view, cell_kind_t kind,
+                 void (*render)(vector_t location)) {
+    for (int r = view.row_min; r <= view.row_max; r++) {
+        for (int c = view.col_min; c <= view.col_max; c++) {
+            if (map_cell_kind(map, r, c) == kind) {
+                render(map_pos_from_ind(map, r, c));
+            }
+        }
+    }
+}
+
+// Renders images for coins, as of the snapshot.
+void image_coins(map_t *map, snapshot_t *snapshot, cell_range_t view) {
+    for (int r = view.row_min; r <= view.row_max; r++) {
+        for (int c = view.col_min; c <= view.col_max; c++) {
+            if (snapshot_coins_at(snapshot, r, c) > 0) {
+                render_coin_image(map_pos_from_ind(map, r, c));
+            }
+        }
+    }
+}
+
+// Draws the images that never move (see sdl_set_background()) between min
+// and max: hiding spots, then walls, then doors.
+void draw_background(vector_t min, vector_t max, void *aux) {
+    map_t *map = aux;
+    cell_range_t cells = map_cell_range(map, min, max);
+    image_cells(map, cells, CELL_LOCKER, render_locker_image);
+    image_cells(map, cells, CELL_DUMPSTER, render_dumpster_image);
+    image_cells(map, cells, CELL_WALL, render_wall_image);
+    image_cells(map, cells, CELL_DOOR, render_door_image);
+}
+
+// Marks the parts of the background that changed since the last snapshot
+// drawn, including in any snapshots that were skipped.
+void background_changed(game_render_t *render, snapshot_t *snapshot,
+                        vector_t view_min, vector_t view_max) {
+    snapshot_change_list_t *changes = snapshot->background_changes;
+    size_t count = snapshot_change_list_size(changes);
+    if (count == 0 ||
+        snapshot_change_list_at(changes, 0)->version > render->background_version + 1) {
+        // fell behind the log, so redraw all of the cache (which reaches
+        // past the view by less than the view's size)
+        vector_t size = vec_subtract(view_max, view_min);
+        sdl_background_invalidate(vec_subtract(view_min, size), vec_add(view_max, size));
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        snapshot_change_t *change = snapshot_change_list_at(changes, i);
+        if (change->version > render->background_version) {
+            sdl_background_invalidate(change->min, change->max);
+        }
+    }
+}
+
+// Draws the images and HUD for a frame from a snapshot, alpha of the way
+// from its previous step to its latest one.
+void render_images(game_render_t *render, snapshot_t *snapshot, double alpha) {
+    PROFILE_ZONE("render_images");
+    if (snapshot->money >= 0) {
+        update_money(snapshot->money);
+    }
+    if (snapshot->stamina >= 0) {
+        update_stamina(snapshot->stamina);
+    }
+    if (snapshot->bullets >= 0) {
+        update_bullets(snapshot->bullets);
+    }
+    vector_t view_min, view_max;
+    sdl_get_view(&view_min, &view_max);
+    if (snapshot->background_version != render->background_version) {
+        background_changed(render, snapshot, view_min, view_max);
+        render->background_version = snapshot->background_version;
+    }
+    cells_update(render, snapshot);
+    if (sdl_cells_coarse()) {
+        // cells are a few pixels across, so draw each as one pixel
+        sdl_render_cells();
+    } else {
+        sdl_render_background();
+        image_coins(render->map, snapshot, map_cell_range(render->map, view_min, view_max));
+    }
+    render_player_image(snapshot->player_angle);
+    render_alien_image(interpolate(snapshot->alien_prev, snapshot->alien, alpha));
+    render_text(0, 0);
+}
+
+// Draws the bodies that aren't images from a snapshot, skipping those whose
+// centroid is out of view.
+void render_polygons(snapshot_t *snapshot, double alpha) {
+    PROFILE_ZONE("render_polygons");
+    vector_t view_min, view_max;
+    sdl_get_view(&view_min, &view_max);
+    vector_t *points = vec_list_data(snapshot->points);
+    size_t count = snapshot_polygon_list_size(snapshot->polygons);
+    for (size_t i = 0; i < count; i++) {
+        snapshot_polygon_t *polygon = snapshot_polygon_list_at(snapshot->polygons, i);
+        vector_t centroid = polygon->centroid;
+        if (centroid.x >= view_min.x && centroid.x <= view_max.x &&
+            centroid.y >= view_min.y && centroid.y <= view_max.y) {
+            // the points are where the body is now; move them back to where
+            // it was alpha of the way through the last step
+            vector_t offset = vec_subtract(
+                interpolate(polygon->prev_centroid, centroid, alpha), centroid);
+            sdl_draw_points(points + polygon->first, polygon->count, offset,
+                            polygon->color);
+        }
+    }
+}
+
+// Shows the profiler's per-zone frame times, when built with it.
+void render_profile(void) {
+#ifdef PROFILE
+    char text[2048];
+    prof_overlay_text(text, sizeof(text));
+    render_overlay(text, 0, PROFILE_OVERLAY_Y);
+#endif
+}
+
+game_render_t *game_render_init(map_t *map) {
+    game_render_t *render = malloc(sizeof(game_render_t));
+    assert(render != NULL);
+    render->map = map;
+    render->background_version = 0;
+    sdl_set_background(draw_background, map);
+    int rows = map_rows(map);
+    int cols = map_cols(map);
+    sdl_set_cell_grid(rows, cols, map_cell_size(map));
+    render->cell_coins = malloc((size_t)rows * cols);
+    assert(render->cell_coins != NULL);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            render->cell_coins[r * cols + c] = map_coins_at(map, r, c);
+            color_cell(map, r, c, render->cell_coins[r * cols + c]);
+        }
+    }
+    return render;
+}
+
+void game_render_free(game_render_t *render) {
+    free(render->cell_coins);
+    free(render);
+}
+
+void game_render_frame(game_render_t *render, snapshot_t *snapshot, double alpha) {
+    PROFILE_ZONE("render_frame");
+    sdl_update_center(interpolate(snapshot->player_prev, snapshot->player, alpha));
+    sdl_clear();
+    if (snapshot->lost) {
+        lose_message();
+    } else if (snapshot->won) {
+        win_message();
+    } else {
+        render_images(render, snapshot, alpha);
+        render_profile();
+    }
+    render_polygons(snapshot, alpha);
+    if (!sdl_cells_coarse()) {
+        sdl_render_minimap(MINIMAP_SIZE);
+    }
+}
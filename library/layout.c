@@ -0,0 +1,149 @@
+#include "layout.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const char LAYOUT_WALL_CHAR = '#';
+const char LAYOUT_FLOOR_CHAR = '.';
+
+// Reads a whole file into a '\0'-terminated buffer, or returns NULL.
+char *layout_read_file(const char *path, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return NULL;
+    }
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        length = ftell(file);
+    }
+    if (length < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        perror(path);
+        fclose(file);
+        return NULL;
+    }
+    char *text = malloc(length + 1);
+    assert(text != NULL);
+    *size = fread(text, 1, length, file);
+    fclose(file);
+    text[*size] = '\0';
+    return text;
+}
+
+// Moves past any spaces at *pos, returning whether a number follows them.
+bool layout_skip_spaces(const char *text, size_t *pos) {
+    while (text[*pos] == ' ' || text[*pos] == '\t') {
+        (*pos)++;
+    }
+    return '0' <= text[*pos] && text[*pos] <= '9';
+}
+
+// Reads a positive number at *pos, moving past it and any spaces before it.
+int layout_read_dimension(const char *text, size_t *pos) {
+    layout_skip_spaces(text, pos);
+    long value = 0;
+    size_t start = *pos;
+    while ('0' <= text[*pos] && text[*pos] <= '9' && value <= INT_MAX) {
+        value = value * 10 + (text[*pos] - '0');
+        (*pos)++;
+    }
+    return *pos > start && 0 < value && value <= INT_MAX ? (int)value : -1;
+}
+
+// Moves past the end of a line ("\n" or "\r\n"), returning whether there was
+// one. The end of the file counts as one only if at_end is allowed.
+bool layout_read_newline(const char *text, size_t size, size_t *pos, bool at_end) {
+    if (*pos == size) {
+        return at_end;
+    }
+    if (text[*pos] == '\r') {
+        (*pos)++;
+    }
+    if (text[*pos] != '\n') {
+        return false;
+    }
+    (*pos)++;
+    return true;
+}
+
+layout_t *layout_load(const char *path) {
+    size_t size;
+    char *text = layout_read_file(path, &size);
+    if (text == NULL) {
+        return NULL;
+    }
+    size_t pos = 0;
+    int rows = layout_read_dimension(text, &pos);
+    int cols = layout_read_dimension(text, &pos);
+    int cell_size =
+        layout_skip_spaces(text, &pos) ? layout_read_dimension(text, &pos) : 0;
+    if (rows < 0 || cols < 0 || cell_size < 0 || rows > INT_MAX / cols ||
+        !layout_read_newline(text, size, &pos, false)) {
+        fprintf(stderr, "%s:1: expected the number of rows and columns\n", path);
+        free(text);
+        return NULL;
+    }
+    layout_t *layout = layout_init(rows, cols);
+    layout->cell_size = cell_size;
+    for (int r = 0; r < rows; r++) {
+        // the file lists rows top to bottom, but row 0 is the bottom one
+        unsigned char *cell = layout->cells + (size_t)(rows - 1 - r) * cols;
+        // a short line ends at its '\n' or the '\0' after the text
+        for (int c = 0; c < cols; c++, pos++) {
+            if (text[pos] == LAYOUT_WALL_CHAR) {
+                *cell++ = LAYOUT_WALL;
+            } else if (text[pos] == LAYOUT_FLOOR_CHAR) {
+                *cell++ = LAYOUT_FLOOR;
+            } else {
+                fprintf(stderr, "%s:%d: expected %d cells of '%c' or '%c'\n",
+                        path, r + 2, cols, LAYOUT_WALL_CHAR, LAYOUT_FLOOR_CHAR);
+                layout_free(layout);
+                free(text);
+                return NULL;
+            }
+        }
+        if (!layout_read_newline(text, size, &pos, r == rows - 1)) {
+            fprintf(stderr, "%s:%d: row is longer than %d cells\n", path, r + 2,
+                    cols);
+            layout_free(layout);
+            free(text);
+            return NULL;
+        }
+    }
+    if (pos != size) {
+        fprintf(stderr, "%s:%d: expected only %d rows\n", path, rows + 2, rows);
+        layout_free(layout);
+        free(text);
+        return NULL;
+    }
+    free(text);
+    return layout;
+}
+
+layout_t *layout_init(int rows, int cols) {
+    assert(rows > 0 && cols > 0);
+    layout_t *layout = malloc(sizeof(layout_t));
+    assert(layout != NULL);
+    layout->rows = rows;
+    layout->cols = cols;
+    layout->cell_size = 0;
+    layout->cells = calloc((size_t)rows * cols, 1);
+    assert(layout->cells != NULL);
+    return layout;
+}
+
+void layout_free(layout_t *layout) {
+    free(layout->cells);
+    free(layout);
+}
+
+bool layout_is_wall(layout_t *layout, int r, int c) {
+    assert(0 <= r && r < layout->rows && 0 <= c && c < layout->cols);
+    return layout->cells[(size_t)r * layout->cols + c] == LAYOUT_WALL;
+}
+
+void layout_set_wall(layout_t *layout, int r, int c, bool wall) {
+    assert(0 <= r && r < layout->rows && 0 <= c && c < layout->cols);
+    layout->cells[(size_t)r * layout->cols + c] = wall ? LAYOUT_WALL : LAYOUT_FLOOR;
+}
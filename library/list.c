@@ -3,6 +3,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Size increase of list when no space left to add into.
 const int GROWTH_RATE = 2;
@@ -12,25 +13,65 @@ typedef struct list {
     size_t capacity;
     size_t size;
     free_func_t freer;
+    arena_t *arena;
+    // Deque lists wrap around the end of data starting at head.
+    // Plain lists always keep head at 0.
+    size_t head;
+    bool deque;
 } list_t;
 
 list_t *list_init(size_t initial_size, free_func_t freer) {
-    list_t *v = malloc(sizeof(list_t));
-    assert(v != NULL);
-    v->data = malloc(initial_size * sizeof(void *));
+    return list_init_in(NULL, initial_size, freer);
+}
+
+list_t *list_init_in(arena_t *arena, size_t initial_size, free_func_t freer) {
+    list_t *v;
+    if (arena != NULL) {
+        v = arena_alloc(arena, sizeof(list_t));
+        v->data = arena_alloc(arena, initial_size * sizeof(void *));
+    } else {
+        v = malloc(sizeof(list_t));
+        assert(v != NULL);
+        v->data = malloc(initial_size * sizeof(void *));
+    }
     assert(v->data != NULL);
     v->capacity = initial_size;
     v->size = 0;
     v->freer = freer;
+    v->arena = arena;
+    v->head = 0;
+    v->deque = false;
+    return v;
+}
+
+list_t *list_init_deque(size_t initial_size, free_func_t freer) {
+    list_t *v = list_init(initial_size, freer);
+    v->deque = true;
     return v;
 }
 
+// Position in data of the element at index.
+size_t list_slot(list_t *list, size_t index) {
+    size_t slot = list->head + index;
+    return slot < list->capacity ? slot : slot - list->capacity;
+}
+
+// Calls the freer (if any) on every element, in order.
+void free_elements(list_t *list) {
+    if (list->freer == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < list->size; i++) {
+        list->freer(list->data[list_slot(list, i)]);
+    }
+}
+
 // Checks if freer is NULL as well and does not try to free objects.
+// Arena lists only release their elements; the arena owns the rest.
 void list_free(void *list) {
-    if(((list_t *)list)->freer != NULL){
-      for (size_t i = 0; i < list_size(list); i++) {
-          ((list_t *)list)->freer(list_get(list, i));
-      }
+    free_elements(list);
+    if(((list_t *)list)->arena != NULL){
+      return;
     }
     free(((list_t *)list)->data);
     free(list);
@@ -46,18 +87,45 @@ size_t list_capacity(list_t *list) {
 
 void *list_get(list_t *list, size_t index) {
     assert(index < list->size && index >= 0);
-    void *item = list->data[index];
+    void *item = list->data[list_slot(list, index)];
     return item;
 }
 
-void resize(list_t *list) {
-    void **new_data = malloc(GROWTH_RATE * list->capacity * sizeof(void *));
-    for (size_t i = 0; i < list->size; i++) {
-        new_data[i] = list_get(list, i);
+// Moves the elements into a new array of the given capacity, unwrapping a
+// deque so that head is 0 again.
+void relocate(list_t *list, size_t capacity) {
+    void **new_data;
+    if (list->arena != NULL) {
+        // Old array stays in the arena until it is reset.
+        new_data = arena_alloc(list->arena, capacity * sizeof(void *));
+    } else {
+        new_data = malloc(capacity * sizeof(void *));
+        assert(new_data != NULL);
+    }
+    size_t first = list->capacity - list->head;
+    if (first >= list->size) {
+        memcpy(new_data, list->data + list->head, list->size * sizeof(void *));
+    } else {
+        memcpy(new_data, list->data + list->head, first * sizeof(void *));
+        memcpy(new_data + first, list->data, (list->size - first) * sizeof(void *));
+    }
+    if (list->arena == NULL) {
+        free(list->data);
     }
-    free(list->data);
     list->data = new_data;
-    list->capacity *= GROWTH_RATE;
+    list->capacity = capacity;
+    list->head = 0;
+}
+
+void resize(list_t *list) {
+    size_t capacity = GROWTH_RATE * list->capacity;
+    relocate(list, capacity > 0 ? capacity : 1);
+}
+
+void list_reserve(list_t *list, size_t capacity) {
+    if (capacity > list->capacity) {
+        relocate(list, capacity);
+    }
 }
 
 void list_add(list_t *list, void *value) {
@@ -65,46 +133,79 @@ void list_add(list_t *list, void *value) {
     if (list->size >= list->capacity) {
         resize(list);
     }
-    int next_ind = list->size;
-    list->data[next_ind] = value;
+    list->data[list_slot(list, list->size)] = value;
     list->size++;
 }
 
 // Helper method to collapse list down given index to start from (of rem. item).
+// Expects the list to be unwrapped (head of 0).
 void collapse(list_t *list, size_t ind) {
-    for (size_t i = ind; i < list->size - 1; i++) {
-        list->data[i] = list_get(list, i + 1);
-    }
+    memmove(list->data + ind, list->data + ind + 1,
+            (list->size - ind - 1) * sizeof(void *));
     list->data[list->size - 1] = (void *)NULL;
 }
 
 void *list_remove(list_t *list, size_t ind) {
-    assert(ind >= 0);
-    assert(ind < list_capacity(list));
+    assert(ind < list->size);
+    if (ind == 0 && list->deque) {
+        return list_pop_front(list);
+    }
+    if (list->head != 0) {
+        relocate(list, list->capacity);
+    }
     void *temp = list->data[ind];
     collapse(list, ind);
     list->size--;
     return temp;
 }
 
-void list_clear(list_t *list){
-  if(((list_t *)list)->freer != NULL){
-    while(list_size(list) > 0){
-      list->freer(list_remove(list, 0));
+void *list_pop_front(list_t *list) {
+    assert(list->size > 0);
+    if (!list->deque) {
+        return list_remove(list, 0);
     }
-  }
-  else{
-    while(list_size(list) > 0){
-      list_remove(list, 0);
+    void *temp = list->data[list->head];
+    list->data[list->head] = NULL;
+    list->head = list_slot(list, 1);
+    list->size--;
+    if (list->size == 0) {
+        list->head = 0;
     }
-  }
+    return temp;
+}
+
+void *list_swap_remove(list_t *list, size_t ind) {
+    assert(ind < list->size);
+    size_t slot = list_slot(list, ind);
+    size_t last = list_slot(list, list->size - 1);
+    void *temp = list->data[slot];
+    list->data[slot] = list->data[last];
+    list->data[last] = NULL;
+    list->size--;
+    return temp;
+}
+
+void list_truncate(list_t *list, size_t size) {
+    assert(size <= list->size);
+    list->size = size;
+    if (size == 0) {
+        list->head = 0;
+    }
+}
+
+// One pass over the elements, rather than removing from the front each time.
+void list_clear(list_t *list){
+  free_elements(list);
+  list->size = 0;
+  list->head = 0;
 }
 
 void *list_replace(list_t *list, size_t ind, void *new_item){
   assert(ind >= 0);
   assert(ind < list_capacity(list));
-  void *temp = list->data[ind];
-  list->data[ind] = new_item;
+  size_t slot = list_slot(list, ind);
+  void *temp = list->data[slot];
+  list->data[slot] = new_item;
   return temp;
 }
 
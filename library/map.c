@@ -1,9 +1,7 @@
 #include "map.h"
+#include "layout.h"
+#include "profiler.h"
 
-// actual size is just height and width * GRID_SIZE (for basic box)
-const int HEIGHT = 100;
-const int WIDTH = 100;
-const int NUM_WALLS = 2 * HEIGHT * WIDTH; // we know, not actual #. just for list size init
 const int NUM_COINS = 100;
 // Do not change
 const int NUM_DOORS = 2;
@@ -11,11 +9,15 @@ const int NUM_DOORS = 2;
 const int NUM_HIDING_SPOTS = 40;
 const int START_MONEY = 0;
 const int NUM_RECT = 4;
-// this is side length for square grid, equiv to spot in the backing array
+// this is side length for square grid, equiv to spot in the backing array,
+// unless the map file gives its own. players and coins are sized off of it
 const int GRID_SIZE = 10;
+// the town, loaded by map_init() and map_init_seeded()
+const char *MAP_FILE = "maps/town.map";
+// chunk sizes for the map-lifetime arena and the per-frame scratch arena
+const size_t MAP_ARENA_CHUNK = 1 << 22;
+const size_t SCRATCH_ARENA_CHUNK = 1 << 20;
 const double MASS = 0;
-bool HIDING = false;
-object_t *CURR_SPOT;
 
 /////// consts for making bodies here
 const char *PLAYER = "player";
@@ -24,14 +26,16 @@ const char *COIN = "coin";
 const char *NODE = "node";
 const char *WALL = "wall";
 const char *DOOR = "door";
-const double R_PLAYER_ALIEN = GRID_SIZE / 2.5;
+// player and alien radius, as a fraction of map->cell_size
+const double R_PLAYER_ALIEN = 0.4;
 const int RECT_SIDES = 4;
 const double RADIUS_SCALE = 2.0;
 const double ANGLE_SCALE = RADIUS_SCALE;
 const double M_ALIEN = 1; // need for weapon elas...also add in bullets at some point
 const double M_PLAYER = 1; // need to reflect off items?
 const double R_VISIBLE = 1000;
-const double R_COIN = GRID_SIZE / 6;
+// half the side of a coin, as a fraction of map->cell_size
+const double R_COIN = 0.1;
 const int V_COIN = 100;
 // const int V_DOOR = 4000;
 const int V_DOOR = 2000;
@@ -63,8 +67,8 @@ const char *HIDING_TYPES[] = {
 const int NUM_HIDING_TYPES = 2; // update if you change!!
 const rgb_color_t C_HIDING_SPOTS[] = {{0,191,255}, {139,69,19}}; // change this too! should be in order
 
-node_t *node_init(object_t *node, double priority){
-  node_t *ans = malloc(sizeof(node_t));
+node_t *node_init_in(arena_t *arena, object_t *node, double priority){
+  node_t *ans = arena_alloc(arena, sizeof(node_t));
   ans->node = node;
   ans->priority = priority;
   ans->num_neighbors = 0;
@@ -74,10 +78,6 @@ node_t *node_init(object_t *node, double priority){
   return ans;
 }
 
-void node_free(void *node){
-  free(((node_t *)node));
-}
-
 ///////// some methods to make backing array easier to access--could abstract this out if wanted?//////////////
 vector_t arr_size(list_t *arr){
   vector_t size;
@@ -96,6 +96,14 @@ list_t *arr_init(int height, int width, free_func_t freer){
   return ans;
 }
 
+list_t *arr_init_in(arena_t *arena, int height, int width){
+  list_t *ans = list_init_in(arena, height, NULL);
+  for(size_t i = 0; i < height; i++){
+    list_add(ans, list_init_in(arena, width, NULL));
+  }
+  return ans;
+}
+
 void arr_free(list_t *arr){
   list_free(arr);
 }
@@ -116,15 +124,72 @@ void *arr_put(list_t *arr, int r, int c, void *new_obj){
 // return the center of the square rep by given index
 vector_t map_pos_from_ind(map_t *map, int r, int c){
   vector_t center;
-  center.x = (GRID_SIZE / 2.0) + (c * GRID_SIZE);
-  center.y = (GRID_SIZE / 2.0) + (r * GRID_SIZE);
+  center.x = (map->cell_size / 2.0) + (c * map->cell_size);
+  center.y = (map->cell_size / 2.0) + (r * map->cell_size);
   return center;
 }
 
 // position given in x,y where 0,0 is top left, 0, width is top right
 // returns in row, col
 vector_t map_ind_from_pos(map_t *map, vector_t position){
-  return (vector_t){(int) position.y/(10), (int) position.x/(10)};
+  return (vector_t){(int)(position.y / map->cell_size), (int)(position.x / map->cell_size)};
+}
+
+cell_range_t map_cell_range(map_t *map, vector_t min, vector_t max){
+  cell_range_t range;
+  range.row_min = (int)floor(min.y / map->cell_size);
+  range.row_max = (int)floor(max.y / map->cell_size);
+  range.col_min = (int)floor(min.x / map->cell_size);
+  range.col_max = (int)floor(max.x / map->cell_size);
+  range.row_min = range.row_min < 0 ? 0 : range.row_min;
+  range.col_min = range.col_min < 0 ? 0 : range.col_min;
+  range.row_max = range.row_max > map->rows - 1 ? map->rows - 1 : range.row_max;
+  range.col_max = range.col_max > map->cols - 1 ? map->cols - 1 : range.col_max;
+  return range;
+}
+
+cell_kind_t map_cell_kind(map_t *map, int r, int c){
+  return map->cell_kinds[(size_t)r * map->cols + c];
+}
+
+int map_coins_at(map_t *map, int r, int c){
+  return map->coin_counts[(size_t)r * map->cols + c];
+}
+
+int map_rows(map_t *map){
+  return map->rows;
+}
+
+int map_cols(map_t *map){
+  return map->cols;
+}
+
+double map_cell_size(map_t *map){
+  return map->cell_size;
+}
+
+vector_t map_extent(map_t *map){
+  return (vector_t){map->cols * map->cell_size, map->rows * map->cell_size};
+}
+
+// The kind of cell an object in the backing array makes.
+cell_kind_t cell_kind_of(object_t *o){
+  if(strcmp(o->type, NODE) == 0){
+    return CELL_NODE;
+  }
+  else if(strcmp(o->type, WALL) == 0){
+    return CELL_WALL;
+  }
+  else if(strcmp(o->type, DOOR) == 0){
+    return CELL_DOOR;
+  }
+  else if(strcmp(o->type, "locker") == 0){
+    return CELL_LOCKER;
+  }
+  else if(strcmp(o->type, "dumpster") == 0){
+    return CELL_DUMPSTER;
+  }
+  return CELL_OTHER;
 }
 
 // helper.
@@ -136,11 +201,12 @@ double shortest_dist(vector_t src, vector_t dest, vector_t obstacle){
 
 //////////////////////////////////////////////////
 // check if hiding spot is in straight line btwn src, dest.
-bool hiding_in_vec(vector_t src, vector_t dest, list_t *hiding){
+bool hiding_in_vec(map_t *map, vector_t src, vector_t dest, list_t *hiding){
+  double radius = R_PLAYER_ALIEN * map->cell_size;
   for(size_t i = 0; i < list_size(hiding); i++){
     object_t *hide = (object_t *) list_get(hiding, i);
     vector_t centroid = body_get_centroid(hide->body);
-    if(shortest_dist(src, dest, centroid) < R_PLAYER_ALIEN){
+    if(shortest_dist(src, dest, centroid) < radius){
       return true;
     }
   }
@@ -149,8 +215,8 @@ bool hiding_in_vec(vector_t src, vector_t dest, list_t *hiding){
 
 void make_node_neighbors(map_t *map, int row, int col){
   node_t *struct_node = (node_t *)arr_get(map->struct_nodes, row, col);
-  double straight = 10;
-  double diag = 10 * pow(2, 0.5);
+  double straight = map->cell_size;
+  double diag = map->cell_size * pow(2, 0.5);
   // left
   if(col > 1){
     int r = row;
@@ -167,7 +233,7 @@ void make_node_neighbors(map_t *map, int row, int col){
     }
   }
   // right
-  if(col < WIDTH - 2){
+  if(col < map->cols - 2){
     int r = row;
     int c = col + 1;
     node_t *cell = (node_t *)arr_get(map->struct_nodes, r, c);
@@ -197,7 +263,7 @@ void make_node_neighbors(map_t *map, int row, int col){
     }
   }
   // bottom
-  if(row < HEIGHT - 2){
+  if(row < map->rows - 2){
     int r = row + 1;
     int c = col;
     node_t *cell = (node_t *)arr_get(map->struct_nodes, r, c);
@@ -227,7 +293,7 @@ void make_node_neighbors(map_t *map, int row, int col){
     }
   }
   // TR
-  if(row > 1 && col < WIDTH - 2){
+  if(row > 1 && col < map->cols - 2){
     int r = row - 1;
     int c = col + 1;
     node_t *cell = (node_t *)arr_get(map->struct_nodes, r, c);
@@ -242,7 +308,7 @@ void make_node_neighbors(map_t *map, int row, int col){
     }
   }
   // BL
-  if(row < HEIGHT - 2 && col > 1){
+  if(row < map->rows - 2 && col > 1){
     int r = row +  1;
     int c = col - 1;
     node_t *cell = (node_t *)arr_get(map->struct_nodes, r, c);
@@ -257,7 +323,7 @@ void make_node_neighbors(map_t *map, int row, int col){
     }
   }
   // BR
-  if(row < HEIGHT - 2 && col < WIDTH - 2){
+  if(row < map->rows - 2 && col < map->cols - 2){
     int r = row + 1;
     int c = col + 1;
     node_t *cell = (node_t *)arr_get(map->struct_nodes, r, c);
@@ -284,7 +350,7 @@ void pop_struct_nodes(map_t *map){
     list_t *struct_row = (list_t *)list_get(map->struct_nodes, r);
     for(size_t c = 0; c < arr_size(map->backing_array).y; c++){
       object_t *obj = (object_t *)arr_get(map->backing_array, r, c);
-      node_t *struct_node = node_init(obj, INFINITY);
+      node_t *struct_node = node_init_in(map->arena, obj, INFINITY);
       list_add(struct_row, struct_node);
     }
   }
@@ -300,36 +366,87 @@ void pop_struct_nodes(map_t *map){
 }
 
 map_t *map_init(){
+  return map_init_seeded(rng_seed_from_time());
+}
+
+map_t *map_init_seeded(uint64_t seed){
+  map_t *map = map_init_from(MAP_FILE, seed);
+  assert(map != NULL);
+  return map;
+}
+
+map_t *map_init_from(const char *path, uint64_t seed){
+  layout_t *layout = layout_load(path);
+  if(layout == NULL){
+    return NULL;
+  }
+  map_t *map = map_init_layout(layout, seed);
+  layout_free(layout);
+  return map;
+}
+
+// Whether the layout has room for everything placed at random: hiding spots
+// and coins go on open cells in rows and columns from 1 on, and a door may
+// take one of them too. Otherwise placing them would never finish.
+bool map_layout_fits(layout_t *layout){
+  size_t open = 0;
+  for(int r = 1; r < layout->rows; r++){
+    for(int c = 1; c < layout->cols; c++){
+      open += !layout_is_wall(layout, r, c);
+    }
+  }
+  size_t needed = NUM_HIDING_SPOTS + 2;
+  if(open < needed){
+    fprintf(stderr, "map has %zu open cells off its top and left edges, needs %zu\n",
+            open, needed);
+    return false;
+  }
+  return true;
+}
+
+map_t *map_init_layout(layout_t *layout, uint64_t seed){
+  if(!map_layout_fits(layout)){
+    return NULL;
+  }
   map_t *map = malloc(sizeof(map_t));
   assert(map != NULL);
+  map->rows = layout->rows;
+  map->cols = layout->cols;
+  map->cell_size = layout->cell_size > 0 ? layout->cell_size : GRID_SIZE;
+  map->search = NULL;
+  map->seed = seed;
+  rng_seed(&map->rng, seed);
+  // everything that lives as long as the map comes out of map->arena
+  map->arena = arena_init(MAP_ARENA_CHUNK);
+  map->scratch = arena_init(SCRATCH_ARENA_CHUNK);
   map->scene = scene_init();
-  map->backing_array = arr_init(HEIGHT, WIDTH, NULL);
+  map->backing_array = arr_init_in(map->arena, map->rows, map->cols);
   map->purse = START_MONEY;
   // spawn stat objs
-  map->struct_nodes = arr_init(HEIGHT, WIDTH, node_free);
-  // important!! nodes must add before walls, and everything else afterward!
-  map_add_nodes(map);
-  map_add_walls(map);
+  map->struct_nodes = arr_init_in(map->arena, map->rows, map->cols);
+  // important!! nodes and walls must add before everything else!
+  map_add_cells(map, layout);
   map_add_doors(map);
   map_add_hiding_spots(map);
   map_add_coins(map);
   populate_lists(map);
-  CURR_SPOT = NULL;
+  map->hiding = false;
+  map->curr_spot = NULL;
   pop_struct_nodes(map);
   // spawn after to avoid triggering coll bc init @ 0
-  map->player = object_init(make_player());
+  map->player = object_init(make_player(map));
   scene_add_body(map->scene, map->player->body);
-  map->alien = object_init(make_alien());
+  map->alien = object_init(make_alien(map));
   scene_add_body(map->scene, map->alien->body);
   return map;
 }
 
 // triangle so can tell which direction facing. will start pointing to the left
-body_t *make_player(){
+body_t *make_player(map_t *map){
     list_t *pts = list_init(RECT_SIDES, vec_free);
     double angle = 2 * M_PI / RECT_SIDES;
     // generate vectors for general case points
-    vector_t general_pt = (vector_t){R_PLAYER_ALIEN, 0};
+    vector_t general_pt = (vector_t){R_PLAYER_ALIEN * map->cell_size, 0};
     for(size_t i = 0; i < RECT_SIDES; i++){
       double angle_ver = (i) * angle + M_PI / RECT_SIDES;
       vector_t *vert = malloc(sizeof(vector_t));
@@ -340,14 +457,15 @@ body_t *make_player(){
     char *obj_name = malloc(10*sizeof(char));
     strcpy(obj_name,PLAYER);
     body_t *body = body_init_with_info(pts, M_PLAYER, C_PLAYER,obj_name, free);
+    body_set_hidden(body, true);
     return body;
 }
 
-body_t *make_alien(){
+body_t *make_alien(map_t *map){
   list_t *pts = list_init(RECT_SIDES, vec_free);
   double angle = 2 * M_PI / RECT_SIDES;
   // generate vectors for general case points
-  vector_t general_pt = (vector_t){R_PLAYER_ALIEN, 0};
+  vector_t general_pt = (vector_t){R_PLAYER_ALIEN * map->cell_size, 0};
   for(size_t i = 0; i < RECT_SIDES; i++){
     double angle_ver = (i) * angle + M_PI / RECT_SIDES;
     vector_t *vert = malloc(sizeof(vector_t));
@@ -358,51 +476,51 @@ body_t *make_alien(){
   char *obj_name = malloc(10*sizeof(char));
   strcpy(obj_name,ALIEN);
   body_t *body = body_init_with_info(pts, M_ALIEN, C_ALIEN,obj_name, free);
+  body_set_hidden(body, true);
     return body;
 }
 
 void map_free(map_t *map){
+  // scene still has to release heap pieces (bullets, pending forces) first
   scene_free(map->scene);
-  list_free(map->walls);
-  list_free(map->doors);
-  list_free(map->coins);
-  // free bodies of nodes bc not put into the scene
-  for(size_t i = 0; i < list_size(map->nodes); i++){
-    object_t *node = (object_t*)list_get(map->nodes, i);
-    body_free(node->body);
-  }
-  list_free(map->nodes);
-  list_free(map->hiding_spots);
-  arr_free(map->backing_array);
-  arr_free(map->struct_nodes);
   object_free(map->player);
   object_free(map->alien);
+  // walls, doors, coins, nodes, hiding spots and both arrays are all in here
+  arena_free(map->scratch);
+  arena_free(map->arena);
   free(map);
 }
 
 // should only be called at the beginning. assumes that objects at this time are
 // staying in place and not being removed/added i.e. FINAL state of map.
 void populate_lists(map_t *map){
-  map->walls = list_init(NUM_WALLS, object_free);
-  map->doors = list_init(NUM_DOORS, object_free);
-  map->coins = list_init(NUM_COINS, object_free);
-  map->hiding_spots = list_init(NUM_HIDING_SPOTS * NUM_HIDING_TYPES, object_free);
-  map->nodes = list_init(HEIGHT * WIDTH, object_free);
+  size_t cells = (size_t)map->rows * map->cols;
+  // never more walls or nodes than cells
+  map->walls = list_init_in(map->arena, cells, NULL);
+  map->doors = list_init_in(map->arena, NUM_DOORS, NULL);
+  map->coins = list_init_in(map->arena, NUM_COINS, NULL);
+  map->hiding_spots = list_init_in(map->arena, NUM_HIDING_SPOTS * NUM_HIDING_TYPES, NULL);
+  map->nodes = list_init_in(map->arena, cells, NULL);
+  map->cell_kinds = arena_calloc(map->arena, cells);
+  map->coin_counts = arena_calloc(map->arena, cells);
   // get coins first bc not in array
   for(size_t i = 0; i < scene_bodies(map->scene); i++){
     body_t *b_coin = scene_get_body(map->scene, i);
     char *type = body_get_info(b_coin);
     if(strcmp(type, COIN) == 0){
-      object_t *o_coin = object_init(b_coin);
+      object_t *o_coin = object_init_in(map->arena, b_coin);
       object_calc_min_max(o_coin);
       list_add(map->coins, o_coin);
+      vector_t cell = map_ind_from_pos(map, body_get_centroid(b_coin));
+      map->coin_counts[(size_t)cell.x * map->cols + (int)cell.y]++;
     }
   }
   // get everything else
-  for(size_t r = 0; r < HEIGHT; r++){
-    for(size_t c = 0; c < WIDTH; c++){
+  for(size_t r = 0; r < map->rows; r++){
+    for(size_t c = 0; c < map->cols; c++){
       object_t *o = (object_t *) arr_get(map->backing_array, r, c);
       char *type = o->type;
+      map->cell_kinds[r * map->cols + c] = cell_kind_of(o);
       if(strcmp(type, WALL) == 0){
         list_add(map->walls, o);
         scene_add_body(map->scene, o->body);
@@ -426,14 +544,18 @@ void populate_lists(map_t *map){
 
 // when player collides with coin, remove the coin and add value to player's purse
 void map_collect_coin(map_t *map){
+  PROFILE_ZONE("collect_coin");
   object_t *player = map->player;
   list_t *coins = map->coins;
   for(size_t i = 0; i < list_size(coins); i++){
-    if(object_collision(player, (object_t *)list_get(coins, i)) == true){
+    if(object_collision(map, player, (object_t *)list_get(coins, i)) == true){
       map->purse += V_COIN;
-      update_money(map->purse);
-      body_remove(((object_t *)list_get(coins, i))->body);
-      object_free(list_remove(coins, i));
+      hud_update_money(map->purse);
+      body_t *coin = ((object_t *)list_get(coins, i))->body;
+      vector_t cell = map_ind_from_pos(map, body_get_centroid(coin));
+      map->coin_counts[(size_t)cell.x * map->cols + (int)cell.y]--;
+      body_remove(coin);
+      object_free(list_swap_remove(coins, i));
       break;
     }
   }
@@ -447,51 +569,60 @@ bool spend_money(map_t *map, int cost){
   }
   else{
     map->purse -= cost;
-    update_money(map->purse);
+    hud_update_money(map->purse);
     return true;
   }
 }
 
+// Tells the renderer an object in the grid looks different now.
+void map_object_changed(map_t *map, object_t *o){
+  vector_t centroid = body_get_centroid(o->body);
+  vector_t half = {map->cell_size / 2.0, map->cell_size / 2.0};
+  background_update(vec_subtract(centroid, half), vec_add(centroid, half));
+}
+
 // touch you buy..spends money here
 // will just leave player on top of hiding spot. considered hiding if centroid still in
 void map_hide_player(map_t *map){
-  if(HIDING == false){
+  if(map->hiding == false){
     list_t *spots = map->hiding_spots;
     for(size_t i = 0; i < list_size(spots); i++){
       // assumption is that only coll with one hiding spot...will take first found
-      if(object_collision(map->player, (object_t *)list_get(spots, i))){
-        CURR_SPOT = (object_t *)list_get(spots, i);
-        if(CURR_SPOT->is_purchased || spend_money(map, V_HIDE)){
-          HIDING = true;
-          CURR_SPOT->is_purchased = true;
+      if(object_collision(map, map->player, (object_t *)list_get(spots, i))){
+        map->curr_spot = (object_t *)list_get(spots, i);
+        if(map->curr_spot->is_purchased || spend_money(map, V_HIDE)){
+          map->hiding = true;
+          map->curr_spot->is_purchased = true;
           break;
         }
         else{
-          CURR_SPOT = NULL;
+          map->curr_spot = NULL;
         }
       }
     }
-    if(CURR_SPOT != NULL && CURR_SPOT->is_purchased){
-      body_set_centroid(map->player->body, body_get_centroid(CURR_SPOT->body));
+    if(map->curr_spot != NULL && map->curr_spot->is_purchased){
+      body_set_centroid(map->player->body, body_get_centroid(map->curr_spot->body));
       body_set_velocity(map->player->body, VEC_ZERO);
-      body_set_color(CURR_SPOT->body, C_HIDDEN);
+      body_set_color(map->curr_spot->body, C_HIDDEN);
+      map_object_changed(map, map->curr_spot);
     }
   }
 }
 
 void map_unhide_player(map_t *map){
-  if(CURR_SPOT != NULL && HIDING == true){
+  if(map->curr_spot != NULL && map->hiding == true){
     // make sure centroid is outside of box-then unhidden
-    vector_t center_h = body_get_centroid(CURR_SPOT->body);
+    vector_t center_h = body_get_centroid(map->curr_spot->body);
     vector_t center_p = body_get_centroid(map->player->body);
-    if(center_p.x > center_h.x + GRID_SIZE || center_p.x < center_h.x - GRID_SIZE
-    || center_p.y > center_h.y + GRID_SIZE || center_p.y < center_h.y - GRID_SIZE){
+    if(center_p.x > center_h.x + map->cell_size || center_p.x < center_h.x - map->cell_size
+    || center_p.y > center_h.y + map->cell_size || center_p.y < center_h.y - map->cell_size){
       for(size_t i = 0; i < NUM_HIDING_TYPES; i++){
-        if(strcmp(CURR_SPOT->type, HIDING_TYPES[i]) == 0){
-          body_set_color(CURR_SPOT->body, C_HIDING_SPOTS[i]);
-          HIDING = false;
-          CURR_SPOT->is_open = true;
-          CURR_SPOT = NULL;
+        if(strcmp(map->curr_spot->type, HIDING_TYPES[i]) == 0){
+          body_set_color(map->curr_spot->body, C_HIDING_SPOTS[i]);
+          map_object_changed(map, map->curr_spot);
+          map->hiding = false;
+          map->curr_spot->is_open = true;
+          map->curr_spot = NULL;
           break;
         }
       }
@@ -500,16 +631,20 @@ void map_unhide_player(map_t *map){
 }
 
 bool is_hiding(map_t *map){
-  return HIDING;
+  return map->hiding;
 }
 
 void open_door(map_t *map){
   list_t *doors = map->doors;
   for(size_t i = 0; i < list_size(doors); i++){
     object_t *door = (object_t *)list_get(doors, i);
-    if(door->is_open || (object_collision(map->player, door) && spend_money(map, V_DOOR))){
+    if(door->is_open || (object_collision(map, map->player, door) && spend_money(map, V_DOOR))){
+      bool was_open = door->is_open;
       door->is_purchased = true;
       door->is_open = true;
+      if(!was_open){
+        map_object_changed(map, door);
+      }
     }
   }
 }
@@ -519,7 +654,7 @@ bool map_win(map_t *map){
   list_t *doors = map->doors;
   for(size_t i = 0; i < list_size(doors); i++){
     object_t *door = (object_t *)list_get(doors, i);
-    if(object_collision(map->player, door) && door->is_purchased && door->is_open){
+    if(object_collision(map, map->player, door) && door->is_purchased && door->is_open){
       return true;
     }
   }
@@ -528,34 +663,34 @@ bool map_win(map_t *map){
 
 // checks if player and alien colliding, if yes, then lose.
 bool map_lose(map_t *map){
-  return object_collision(map->player, map->alien);
+  return object_collision(map, map->player, map->alien);
 }
 
 /////////////// collisions /////////////////////////
-bool object_collision(object_t *o1, object_t *o2){
+bool object_collision(map_t *map, object_t *o1, object_t *o2){
   if(object_test_bounding_box(o1, o2) == false){
     return false;
   }
   else{
-    list_t *shape1 = body_get_shape(o1->body);
-    list_t *shape2 = body_get_shape(o2->body);
-    collision_info_t info = object_find_collision(shape1, shape2);
-    list_free(shape1);
-    list_free(shape2);
+    // axes live in the frame scratch, dropped at the end of map_tick
+    collision_info_t info = object_find_collision(map->scratch,
+      body_get_points(o1->body), body_get_points(o2->body));
     return info.collided;
   }
 }
 
 // don't let player go into objects it shouldn't be able to go into
 void bounce(map_t *map){
+  PROFILE_ZONE("bounce");
+  double r_player = R_PLAYER_ALIEN * map->cell_size;
   // walls: always bounce
   for(size_t i = 0; i < list_size(map->walls); i++){
     object_t *curr = (object_t *)list_get(map->walls, i);
-    if(object_collision(map->player, curr)){
+    if(object_collision(map, map->player, curr)){
       vector_t center_p = body_get_centroid(map->player->body);
       vector_t center_h = body_get_centroid(curr->body);
-      if((center_p.x - R_PLAYER_ALIEN < center_h.x + GRID_SIZE / 2 && center_p.x + R_PLAYER_ALIEN > center_h.x - GRID_SIZE / 2)
-    && (center_p.y - R_PLAYER_ALIEN < center_h.y + GRID_SIZE / 2 && center_p.y + R_PLAYER_ALIEN > center_h.y - GRID_SIZE / 2)){
+      if((center_p.x - r_player < center_h.x + map->cell_size / 2 && center_p.x + r_player > center_h.x - map->cell_size / 2)
+    && (center_p.y - r_player < center_h.y + map->cell_size / 2 && center_p.y + r_player > center_h.y - map->cell_size / 2)){
       vector_t vel = body_get_velocity(map->player->body);
       if(center_p.x < center_h.x && vel.x > 0){
         // left
@@ -580,11 +715,11 @@ void bounce(map_t *map){
   open_door(map);
   for(size_t i = 0; i < list_size(map->doors); i++){
     object_t *curr = (object_t *)list_get(map->doors, i);
-    if(!curr->is_purchased && object_collision(map->player, curr)){
+    if(!curr->is_purchased && object_collision(map, map->player, curr)){
       vector_t center_p = body_get_centroid(map->player->body);
       vector_t center_h = body_get_centroid(curr->body);
-      if((center_p.x - R_PLAYER_ALIEN < center_h.x + GRID_SIZE / 2 && center_p.x + R_PLAYER_ALIEN > center_h.x - GRID_SIZE / 2)
-    && (center_p.y - R_PLAYER_ALIEN < center_h.y + GRID_SIZE / 2 && center_p.y + R_PLAYER_ALIEN > center_h.y - GRID_SIZE / 2)){
+      if((center_p.x - r_player < center_h.x + map->cell_size / 2 && center_p.x + r_player > center_h.x - map->cell_size / 2)
+    && (center_p.y - r_player < center_h.y + map->cell_size / 2 && center_p.y + r_player > center_h.y - map->cell_size / 2)){
       vector_t vel = body_get_velocity(map->player->body);
       if(center_p.x < center_h.x && vel.x > 0){
         // left
@@ -605,16 +740,16 @@ void bounce(map_t *map){
       }
     }
   }
-  // hiding spots: bounce unless HIDING or is_purchased
+  // hiding spots: bounce unless hiding or is_purchased
   map_hide_player(map);
-  if(!HIDING){
+  if(!map->hiding){
     for(size_t i = 0; i < list_size(map->hiding_spots); i++){
       object_t *curr = (object_t *)list_get(map->hiding_spots, i);
-      if(!curr->is_purchased && object_collision(map->player, curr)){
+      if(!curr->is_purchased && object_collision(map, map->player, curr)){
         vector_t center_p = body_get_centroid(map->player->body);
         vector_t center_h = body_get_centroid(curr->body);
-        if((center_p.x - R_PLAYER_ALIEN < center_h.x + GRID_SIZE / 2 && center_p.x + R_PLAYER_ALIEN > center_h.x - GRID_SIZE / 2)
-      && (center_p.y - R_PLAYER_ALIEN < center_h.y + GRID_SIZE / 2 && center_p.y + R_PLAYER_ALIEN > center_h.y - GRID_SIZE / 2)){
+        if((center_p.x - r_player < center_h.x + map->cell_size / 2 && center_p.x + r_player > center_h.x - map->cell_size / 2)
+      && (center_p.y - r_player < center_h.y + map->cell_size / 2 && center_p.y + r_player > center_h.y - map->cell_size / 2)){
           vector_t vel = body_get_velocity(map->player->body);
           if(center_p.x < center_h.x && vel.x > 0){
             // left
@@ -643,46 +778,43 @@ void bounce(map_t *map){
 // some specialized methods for adding specific types
 
 // makes box at pos 0, no info. you can set centroid and info yourself. has generic 10*10 size
-body_t *make_box(rgb_color_t color){
-  list_t *points = list_init(NUM_RECT, vec_free);
-  vector_t *temp1 = malloc(sizeof(vector_t));
-  assert(temp1 != NULL);
-  *temp1 = (vector_t){GRID_SIZE/2,(-1)*GRID_SIZE/2}; // lower right
-  list_add(points, temp1);
-  vector_t *temp2 = malloc(sizeof(vector_t));
-  assert(temp2 != NULL);
-  *temp2 = (vector_t){GRID_SIZE/2,GRID_SIZE/2}; // upper right
-  list_add(points, temp2);
-  vector_t *temp3 = malloc(sizeof(vector_t));
-  assert(temp3 != NULL);
-  *temp3 = (vector_t){(-1)*GRID_SIZE/2, GRID_SIZE/2}; // upper left
-  list_add(points, temp3);
-  vector_t *temp4 = malloc(sizeof(vector_t));
-  assert(temp4 != NULL);
-  *temp4 = (vector_t){(-1)*GRID_SIZE/2, (-1)*GRID_SIZE/2}; // lower left
-  list_add(points, temp4);
-  body_t *box = body_init(points, MASS, color);
+body_t *make_box(map_t *map, rgb_color_t color){
+  vec_list_t *points = vec_list_init_in(map->arena, NUM_RECT);
+  vec_list_add(points, (vector_t){map->cell_size/2,(-1)*map->cell_size/2}); // lower right
+  vec_list_add(points, (vector_t){map->cell_size/2,map->cell_size/2}); // upper right
+  vec_list_add(points, (vector_t){(-1)*map->cell_size/2, map->cell_size/2}); // upper left
+  vec_list_add(points, (vector_t){(-1)*map->cell_size/2, (-1)*map->cell_size/2}); // lower left
+  body_t *box = body_init_in(map->arena, points, MASS, color);
+  // every box in the map is drawn as an image
+  body_set_hidden(box, true);
   return box;
 }
 
 object_t *map_make_node(map_t *map){
-  body_t *box = make_box(C_NODE);
-  char *obj_name = malloc(10*sizeof(char));
-  strcpy(obj_name, NODE);
-  body_put_info(box, obj_name, free);
-  object_t *node = object_init(box);
+  body_t *box = make_box(map, C_NODE);
+  body_put_info(box, arena_strdup(map->arena, NODE), NULL);
+  object_t *node = object_init_in(map->arena, box);
   return node;
 }
 
-// should fill all spots in 2d array with a node. only to be used at start.
+// fills the 2d array in one pass over the layout: a wall where it has one, a
+// node everywhere else. only to be used at start.
 // nodes are lowest priority -- will be replaced by anything else being placed at spot
-void map_add_nodes(map_t *map){
-  for(size_t r = 0; r < HEIGHT; r++){
+void map_add_cells(map_t *map, layout_t *layout){
+  for(size_t r = 0; r < map->rows; r++){
     list_t *row = (list_t *)list_get(map->backing_array, r);
-    for(size_t c = 0; c < WIDTH; c++){
-      object_t *node = map_make_node(map);
-      body_set_centroid(node->body, map_pos_from_ind(map, r, c));
-      list_add(row, node);
+    for(size_t c = 0; c < map->cols; c++){
+      object_t *cell;
+      if(layout_is_wall(layout, r, c)){
+        cell = map_make_wall(map);
+      }
+      else{
+        cell = map_make_node(map);
+      }
+      body_set_centroid(cell->body, map_pos_from_ind(map, r, c));
+      // update bc moved centroid
+      object_calc_min_max(cell);
+      list_add(row, cell);
     }
   }
 }
@@ -697,122 +829,12 @@ void map_replace_node(map_t *map, int r, int c, object_t *new_ob){
 }
 
 object_t *map_make_wall(map_t *map){
-  body_t *box = make_box(C_WALL);
-  char *obj_name = malloc(10*sizeof(char));
-  strcpy(obj_name, WALL);
-  body_put_info(box, obj_name, free);
-  object_t *wall = object_init(box);
+  body_t *box = make_box(map, C_WALL);
+  body_put_info(box, arena_strdup(map->arena, WALL), NULL);
+  object_t *wall = object_init_in(map->arena, box);
   return wall;
 }
 
-// creates a wall given coordinates of the 2D-array
-void create_walls(map_t *map, size_t r, size_t c){
-  object_t *wall = map_make_wall(map);
-  body_set_centroid(wall->body, map_pos_from_ind(map, r, c));
-  map_replace_node(map, r, c, wall);
-  // update bc moved centroid
-  object_calc_min_max(wall);
-}
-
-// generates walls around the boarder of map and inside of it. hard coded right
-// now, could use maze generation algorithm in future.
-void map_add_walls(map_t *map){
-  for(size_t r = 0; r < HEIGHT; r++){
-    for(size_t c = 0; c < WIDTH; c++){
-      // creates walls at the edge of the map as boundaries
-      if(r == 0 || c == 0 || r == HEIGHT - 1 || c == WIDTH - 1){
-        create_walls(map, r, c);
-      }
-      //create each individual horizontal wall in game
-      if (r == 10 && (10 <= c && 25 <= c)){
-        create_walls(map, r, c);
-      }
-      if (r == 10 && (45 <= c &&  c <= 65)){
-        create_walls(map, r, c);
-      }
-      if (r == 25 && (75 <= c && c <= 95)){
-        create_walls(map, r, c);
-      }
-      if (r == 30 && (5 <= c && c <= 20)){
-        create_walls(map, r, c);
-      }
-      if (r == 40 && (20 <= c && c <= 50)){
-        create_walls(map, r, c);
-      }
-      if (r == 45 && (70 <= c && c <= 85)){
-        create_walls(map, r, c);
-      }
-      if (r == 50 && (5 <= c && c <= 15)){
-        create_walls(map, r, c);
-      }
-      if (r == 60 && (35 <= c && c <= 55)){
-        create_walls(map, r, c);
-      }
-      if (r == 65 && ((60 <= c && c <= 75) || (85 <= c && c <= 95))){
-        create_walls(map, r, c);
-      }
-      if (r == 70 && (5 <= c && c <= 50)){
-        create_walls(map, r, c);
-      }
-      if (r == 75 && (85 <= c && c <= 95)){
-        create_walls(map, r, c);
-      }
-      if (r == 80 && (5 <= c && c <= 40)){
-        create_walls(map, r, c);
-      }
-      if (r == 95 && (45 <= c && c <= 60)){
-        create_walls(map, r, c);
-      }
-      // create each individual vertical wall in game
-      if (c == 20 && (25 <= r && r <= 60)){
-        create_walls(map, r, c);
-      }
-      if (c == 25 && (85 <= r && r <= HEIGHT - 1)){
-        create_walls(map, r, c);
-      }
-      if (c == 30 && (0 <= r && r <= 30)){
-        create_walls(map, r, c);
-      }
-      if (c == 40 && (0 <= r && r <= 12)){
-        create_walls(map, r, c);
-      }
-      if (c == 45 && (60 <= r && r <= 70)){
-        create_walls(map, r, c);
-      }
-      if (c == 45 && (80 <= r && r <= 95)){
-        create_walls(map, r, c);
-      }
-      if (c == 60 && (65 <= r && r <= 95)){
-        create_walls(map, r, c);
-      }
-      if (c == 65 && (10 <= r && r <= 50)){
-        create_walls(map, r, c);
-      }
-      if (c == 70 && (80 <= r && r <= 95)){
-        create_walls(map, r, c);
-      }
-      if (c == 75 && (65 <= r && r <= 80)){
-        create_walls(map, r, c);
-      }
-      if (c == 80 && (35 <= r && r <= 40)){
-        create_walls(map, r, c);
-      }
-      if (c == 85 && (0 <= r && r <= 15)){
-        create_walls(map, r, c);
-      }
-      if (c == 85 && (75 <= r && r <= 90)){
-        create_walls(map, r, c);
-      }
-      if (c == 90 && (85 <= r && r <= 95)){
-        create_walls(map, r, c);
-      }
-      if (c == 95 && (50 <= r && r <= 65)){
-        create_walls(map, r, c);
-      }
-    }
-  }
-}
-
 // replace wall..only used to place doors.
  void map_replace_wall(map_t *map, int r, int c, object_t *new_ob){
   object_t *wall = (object_t *)arr_put(map->backing_array, r, c, new_ob);
@@ -822,52 +844,37 @@ void map_add_walls(map_t *map){
 
 // add door to spot in 2d array, get rid of wall if already there.
 object_t *map_make_door(map_t *map){
-  body_t *box = make_box(C_DOOR);
-  char *obj_name = malloc(10*sizeof(char));
-  strcpy(obj_name, DOOR);
-  body_put_info(box, obj_name, free);
-  object_t *door = object_init(box);
+  body_t *box = make_box(map, C_DOOR);
+  body_put_info(box, arena_strdup(map->arena, DOOR), NULL);
+  object_t *door = object_init_in(map->arena, box);
   return door;
 }
 
 // door 0 is left, 1 is right. spawned randomly along side walls.
 void map_add_doors(map_t *map){
-  srand(time(0));
-  int val1 = rand() % ((int)((double) HEIGHT - 1)) + 1;
-  int val2 = rand() % ((int)((double) HEIGHT - 1)) + 1;
+  int val1 = rng_below(&map->rng, map->rows - 1) + 1;
+  int val2 = rng_below(&map->rng, map->rows - 1) + 1;
   object_t *door_one = map_make_door(map);
   map_replace_wall(map, val1, 0, door_one);
   object_t *door_two = map_make_door(map);
-  map_replace_wall(map, val2, WIDTH - 1, door_two);
+  map_replace_wall(map, val2, map->cols - 1, door_two);
   body_set_centroid(door_one->body, map_pos_from_ind(map, val1, 0));
-  body_set_centroid(door_two->body, map_pos_from_ind(map, val2, WIDTH - 1));
+  body_set_centroid(door_two->body, map_pos_from_ind(map, val2, map->cols - 1));
   // update bc moved centroid
   object_calc_min_max(door_one);
   object_calc_min_max(door_two);
 }
 
 body_t *map_make_coin(map_t *map){
-  list_t *points = list_init(NUM_RECT, vec_free);
-  vector_t *temp1 = malloc(sizeof(vector_t));
-  assert(temp1 != NULL);
-  *temp1 = (vector_t){R_COIN,(-1)*R_COIN}; // lower right
-  list_add(points, temp1);
-  vector_t *temp2 = malloc(sizeof(vector_t));
-  assert(temp2 != NULL);
-  *temp2 = (vector_t){R_COIN,R_COIN}; // upper right
-  list_add(points, temp2);
-  vector_t *temp3 = malloc(sizeof(vector_t));
-  assert(temp3 != NULL);
-  *temp3 = (vector_t){(-1)*R_COIN, R_COIN}; // upper left
-  list_add(points, temp3);
-  vector_t *temp4 = malloc(sizeof(vector_t));
-  assert(temp4 != NULL);
-  *temp4 = (vector_t){(-1)*R_COIN, (-1)*R_COIN}; // lower left
-  list_add(points, temp4);
-  body_t *box = body_init(points, MASS, C_COIN);
-  char *obj_name = malloc(10*sizeof(char));
-  strcpy(obj_name, COIN);
-  body_put_info(box, obj_name, free);
+  double r_coin = R_COIN * map->cell_size;
+  vec_list_t *points = vec_list_init_in(map->arena, NUM_RECT);
+  vec_list_add(points, (vector_t){r_coin,(-1)*r_coin}); // lower right
+  vec_list_add(points, (vector_t){r_coin,r_coin}); // upper right
+  vec_list_add(points, (vector_t){(-1)*r_coin, r_coin}); // upper left
+  vec_list_add(points, (vector_t){(-1)*r_coin, (-1)*r_coin}); // lower left
+  body_t *box = body_init_in(map->arena, points, MASS, C_COIN);
+  body_put_info(box, arena_strdup(map->arena, COIN), NULL);
+  body_set_hidden(box, true);
   scene_add_body(map->scene, box);
   return box;
 }
@@ -879,8 +886,9 @@ void map_add_coins(map_t *map){
     bool check = false;
     int x, y;
     while(!check){
-      x = rand() % (WIDTH-1) + 1;
-      y = rand() % (HEIGHT-1) + 1;
+      // x is the row, y the column
+      x = rng_below(&map->rng, map->rows - 1) + 1;
+      y = rng_below(&map->rng, map->cols - 1) + 1;
       object_t *curr = (object_t *) arr_get(map->backing_array, x, y);
       if(strcmp(curr->type, NODE) == 0){
         body_t *coin = map_make_coin(map);
@@ -893,11 +901,9 @@ void map_add_coins(map_t *map){
 
 // unid hiding spot..to be assigned later
 object_t *map_make_hiding_spot(map_t *map, int ind){
-  body_t *box = make_box(C_HIDING_SPOTS[ind]);
-  char *obj_name = malloc(10*sizeof(char));
-  strcpy(obj_name, HIDING_TYPES[ind]);
-  body_put_info(box, obj_name, free);
-  object_t *spot = object_init(box);
+  body_t *box = make_box(map, C_HIDING_SPOTS[ind]);
+  body_put_info(box, arena_strdup(map->arena, HIDING_TYPES[ind]), NULL);
+  object_t *spot = object_init_in(map->arena, box);
   return spot;
 }
 
@@ -906,8 +912,9 @@ void map_add_hiding_spots(map_t *map){
     bool check = false;
     int x, y;
     while(!check){
-      x = rand() % (WIDTH-1) + 1;
-      y = rand() % (HEIGHT-1) + 1;
+      // x is the row, y the column
+      x = rng_below(&map->rng, map->rows - 1) + 1;
+      y = rng_below(&map->rng, map->cols - 1) + 1;
       object_t *curr = (object_t *) arr_get(map->backing_array, x, y);
       if(strcmp(curr->type, NODE) == 0){
         object_t *hiding = map_make_hiding_spot(map, i%2);
@@ -925,6 +932,7 @@ void map_add_hiding_spots(map_t *map){
 
 // should call scene tick, and also collect_coin, lose, etc.
 void map_tick(map_t *map, double dt){
+  PROFILE_ZONE("map_tick");
   object_calc_min_max(map->player);
   object_calc_min_max(map->alien);
   map_collect_coin(map);
@@ -933,4 +941,6 @@ void map_tick(map_t *map, double dt){
     map_unhide_player(map);
   }
   scene_tick(map->scene, dt);
+  // nothing allocated from scratch this frame may be held past here
+  arena_reset(map->scratch);
 }
@@ -2,14 +2,14 @@
 
 // ONLY USE FOR 2D ARRAY IN MAP
 
-double *get_extrema(list_t *inp){
-  double *ans = malloc(4 * sizeof(double));
+void get_extrema(vec_list_t *inp, double *ans){
   double min_x_1, min_y_1, max_x_1, max_y_1;
   min_x_1 = min_y_1 = INFINITY;
   max_x_1 = max_y_1 = -INFINITY;
-  for(size_t i = 0; i < list_size(inp); i++){
-    double x = ((vector_t *)list_get(inp, i))->x;
-    double y = ((vector_t *)list_get(inp, i))->y;
+  vector_t *pts = vec_list_data(inp);
+  for(size_t i = 0; i < vec_list_size(inp); i++){
+    double x = pts[i].x;
+    double y = pts[i].y;
     if(x < min_x_1){
       min_x_1 = x;
     } else if (x > max_x_1){
@@ -25,27 +25,57 @@ double *get_extrema(list_t *inp){
   ans[1] = max_x_1;
   ans[2] = min_y_1;
   ans[3] = max_y_1;
-  return ans;
 }
 
-object_t *object_init(body_t *body){
+// Objects per slab in the object pool.
+const size_t OBJECT_SLAB = 64;
+// Heap objects come from here instead of malloc; made on first use and freed
+// at exit.
+pool_t *OBJECT_POOL = NULL;
+
+void object_pool_free(void){
+  pool_free(OBJECT_POOL);
+  OBJECT_POOL = NULL;
+}
+
+pool_t *object_pool(void){
+  if(OBJECT_POOL == NULL){
+    OBJECT_POOL = pool_init(sizeof(object_t), OBJECT_SLAB);
+    atexit(object_pool_free);
+  }
+  return OBJECT_POOL;
+}
+
+pool_stats_t object_pool_stats(void){
+  return pool_stats(object_pool());
+}
+
+// Fills in everything but the allocation itself.
+void object_setup(object_t *o, body_t *body){
   // Body should already have info!!
-  object_t *o = malloc(sizeof(object_t));
   o->body = body;
   o->is_open = false;
   o->is_purchased = false;
   o->type = (char *)body_get_info(body);
-  list_t *shape = body_get_shape(body);
-  o->coll_extrema = get_extrema(shape);
-  list_free(shape);
+  get_extrema(body_get_points(body), o->coll_extrema);
+}
+
+object_t *object_init(body_t *body){
+  object_t *o = pool_alloc(object_pool());
+  object_setup(o, body);
+  o->arena = NULL;
+  return o;
+}
+
+object_t *object_init_in(arena_t *arena, body_t *body){
+  object_t *o = arena_alloc(arena, sizeof(object_t));
+  object_setup(o, body);
+  o->arena = arena;
   return o;
 }
 
 void object_calc_min_max(object_t *o){
-  free(o->coll_extrema);
-  list_t *shape = body_get_shape(o->body);
-  o->coll_extrema = get_extrema(shape);
-  list_free(shape);
+  get_extrema(body_get_points(o->body), o->coll_extrema);
 }
 
 
@@ -54,7 +84,7 @@ double *object_get_min_max(object_t *o){
 }
 
 void object_free(void *o){
-  // Assumes that there is coll_extrema...no reason why there should not be upon free, so...
-  free(((object_t *)o)->coll_extrema);
-  free(o);
+  if(((object_t *)o)->arena == NULL){
+    pool_release(object_pool(), o);
+  }
 }
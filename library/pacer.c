@@ -0,0 +1,114 @@
+#include "pacer.h"
+#include "timestep.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Guess at how far past its end a sleep runs, before any were measured,
+// and how much each new measurement moves the guess.
+const double PACER_OVERSLEEP = 0.0005;
+const double PACER_OVERSLEEP_WEIGHT = 0.1;
+const double PACER_MS_PER_S = 1000;
+
+typedef struct pacer {
+    // 0 if unpaced
+    double period;
+    bool started;
+    double deadline;
+    double start_time;
+    double oversleep;
+    size_t frames;
+    size_t missed;
+    double slept;
+    double worst_late;
+} pacer_t;
+
+pacer_t *pacer_init(double rate_hz) {
+    assert(rate_hz >= 0);
+    pacer_t *pacer = malloc(sizeof(pacer_t));
+    assert(pacer != NULL);
+    pacer->period = rate_hz > 0 ? 1.0 / rate_hz : 0;
+    pacer->started = false;
+    pacer->deadline = 0;
+    pacer->start_time = 0;
+    pacer->oversleep = PACER_OVERSLEEP;
+    pacer->frames = 0;
+    pacer->missed = 0;
+    pacer->slept = 0;
+    pacer->worst_late = 0;
+    return pacer;
+}
+
+void pacer_free(pacer_t *pacer) {
+    free(pacer);
+}
+
+// Sleeps for about the given number of seconds (at least, barring signals).
+void pacer_sleep(double seconds) {
+    struct timespec duration;
+    duration.tv_sec = (time_t)seconds;
+    duration.tv_nsec = (long)((seconds - duration.tv_sec) * 1e9);
+    nanosleep(&duration, NULL);
+}
+
+void pacer_wait(pacer_t *pacer) {
+    double now = timestep_now();
+    if (!pacer->started) {
+        pacer->started = true;
+        pacer->start_time = now;
+        pacer->deadline = now + pacer->period;
+        return;
+    }
+    pacer->frames++;
+    if (pacer->period == 0) {
+        return;
+    }
+    if (now > pacer->deadline) {
+        double late = now - pacer->deadline;
+        pacer->missed++;
+        pacer->worst_late = late > pacer->worst_late ? late : pacer->worst_late;
+        pacer->deadline = now + pacer->period;
+        return;
+    }
+    double wait_start = now;
+    // sleep all but the usual overshoot, and learn the overshoot from it
+    double sleep = pacer->deadline - now - pacer->oversleep;
+    if (sleep > 0) {
+        pacer_sleep(sleep);
+        now = timestep_now();
+        double overshoot = now - wait_start - sleep;
+        overshoot = overshoot > 0 ? overshoot : 0;
+        pacer->oversleep += PACER_OVERSLEEP_WEIGHT * (overshoot - pacer->oversleep);
+    }
+    while (now < pacer->deadline) {
+        now = timestep_now();
+    }
+    pacer->slept += now - wait_start;
+    pacer->deadline += pacer->period;
+}
+
+size_t pacer_frames(pacer_t *pacer) {
+    return pacer->frames;
+}
+
+size_t pacer_missed(pacer_t *pacer) {
+    return pacer->missed;
+}
+
+double pacer_slept(pacer_t *pacer) {
+    return pacer->slept;
+}
+
+double pacer_worst_late(pacer_t *pacer) {
+    return pacer->worst_late;
+}
+
+void pacer_print(pacer_t *pacer, const char *name, FILE *file) {
+    double elapsed = pacer->started ? timestep_now() - pacer->start_time : 0;
+    double rate = pacer->period > 0 ? 1 / pacer->period : 0;
+    fprintf(file, "%s: %zu frames at %.0f Hz, %zu missed (worst %.1f ms late), "
+            "%.0f%% asleep\n", name, pacer->frames, rate, pacer->missed,
+            pacer->worst_late * PACER_MS_PER_S,
+            elapsed > 0 ? 100 * pacer->slept / elapsed : 0);
+}
@@ -9,42 +9,54 @@ const double CENT1 = 6.0;
 const double AREA1 = 2.0;
 
 typedef struct polygon {
-    list_t *points;
+    vec_list_t *points;
+    arena_t *arena;
 } polygon_t;
 
 polygon_t *polygon_init(size_t num_pts) {
     polygon_t *p = malloc(sizeof(polygon_t));
     assert(p != NULL);
-    p->points = list_init(num_pts, vec_free);
-    assert(p->points != NULL);
+    p->points = vec_list_init(num_pts);
+    p->arena = NULL;
+    return p;
+}
+
+polygon_t *polygon_init_in(arena_t *arena, vec_list_t *points) {
+    polygon_t *p = arena_alloc(arena, sizeof(polygon_t));
+    p->points = points;
+    p->arena = arena;
     return p;
 }
 
 void polygon_free(void *polygon) {
-    list_free(((polygon_t *)polygon)->points);
-    free(((polygon_t *)polygon));
+    vec_list_free(((polygon_t *)polygon)->points);
+    if (((polygon_t *)polygon)->arena == NULL) {
+        free(((polygon_t *)polygon));
+    }
 }
 
 void polygon_set_points(polygon_t *polygon, list_t *points) {
-    list_free(polygon->points);
-    polygon->points = points;
+    vec_list_t *dest = polygon->points;
+    vec_list_clear(dest);
+    vec_list_reserve(dest, list_size(points));
+    for (size_t i = 0; i < list_size(points); i++) {
+        vec_list_add(dest, *(vector_t *)list_get(points, i));
+    }
+    list_free(points);
 }
 
-list_t *polygon_get_points(polygon_t *polygon) {
+vec_list_t *polygon_get_points(polygon_t *polygon) {
     return polygon->points;
 }
 
 double polygon_area(polygon_t *polygon) {
     double area = 0.0;
-    list_t *points = polygon->points;
-    size_t num_vert = list_size(points);
+    vector_t *points = vec_list_data(polygon->points);
+    size_t num_vert = vec_list_size(polygon->points);
     // j will serve as "previous" vertex
     size_t j = num_vert - 1;
     for (size_t i = 0; i < num_vert; i++) {
-        area += ((((vector_t *)list_get(points, j))->x *
-                  ((vector_t *)list_get(points, i))->y) -
-                 (((vector_t *)list_get(points, j))->y *
-                  ((vector_t *)list_get(points, i))->x));
+        area += points[j].x * points[i].y - points[j].y * points[i].x;
         // keep one behind i
         j = i;
     }
@@ -54,22 +66,15 @@ double polygon_area(polygon_t *polygon) {
 vector_t polygon_centroid(polygon_t *polygon) {
     double center_x = 0.0;
     double center_y = 0.0;
-    list_t *points = polygon->points;
-    size_t num_vert = list_size(points);
+    vector_t *points = vec_list_data(polygon->points);
+    size_t num_vert = vec_list_size(polygon->points);
     // j will serve as "previous" vertex
     size_t j = num_vert - 1;
     for (size_t i = 0; i < num_vert; i++) {
         // calculate this first bc it's common factor for both x and y coordinates
-        double comm_f =
-            (((vector_t *)list_get(points, j))->x *
-             ((vector_t *)list_get(points, i))->y) -
-            (((vector_t *)list_get(points, i))->x * ((vector_t *)list_get(points, j))->y);
-        center_x += (((vector_t *)list_get(points, j))->x +
-                     ((vector_t *)list_get(points, i))->x) *
-                    comm_f;
-        center_y += (((vector_t *)list_get(points, j))->y +
-                     ((vector_t *)list_get(points, i))->y) *
-                    comm_f;
+        double comm_f = points[j].x * points[i].y - points[i].x * points[j].y;
+        center_x += (points[j].x + points[i].x) * comm_f;
+        center_y += (points[j].y + points[i].y) * comm_f;
         // keep one behind i
         j = i;
     }
@@ -81,23 +86,22 @@ vector_t polygon_centroid(polygon_t *polygon) {
 }
 
 void polygon_translate(polygon_t *polygon, vector_t translation) {
-    list_t *points = polygon->points;
-    for (size_t i = 0; i < list_size(points); i++) {
-        vector_t *vertex = (vector_t *)list_get(points, i);
-        *vertex = vec_add(translation, *vertex);
+    vector_t *points = vec_list_data(polygon->points);
+    for (size_t i = 0; i < vec_list_size(polygon->points); i++) {
+        points[i] = vec_add(translation, points[i]);
     }
 }
 
 void polygon_rotate(polygon_t *polygon, double angle, vector_t point) {
-    list_t *points = polygon->points;
-    for (size_t i = 0; i < list_size(points); i++) {
-        vector_t old = *(vector_t *)list_get(points, i);
+    vector_t *points = vec_list_data(polygon->points);
+    for (size_t i = 0; i < vec_list_size(polygon->points); i++) {
+        vector_t old = points[i];
         // rotate center about point (subtraction gives vector from origin, where
         // origin = point)
         vector_t new = vec_subtract(old, point);
         new = vec_rotate(new, angle);
         // add new vector to point
         new = vec_add(point, new);
-        *(vector_t *)list_get(points, i) = new;
+        points[i] = new;
     }
 }
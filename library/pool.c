@@ -0,0 +1,132 @@
+#include "pool.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Slot headers are padded to this so elements stay aligned for any type.
+const size_t POOL_ALIGN = alignof(max_align_t);
+// Starting size of the slab table; doubles as slabs are added.
+const size_t INIT_SLABS = 4;
+
+// Sits in front of every element.
+typedef struct slot {
+    bool live;
+} slot_t;
+
+// Free elements store the next free element in their own first bytes.
+typedef struct free_elem {
+    struct free_elem *next;
+} free_elem_t;
+
+typedef struct pool {
+    unsigned char **slabs;
+    size_t num_slabs;
+    size_t slab_table_size;
+    size_t slab_count;
+    size_t slot_size;
+    size_t header_size;
+    free_elem_t *free_list;
+    size_t live;
+    size_t peak;
+} pool_t;
+
+size_t pool_round_up(size_t size, size_t align) {
+    return (size + align - 1) & ~(align - 1);
+}
+
+pool_t *pool_init(size_t elem_size, size_t slab_count) {
+    assert(slab_count > 0);
+    pool_t *pool = malloc(sizeof(pool_t));
+    assert(pool != NULL);
+    if (elem_size < sizeof(free_elem_t)) {
+        elem_size = sizeof(free_elem_t);
+    }
+    pool->header_size = pool_round_up(sizeof(slot_t), POOL_ALIGN);
+    pool->slot_size = pool->header_size + pool_round_up(elem_size, POOL_ALIGN);
+    pool->slab_count = slab_count;
+    pool->slab_table_size = INIT_SLABS;
+    pool->slabs = malloc(INIT_SLABS * sizeof(unsigned char *));
+    assert(pool->slabs != NULL);
+    pool->num_slabs = 0;
+    pool->free_list = NULL;
+    pool->live = 0;
+    pool->peak = 0;
+    return pool;
+}
+
+void pool_free(pool_t *pool) {
+    for (size_t i = 0; i < pool->num_slabs; i++) {
+        free(pool->slabs[i]);
+    }
+    free(pool->slabs);
+    free(pool);
+}
+
+slot_t *pool_slot(pool_t *pool, size_t index) {
+    unsigned char *slab = pool->slabs[index / pool->slab_count];
+    return (slot_t *)(slab + (index % pool->slab_count) * pool->slot_size);
+}
+
+void *slot_elem(pool_t *pool, slot_t *slot) {
+    return (unsigned char *)slot + pool->header_size;
+}
+
+slot_t *elem_slot(pool_t *pool, void *elem) {
+    return (slot_t *)((unsigned char *)elem - pool->header_size);
+}
+
+// Adds one slab and threads all of its slots onto the free list.
+void pool_grow(pool_t *pool) {
+    if (pool->num_slabs == pool->slab_table_size) {
+        pool->slab_table_size *= 2;
+        pool->slabs = realloc(pool->slabs, pool->slab_table_size * sizeof(unsigned char *));
+        assert(pool->slabs != NULL);
+    }
+    unsigned char *slab = malloc(pool->slab_count * pool->slot_size);
+    assert(slab != NULL);
+    size_t first = pool->num_slabs * pool->slab_count;
+    pool->slabs[pool->num_slabs++] = slab;
+    // Push in reverse so elements come out in address order.
+    for (size_t i = pool->slab_count; i > 0; i--) {
+        slot_t *slot = pool_slot(pool, first + i - 1);
+        slot->live = false;
+        free_elem_t *elem = slot_elem(pool, slot);
+        elem->next = pool->free_list;
+        pool->free_list = elem;
+    }
+}
+
+void *pool_alloc(pool_t *pool) {
+    if (pool->free_list == NULL) {
+        pool_grow(pool);
+    }
+    free_elem_t *elem = pool->free_list;
+    pool->free_list = elem->next;
+    elem_slot(pool, elem)->live = true;
+    pool->live++;
+    if (pool->live > pool->peak) {
+        pool->peak = pool->live;
+    }
+    return elem;
+}
+
+void pool_release(pool_t *pool, void *elem) {
+    slot_t *slot = elem_slot(pool, elem);
+    // Catches double frees and pointers that never came from a pool.
+    assert(slot->live);
+    slot->live = false;
+    free_elem_t *free_elem = elem;
+    free_elem->next = pool->free_list;
+    pool->free_list = free_elem;
+    pool->live--;
+}
+
+pool_stats_t pool_stats(pool_t *pool) {
+    pool_stats_t stats;
+    stats.live = pool->live;
+    stats.peak = pool->peak;
+    stats.capacity = pool->num_slabs * pool->slab_count;
+    stats.slabs = pool->num_slabs;
+    return stats;
+}
@@ -0,0 +1,179 @@
+#include "profiler.h"
+
+#ifdef PROFILE
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+const double PROF_NS_PER_MS = 1e6;
+const double PROF_NS_PER_US = 1e3;
+
+// One run of a zone, for the trace.
+typedef struct prof_event {
+    int id;
+    // the thread's number, from 1
+    int thread;
+    uint64_t start;
+    uint64_t duration;
+} prof_event_t;
+
+// Everything is fixed-size and static, so profiling never allocates.
+// Zones may run on more than one thread (the game simulates on its own),
+// so what zones write is atomic and registering takes a lock.
+const char *prof_names[PROF_MAX_ZONES];
+atomic_int prof_num_zones = 0;
+atomic_flag prof_register_lock = ATOMIC_FLAG_INIT;
+// threads that have opened a zone, and the number of the one running
+// (0 until it opens its first)
+atomic_int prof_num_threads = 0;
+_Thread_local int prof_thread = 0;
+// time each thread spent in each zone so far this frame
+atomic_uint_fast64_t prof_current[PROF_MAX_THREADS][PROF_MAX_ZONES];
+// ring of finished frames: per-thread, per-zone totals and the frame's own
+// length
+uint64_t prof_frames[PROF_FRAMES][PROF_MAX_THREADS][PROF_MAX_ZONES];
+uint64_t prof_frame_lengths[PROF_FRAMES];
+size_t prof_frame_count = 0;
+uint64_t prof_frame_start = 0;
+// ring of zone runs
+prof_event_t prof_events[PROF_EVENTS];
+atomic_size_t prof_event_count = 0;
+// trace timestamps are relative to the first zone
+atomic_uint_fast64_t prof_epoch = 0;
+
+uint64_t prof_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+int prof_register(const char *name) {
+    while (atomic_flag_test_and_set(&prof_register_lock)) {
+    }
+    int id = 0;
+    while (id < prof_num_zones && strcmp(prof_names[id], name) != 0) {
+        id++;
+    }
+    if (id == prof_num_zones) {
+        assert(prof_num_zones < PROF_MAX_ZONES);
+        prof_names[id] = name;
+        prof_num_zones++;
+    }
+    atomic_flag_clear(&prof_register_lock);
+    return id;
+}
+
+prof_zone_t prof_zone_begin(atomic_int *id, const char *name) {
+    // registering twice from two threads is harmless: both get the same id
+    int zone = atomic_load_explicit(id, memory_order_relaxed);
+    if (zone < 0) {
+        zone = prof_register(name);
+        atomic_store_explicit(id, zone, memory_order_relaxed);
+    }
+    if (prof_thread == 0) {
+        prof_thread = atomic_fetch_add(&prof_num_threads, 1) + 1;
+        assert(prof_thread <= PROF_MAX_THREADS);
+    }
+    uint64_t now = prof_now();
+    uint_fast64_t unset = 0;
+    atomic_compare_exchange_strong(&prof_epoch, &unset, now);
+    return (prof_zone_t){zone, now};
+}
+
+void prof_zone_end(prof_zone_t *zone) {
+    uint64_t duration = prof_now() - zone->start;
+    atomic_fetch_add(&prof_current[prof_thread - 1][zone->id], duration);
+    size_t event = atomic_fetch_add(&prof_event_count, 1);
+    prof_events[event % PROF_EVENTS] =
+        (prof_event_t){zone->id, prof_thread, zone->start, duration};
+}
+
+void prof_frame(void) {
+    uint64_t now = prof_now();
+    size_t slot = prof_frame_count % PROF_FRAMES;
+    for (int thread = 0; thread < PROF_MAX_THREADS; thread++) {
+        for (int id = 0; id < PROF_MAX_ZONES; id++) {
+            prof_frames[slot][thread][id] =
+                atomic_exchange(&prof_current[thread][id], 0);
+        }
+    }
+    // only the thread ending frames touches prof_frame_start; the first
+    // frame starts at the first zone
+    uint64_t start = prof_frame_start ? prof_frame_start : prof_epoch;
+    prof_frame_lengths[slot] = start ? now - start : 0;
+    prof_frame_start = now;
+    prof_frame_count++;
+}
+
+bool prof_write_trace(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    size_t count =
+        prof_event_count < PROF_EVENTS ? prof_event_count : PROF_EVENTS;
+    size_t first = prof_event_count - count;
+    fprintf(file, "{\"traceEvents\": [\n");
+    for (size_t i = 0; i < count; i++) {
+        prof_event_t *event = &prof_events[(first + i) % PROF_EVENTS];
+        // zone names are C identifiers, so nothing needs escaping
+        fprintf(file,
+                "{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                "\"ts\": %.3f, \"dur\": %.3f}%s\n",
+                prof_names[event->id], event->thread,
+                (event->start - prof_epoch) / PROF_NS_PER_US,
+                event->duration / PROF_NS_PER_US, i + 1 < count ? "," : "");
+    }
+    fprintf(file, "], \"displayTimeUnit\": \"ms\"}\n");
+    fclose(file);
+    return true;
+}
+
+size_t prof_overlay_text(char *buf, size_t size) {
+    size_t frames =
+        prof_frame_count < PROF_FRAMES ? prof_frame_count : PROF_FRAMES;
+    size_t used = 0;
+    size_t lines = 0;
+    buf[0] = '\0';
+    if (frames == 0) {
+        return 0;
+    }
+    // zone -1 is the whole frame, counted once
+    for (int thread = 0; thread < prof_num_threads; thread++) {
+        for (int id = thread == 0 ? -1 : 0; id < prof_num_zones && used < size;
+             id++) {
+            uint64_t total = 0;
+            uint64_t worst = 0;
+            for (size_t f = 0; f < frames; f++) {
+                uint64_t t = id < 0 ? prof_frame_lengths[f]
+                                    : prof_frames[f][thread][id];
+                total += t;
+                worst = t > worst ? t : worst;
+            }
+            if (id >= 0 && total == 0) {
+                // not run on this thread
+                continue;
+            }
+            char name[32];
+            snprintf(name, sizeof(name), "%s t%d",
+                     id < 0 ? "frame" : prof_names[id], thread + 1);
+            int n = snprintf(buf + used, size - used,
+                             "%-18s %7.3f ms  max %7.3f\n",
+                             id < 0 ? "frame" : name,
+                             total / PROF_NS_PER_MS / frames,
+                             worst / PROF_NS_PER_MS);
+            if (n < 0) {
+                break;
+            }
+            used += (size_t)n;
+            lines++;
+        }
+    }
+    return lines;
+}
+
+#endif // #ifdef PROFILE
@@ -0,0 +1,38 @@
+#include "renderer.h"
+#include <stddef.h>
+
+const renderer_t NULL_RENDERER = {NULL, NULL, NULL, NULL};
+
+const renderer_t *RENDERER = &NULL_RENDERER;
+
+void renderer_set(const renderer_t *renderer) {
+    RENDERER = renderer != NULL ? renderer : &NULL_RENDERER;
+}
+
+const renderer_t *renderer_get(void) {
+    return RENDERER;
+}
+
+void hud_update_money(int money) {
+    if (RENDERER->money_changed != NULL) {
+        RENDERER->money_changed(money);
+    }
+}
+
+void hud_update_bullets(int bullets) {
+    if (RENDERER->bullets_changed != NULL) {
+        RENDERER->bullets_changed(bullets);
+    }
+}
+
+void hud_update_stamina(int stamina) {
+    if (RENDERER->stamina_changed != NULL) {
+        RENDERER->stamina_changed(stamina);
+    }
+}
+
+void background_update(vector_t min, vector_t max) {
+    if (RENDERER->background_changed != NULL) {
+        RENDERER->background_changed(min, max);
+    }
+}
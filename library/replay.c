@@ -0,0 +1,179 @@
+#include "replay.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char REPLAY_MAGIC[4] = {'A', 'L', 'R', 'P'};
+const size_t REPLAY_HEADER_SIZE = 16;
+const size_t REPLAY_EVENT_SIZE = 6;
+
+typedef struct recorder {
+    FILE *file;
+    uint32_t last_tick;
+} recorder_t;
+
+typedef struct replay {
+    uint64_t seed;
+    int rate;
+    uint32_t ticks;
+    replay_event_t *events;
+    size_t num_events;
+    // next event to hand out
+    size_t next;
+} replay_t;
+
+// Little-endian encoding, so recordings move between machines.
+void put_le(unsigned char *buf, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        buf[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+uint64_t get_le(const unsigned char *buf, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; i++) {
+        value |= (uint64_t)buf[i] << (8 * i);
+    }
+    return value;
+}
+
+void write_event(recorder_t *recorder, uint32_t tick, char key,
+                 key_event_type_t type) {
+    unsigned char buf[REPLAY_EVENT_SIZE];
+    put_le(buf, tick, 4);
+    buf[4] = (unsigned char)key;
+    buf[5] = type == KEY_PRESSED ? 0 : 1;
+    fwrite(buf, 1, REPLAY_EVENT_SIZE, recorder->file);
+}
+
+recorder_t *recorder_open(const char *path, uint64_t seed, int rate_hz) {
+    assert(rate_hz > 0 && rate_hz <= UINT16_MAX);
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror(path);
+        return NULL;
+    }
+    recorder_t *recorder = malloc(sizeof(recorder_t));
+    assert(recorder != NULL);
+    recorder->file = file;
+    recorder->last_tick = 0;
+    unsigned char header[REPLAY_HEADER_SIZE];
+    memcpy(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    put_le(header + 4, REPLAY_VERSION, 2);
+    put_le(header + 6, rate_hz, 2);
+    put_le(header + 8, seed, 8);
+    fwrite(header, 1, REPLAY_HEADER_SIZE, file);
+    return recorder;
+}
+
+void recorder_key(recorder_t *recorder, uint32_t tick, char key,
+                  key_event_type_t type) {
+    assert(key != 0);
+    assert(tick >= recorder->last_tick);
+    recorder->last_tick = tick;
+    write_event(recorder, tick, key, type);
+}
+
+void recorder_close(recorder_t *recorder, uint32_t tick) {
+    assert(tick >= recorder->last_tick);
+    write_event(recorder, tick, 0, KEY_PRESSED);
+    fclose(recorder->file);
+    free(recorder);
+}
+
+// Prints why a recording was rejected and cleans up after replay_open().
+replay_t *replay_reject(const char *path, const char *why, FILE *file,
+                        replay_t *replay) {
+    fprintf(stderr, "%s: %s\n", path, why);
+    if (file != NULL) {
+        fclose(file);
+    }
+    if (replay != NULL) {
+        replay_free(replay);
+    }
+    return NULL;
+}
+
+replay_t *replay_open(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return NULL;
+    }
+    unsigned char header[REPLAY_HEADER_SIZE];
+    if (fread(header, 1, REPLAY_HEADER_SIZE, file) != REPLAY_HEADER_SIZE ||
+        memcmp(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        return replay_reject(path, "not a recording", file, NULL);
+    }
+    if (get_le(header + 4, 2) != REPLAY_VERSION) {
+        return replay_reject(path, "unsupported recording version", file, NULL);
+    }
+    if (get_le(header + 6, 2) == 0) {
+        return replay_reject(path, "recording has no step rate", file, NULL);
+    }
+    replay_t *replay = malloc(sizeof(replay_t));
+    assert(replay != NULL);
+    replay->rate = get_le(header + 6, 2);
+    replay->seed = get_le(header + 8, 8);
+    replay->ticks = 0;
+    replay->num_events = 0;
+    replay->next = 0;
+    size_t capacity = 64;
+    replay->events = malloc(capacity * sizeof(replay_event_t));
+    assert(replay->events != NULL);
+    unsigned char buf[REPLAY_EVENT_SIZE];
+    while (1) {
+        if (fread(buf, 1, REPLAY_EVENT_SIZE, file) != REPLAY_EVENT_SIZE) {
+            return replay_reject(path, "recording is cut short", file, replay);
+        }
+        uint32_t tick = get_le(buf, 4);
+        if (tick < replay->ticks) {
+            return replay_reject(path, "events out of order", file, replay);
+        }
+        replay->ticks = tick;
+        if (buf[4] == 0) {
+            break;
+        }
+        if (replay->num_events == capacity) {
+            capacity *= 2;
+            replay->events =
+                realloc(replay->events, capacity * sizeof(replay_event_t));
+            assert(replay->events != NULL);
+        }
+        replay->events[replay->num_events++] = (replay_event_t){
+            tick, (char)buf[4], buf[5] == 0 ? KEY_PRESSED : KEY_RELEASED};
+    }
+    fclose(file);
+    return replay;
+}
+
+void replay_free(replay_t *replay) {
+    free(replay->events);
+    free(replay);
+}
+
+uint64_t replay_seed(replay_t *replay) {
+    return replay->seed;
+}
+
+int replay_rate(replay_t *replay) {
+    return replay->rate;
+}
+
+uint32_t replay_ticks(replay_t *replay) {
+    return replay->ticks;
+}
+
+size_t replay_events(replay_t *replay) {
+    return replay->num_events;
+}
+
+int replay_next(replay_t *replay, uint32_t tick, replay_event_t *event) {
+    if (replay->next == replay->num_events ||
+        replay->events[replay->next].tick > tick) {
+        return 0;
+    }
+    *event = replay->events[replay->next++];
+    return 1;
+}
@@ -0,0 +1,61 @@
+#include "rng.h"
+#include <assert.h>
+#include <time.h>
+
+// Expands one 64 bit seed into well mixed state words (splitmix64).
+uint64_t rng_splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(rng_t *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = rng_splitmix64(&seed);
+    }
+}
+
+uint64_t rng_next(rng_t *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+uint32_t rng_below(rng_t *rng, uint32_t bound) {
+    assert(bound > 0);
+    // Lemire's multiply-and-reject: map 32 random bits onto [0, bound) and
+    // retry the few values that would make low results more likely.
+    uint64_t m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+    uint32_t low = (uint32_t)m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = (uint64_t)(uint32_t)(rng_next(rng) >> 32) * bound;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+double rng_double(rng_t *rng) {
+    // top 53 bits fill a double's mantissa exactly
+    return (rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+uint64_t rng_seed_from_time(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
@@ -1,7 +1,10 @@
 #include "scene.h"
+#include "counters.h"
+#include "profiler.h"
 
 const size_t NUM_BODIES = 50;
 const size_t NUM_FORCE_TS = 1;
+const size_t FORCE_SLAB = 1024;
 
 typedef struct scene {
     list_t *bodies;
@@ -39,11 +42,9 @@ void scene_add_body(scene_t *scene, body_t *body) {
 }
 
 void scene_remove_body(scene_t *scene, size_t index) {
-    // The body free is now in tick
-    body_t *body = scene_get_body(scene, index);
-    body_remove(body);
-    list_remove(scene->bodies, index);
-    body_free(body);
+    // Goes through update() so the body's forces are dropped with it
+    body_remove(scene_get_body(scene, index));
+    update(scene);
 }
 
 // Deprecated
@@ -60,16 +61,40 @@ void scene_add_bodies_force_creator(
     free_func_t freer
 ){
   force_t *force = force_init(forcer, aux, bodies, freer);
+  for(size_t i = 0; i < list_size(bodies); i++){
+    body_link_force(list_get(bodies, i), force);
+  }
   list_add(scene->forces, force);
 }
 
+// Every force in a scene comes from here; a single bullet adds over a thousand.
+// Made on first use and freed at exit.
+pool_t *FORCE_POOL = NULL;
+
+void force_pool_free(void){
+  pool_free(FORCE_POOL);
+  FORCE_POOL = NULL;
+}
+
+pool_t *force_pool(void){
+  if(FORCE_POOL == NULL){
+    FORCE_POOL = pool_init(sizeof(force_t), FORCE_SLAB);
+    atexit(force_pool_free);
+  }
+  return FORCE_POOL;
+}
+
+pool_stats_t force_pool_stats(void){
+  return pool_stats(force_pool());
+}
+
 force_t *force_init(force_creator_t func, void *aux, list_t *bodies, free_func_t aux_freer){
-  force_t *force = malloc(sizeof(force_t));
-  assert(force != NULL);
+  force_t *force = pool_alloc(force_pool());
   force->func = *func;
   force->aux = aux;
   force->aux_free = aux_freer;
   force->bodies = bodies;
+  force->dead = false;
   return force;
 }
 
@@ -77,45 +102,73 @@ void force_free(void *force){
   // Shouldn't free bodies
   free_func_t freer = ((force_t *)force)->aux_free;
   freer(((force_t *)force)->aux);
-  free(((force_t *)force));
+  pool_release(force_pool(), force);
 }
 
-bool force_is_removed(force_t *force, body_t *rem){
-  list_t *f = force->bodies;
-  for(size_t i = 0; i < list_size(f); i++){
-    if((body_t *)list_get(f, i) == rem){
-      return true;
+// Marks every force acting on a removed body. Returns whether any body is removed.
+bool mark_dead_forces(list_t *bodies){
+  bool any = false;
+  for(size_t i = 0; i < list_size(bodies); i++){
+    body_t *body = (body_t *)list_get(bodies, i);
+    if(body_is_removed(body)){
+      list_t *links = body_get_links(body);
+      for(size_t j = 0; links != NULL && j < list_size(links); j++){
+        ((force_t *)list_get(links, j))->dead = true;
+      }
+      any = true;
     }
   }
-  return false;
+  return any;
 }
 
-
-void update(scene_t *scene){
-  list_t *bodies = scene->bodies;
-  list_t *forces = scene->forces;
-  int b_ind = 0;
-  while(b_ind < list_size(bodies)){
-    body_t *temp = (body_t *)list_get(bodies, b_ind);
-    if(body_is_removed(temp)){
-      int f_ind = 0;
-      while(f_ind < list_size(forces)){
-        if(force_is_removed((force_t *)list_get(forces, f_ind), temp)){
-          force_free(list_remove(forces, f_ind));
-        }
-        else{
-          f_ind++;
-        }
+// Frees dead forces and slides live ones down over them, in one pass.
+void compact_forces(list_t *forces){
+  size_t keep = 0;
+  for(size_t i = 0; i < list_size(forces); i++){
+    force_t *force = (force_t *)list_get(forces, i);
+    if(!force->dead){
+      list_replace(forces, keep++, force);
+      continue;
+    }
+    // surviving bodies still link to it; removed ones are freed next
+    list_t *f_bodies = force->bodies;
+    for(size_t j = 0; j < list_size(f_bodies); j++){
+      body_t *body = (body_t *)list_get(f_bodies, j);
+      if(!body_is_removed(body)){
+        body_unlink_force(body, force);
       }
-      body_free(list_remove(bodies, b_ind));
     }
-    else{
-      b_ind++;
+    force_free(force);
+  }
+  list_truncate(forces, keep);
+}
+
+// Frees removed bodies and slides the rest down over them, in one pass, so
+// bodies stay in the order they were added (which is the order they draw in).
+void compact_bodies(list_t *bodies){
+  size_t keep = 0;
+  for(size_t i = 0; i < list_size(bodies); i++){
+    body_t *body = (body_t *)list_get(bodies, i);
+    if(!body_is_removed(body)){
+      list_replace(bodies, keep++, body);
+      continue;
     }
+    body_free(body);
+  }
+  list_truncate(bodies, keep);
+}
+
+void update(scene_t *scene){
+  list_t *bodies = scene->bodies;
+  if(!mark_dead_forces(bodies)){
+    return;
   }
+  compact_forces(scene->forces);
+  compact_bodies(bodies);
 }
 
 void scene_tick(scene_t *scene, double dt) {
+    PROFILE_ZONE("scene_tick");
     update(scene);
     list_t *forces = scene->forces;
     for(size_t i = 0; i < list_size(forces); i++){
@@ -124,6 +177,7 @@ void scene_tick(scene_t *scene, double dt) {
       void *aux = force->aux;
       func(aux);
     }
+    counter_add(COUNTER_FORCES_RUN, list_size(forces));
     for (size_t i = 0; i < scene_bodies(scene); i++) {
         body_tick(scene_get_body(scene, i), dt);
     }
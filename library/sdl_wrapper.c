@@ -1,85 +1,185 @@
 #include "sdl_wrapper.h"
+#include "asset_pack.h"
+#include "profiler.h"
+#include <limits.h>
 
 const char WINDOW_TITLE[] = "CS 3";
 // square!!
 const int WINDOW_WIDTH = 1500;
 const int WINDOW_HEIGHT = 1500;
 const double MS_PER_S = 1e3;
-double zoom;
+// for sdl_frame_checksum()
+const uint64_t FRAME_FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FRAME_FNV_PRIME = 1099511628211ULL;
+// The HUD text updates, as seen by the simulation (see renderer.h).
+const renderer_t SDL_HUD = {update_money, update_bullets, update_stamina,
+                            sdl_background_invalidate};
 const char *FREE_SANS = "fonts/FreeSans.ttf";
 const char *OPEN_SANS_LIGHT = "fonts/open-sans/OpenSans-Light.ttf";
 const int FONT_SIZE = 50;
-TTF_Font *FONT;
-const SDL_Color FONT_BLACK = {0, 0, 0};
-const SDL_Color FONT_BLUE = {19,178,214};
-const SDL_Color TILT_RED = {255,0,0};
-const SDL_Color VICTORY_GREEN = {184,19,214};
-const char *PLAYER_IMAGE = "images/adam.jpg";
-const int PLAYER_X = 697;
-const int PLAYER_Y = 375;
-const int PLAYER_W = 45;
-const int PLAYER_H = 45;
-
-const char *ALIEN_IMAGE = "images/alien.jpeg";
-const double ALIEN_RADIUS = 22.5;
-const int ALIEN_W = 45;
-const int ALIEN_H = 45;
-
-const char *LOCKER_IMAGE = "images/locker.jpeg";
-const double LOCKER_RADIUS = 28.125;
-
-const char *DUMPSTER_IMAGE = "images/dumpster.jpeg";
-const double DUMPSTER_RADIUS = 28.125;
-
-const char *COIN_IMAGE = "images/coin.png";
-const double COIN_RADIUS = 8.375;
-
-const char *WALL_IMAGE = "images/wall.jpeg";
-const double WALL_RADIUS = 28.125;
-
-const char *DOOR_IMAGE = "images/door.jpeg";
-const double DOOR_RADIUS = 28.125;
-
-SDL_Surface *SURFACE;
-SDL_Texture *TEXTURE;
-SDL_Rect RECT;
-char MONEY[20];
-char STAMINA[10];
-char BULLETS[10];
+const int OVERLAY_FONT_SIZE = 20;
+// Decoded images and glyphs from bin/pack_assets, used when present and
+// up to date instead of decoding images/ and rasterizing fonts/.
+const char *ASSET_PACK = "assets.pack";
+// text is drawn by tinting white glyphs, so these need to be opaque
+const SDL_Color FONT_BLACK = {0, 0, 0, 255};
+const SDL_Color FONT_BLUE = {19,178,214, 255};
+const SDL_Color TILT_RED = {255,0,0, 255};
+const SDL_Color VICTORY_GREEN = {184,19,214, 255};
+// Sprite sizes in grid cells (see sdl_set_cell_grid()), so they zoom with
+// the scene and match the bodies they stand for.
+const double PLAYER_W = 0.8;
+const double PLAYER_H = 0.8;
+const double ALIEN_RADIUS = 0.4;
+const double LOCKER_RADIUS = 0.5;
+const double DUMPSTER_RADIUS = 0.5;
+const double COIN_RADIUS = 0.15;
+const double WALL_RADIUS = 0.5;
+const double DOOR_RADIUS = 0.5;
 
-SDL_Surface *SURFACE_PLAYER;
-SDL_Texture *TEXTURE_PLAYER;
-SDL_Rect RECT_PLAYER;
+// Every sprite, in its slot in the atlas.
+typedef enum sprite {
+  SPRITE_PLAYER,
+  SPRITE_ALIEN,
+  SPRITE_LOCKER,
+  SPRITE_DUMPSTER,
+  SPRITE_COIN,
+  SPRITE_WALL,
+  SPRITE_DOOR,
+  NUM_SPRITES
+} sprite_t;
 
-SDL_Surface *SURFACE_ALIEN;
-SDL_Texture *TEXTURE_ALIEN;
-SDL_Rect RECT_ALIEN;
+const char *SPRITE_IMAGES[NUM_SPRITES] = {
+  [SPRITE_PLAYER] = "images/adam.jpg",
+  [SPRITE_ALIEN] = "images/alien.jpeg",
+  [SPRITE_LOCKER] = "images/locker.jpeg",
+  [SPRITE_DUMPSTER] = "images/dumpster.jpeg",
+  [SPRITE_COIN] = "images/coin.png",
+  [SPRITE_WALL] = "images/wall.jpeg",
+  [SPRITE_DOOR] = "images/door.jpeg"};
+// Each image is scaled into a square cell of the atlas. Sprites are drawn
+// square and at most ~60 px, so this keeps detail for zooming in while the
+// atlas stays small (the source images are up to 1790 px).
+const int SPRITE_CELL = 256;
+const SDL_Color SPRITE_TINT = {255, 255, 255, 255};
 
-SDL_Surface *SURFACE_LOCKER;
-SDL_Texture *TEXTURE_LOCKER;
-SDL_Rect RECT_LOCKER;
+// Textured quads waiting to be drawn with one SDL_RenderGeometry() call,
+// 4 vertices and 6 indices (two triangles) each. The arrays grow as needed
+// and are kept between frames.
+typedef struct quad_batch {
+  SDL_Texture *texture;
+  SDL_Vertex *vertices;
+  int *indices;
+  size_t count;
+  size_t capacity;
+} quad_batch_t;
 
-SDL_Surface *SURFACE_DUMPSTER;
-SDL_Texture *TEXTURE_DUMPSTER;
-SDL_Rect RECT_DUMPSTER;
+// All sprites packed into one texture, so a frame's sprites are one draw.
+SDL_Texture *ATLAS;
+// Sprites queued since the last flush_sprites().
+quad_batch_t SPRITES = {NULL, NULL, NULL, 0, 0};
 
-SDL_Surface *SURFACE_COIN;
-SDL_Texture *TEXTURE_COIN;
+// Untextured convex polygons, as triangle fans, queued since the last
+// flush_sprites(); like quad_batch_t, but any number of vertices each.
+// window_points holds one polygon's vertices while they are mapped.
+typedef struct polygon_batch {
+  SDL_Vertex *vertices;
+  int *indices;
+  size_t num_vertices;
+  size_t num_indices;
+  size_t vertex_capacity;
+  size_t index_capacity;
+  SDL_FPoint *window_points;
+  vector_t *scene_points;
+} polygon_batch_t;
+polygon_batch_t POLYGONS = {NULL, NULL, 0, 0, 0, 0, NULL, NULL};
+// Subtracted from sprite positions, to draw into the background cache.
+vector_t sprite_offset = {0, 0};
 
-SDL_Surface *SURFACE_WALL;
-SDL_Texture *TEXTURE_WALL;
+// The static background (see sdl_render_background()): drawn by
+// background_drawer into BACKGROUND, which covers the window plus
+// BACKGROUND_MARGIN of its size on every side, so small moves only blit.
+const double BACKGROUND_MARGIN = 0.5;
+SDL_Texture *BACKGROUND = NULL;
+background_drawer_t background_drawer = NULL;
+void *background_aux;
+bool background_valid = false;
+// what the cache was drawn for: the scene point at its middle, the scale,
+// and its size in pixels
+vector_t background_center;
+double background_scale;
+int background_w = 0;
+int background_h = 0;
+// the scene rectangle to redraw before the next blit, if any
+bool background_dirty = false;
+vector_t background_dirty_min;
+vector_t background_dirty_max;
 
-SDL_Surface *SURFACE_DOOR;
-SDL_Texture *TEXTURE_DOOR;
+// The grid at one texel per cell (see sdl_set_cell_grid()), drawn instead
+// of the images when zoomed out, and as the minimap. cell_pixels holds
+// the same texels, with those in cell_dirty_rect not yet uploaded.
+SDL_Texture *CELL_MAP = NULL;
+SDL_Color *cell_pixels = NULL;
+int cell_rows = 0;
+int cell_cols = 0;
+double cell_size = 0;
+bool cell_dirty = false;
+SDL_Rect cell_dirty_rect;
+// cells drawn smaller than this many pixels across are drawn from CELL_MAP
+const double LOD_CELL_PIXELS = 8;
+// gap between the minimap and the window's edges, and its backdrop
+const int MINIMAP_MARGIN = 10;
+const SDL_Color MINIMAP_BACKDROP = {0, 0, 0, 160};
+const SDL_Color MINIMAP_VIEW = {255, 255, 255, 255};
+
+// A font rasterized once: every printable ASCII glyph, in white, side by
+// side in one texture. Text is then just quads from it, tinted.
+enum { GLYPH_FIRST = ' ', GLYPH_LAST = '~', NUM_GLYPHS = GLYPH_LAST - GLYPH_FIRST + 1 };
+typedef struct glyph_atlas {
+  SDL_Texture *texture;
+  int width;
+  int height;
+  int line_skip;
+  SDL_Rect glyphs[NUM_GLYPHS];
+  int advances[NUM_GLYPHS];
+} glyph_atlas_t;
+const SDL_Color GLYPH_WHITE = {255, 255, 255, 255};
+glyph_atlas_t HUD_GLYPHS;
+glyph_atlas_t OVERLAY_GLYPHS;
+// The HUD line's quads, laid out again only when a value on it changes
+// or it moves. The values it shows, to spot when they change.
+quad_batch_t HUD_TEXT = {NULL, NULL, NULL, 0, 0};
+bool hud_dirty = true;
+int hud_x = 0;
+int hud_y = 0;
+int hud_money = 0;
+int hud_stamina = -1;
+int hud_bullets = -1;
+// Other text, drawn as soon as it is laid out.
+quad_batch_t TEXT = {NULL, NULL, NULL, 0, 0};
+char MONEY[20];
+char STAMINA[10];
+char BULLETS[10];
 
 /**
- * The coordinate at the center of the screen.
- */
-vector_t center;
-/**
- * The coordinate difference from the center to the top right corner.
+ * How scene coordinates map to the window. The transform is worked out
+ * again only when the center, zoom or window size changes (see
+ * camera_update()), not for every point drawn.
  */
-vector_t max_diff;
+typedef struct camera {
+    // the scene point at the middle of the window
+    vector_t center;
+    // the scene distance from the center to the top right corner at zoom 1
+    vector_t extent;
+    double zoom;
+    // the middle of the window, in pixels
+    vector_t window_center;
+    // pixels per scene unit
+    double scale;
+    // pixel = (m[0][0] x + m[0][1] y + m[0][2], m[1][0] x + m[1][1] y + m[1][2])
+    double m[2][3];
+} camera_t;
+camera_t camera;
 /**
  * The SDL window where the scene is rendered.
  */
@@ -88,6 +188,10 @@ SDL_Window *window;
  * The renderer used to draw the scene.
  */
 SDL_Renderer *renderer;
+/**
+ * What the renderer draws into with BACKEND_OFFSCREEN, or NULL.
+ */
+SDL_Surface *framebuffer = NULL;
 /**
  * The keypress handler, or NULL if none has been configured.
  */
@@ -98,23 +202,16 @@ key_handler_t key_handler = NULL;
  */
 uint32_t key_start_timestamp;
 /**
- * The value of clock() when time_since_last_tick() was last called.
+ * The performance counter when time_since_last_tick() was last called.
  * Initially 0.
  */
-clock_t last_clock = 0;
+uint64_t last_tick = 0;
 
 // ///////
 
-/** Computes the center of the window in pixel coordinates */
+/** The center of the window in pixel coordinates, as of the last resize */
 vector_t get_window_center() {
-    int *width = malloc(sizeof(*width)), *height = malloc(sizeof(*height));
-    assert(width != NULL);
-    assert(height != NULL);
-    SDL_GetWindowSize(window, width, height);
-    vector_t dimensions = {.x = *width, .y = *height};
-    free(width);
-    free(height);
-    return vec_multiply(0.5, dimensions);
+    return camera.window_center;
 }
 
 /**
@@ -124,21 +221,53 @@ vector_t get_window_center() {
  */
 double get_scene_scale(vector_t window_center) {
     // Scale scene so it fits entirely in the window
+    vector_t max_diff = vec_multiply(camera.zoom, camera.extent);
     double x_scale = window_center.x / max_diff.x, y_scale = window_center.y / max_diff.y;
     return x_scale < y_scale ? x_scale : y_scale;
 }
 
-/** Maps a scene coordinate to a window coordinate */
-vector_t get_window_position(vector_t scene_pos, vector_t window_center) {
-    // Scale scene coordinates by the scaling factor
-    // and map the center of the scene to the center of the window
-    vector_t scene_center_offset = vec_subtract(scene_pos, center);
-    double scale = get_scene_scale(window_center);
-    vector_t pixel_center_offset = vec_multiply(scale, scene_center_offset);
-    vector_t pixel = {.x = round(window_center.x + pixel_center_offset.x),
-                      // Flip y axis since positive y is down on the screen
-                      .y = round(window_center.y - pixel_center_offset.y)};
-    return pixel;
+/** Works out the camera's scale and transform again */
+void camera_update(void) {
+    double scale = get_scene_scale(camera.window_center);
+    camera.scale = scale;
+    // Scale about the center, which goes to the middle of the window,
+    // and flip the y axis since positive y is down on the screen
+    camera.m[0][0] = scale;
+    camera.m[0][1] = 0;
+    camera.m[0][2] = camera.window_center.x - scale * camera.center.x;
+    camera.m[1][0] = 0;
+    camera.m[1][1] = -scale;
+    camera.m[1][2] = camera.window_center.y + scale * camera.center.y;
+}
+
+/** Reads the window's size again, after it is created or resized */
+void camera_resize(void) {
+    int width, height;
+    if (framebuffer != NULL) {
+        width = framebuffer->w;
+        height = framebuffer->h;
+    } else {
+        SDL_GetWindowSize(window, &width, &height);
+    }
+    camera.window_center = (vector_t){width / 2.0, height / 2.0};
+    camera_update();
+}
+
+/** Maps a scene coordinate to a window coordinate, rounded to a pixel */
+vector_t get_window_position(vector_t scene_pos) {
+    return (vector_t){
+        round(camera.m[0][0] * scene_pos.x + camera.m[0][1] * scene_pos.y + camera.m[0][2]),
+        round(camera.m[1][0] * scene_pos.x + camera.m[1][1] * scene_pos.y + camera.m[1][2])};
+}
+
+void sdl_scene_to_window(const vector_t *scene, SDL_FPoint *pixels, size_t n) {
+    // copied out so the compiler knows the stores can't change them
+    double m00 = camera.m[0][0], m01 = camera.m[0][1], m02 = camera.m[0][2];
+    double m10 = camera.m[1][0], m11 = camera.m[1][1], m12 = camera.m[1][2];
+    for (size_t i = 0; i < n; i++) {
+        pixels[i].x = m00 * scene[i].x + m01 * scene[i].y + m02;
+        pixels[i].y = m10 * scene[i].x + m11 * scene[i].y + m12;
+    }
 }
 
 /**
@@ -162,33 +291,75 @@ char get_keycode(SDL_Keycode key) {
     }
 }
 
+void sdl_get_view(vector_t *min, vector_t *max){
+  double scale = camera.scale;
+  vector_t half = vec_multiply(1 / scale, camera.window_center);
+  // pad by the largest image so ones straddling the edge are still drawn
+  double pad = WALL_RADIUS * cell_size;
+  half = vec_add(half, (vector_t){pad, pad});
+  *min = vec_subtract(camera.center, half);
+  *max = vec_add(camera.center, half);
+}
+
 void sdl_update_center(vector_t center_n){
-  center = center_n;
+  camera.center = center_n;
+  camera_update();
 }
 
 void sdl_update_zoom(double zoom_n){
-  zoom = zoom_n;
-  max_diff = vec_multiply(zoom, max_diff);
+  camera.zoom = zoom_n;
+  camera_update();
 }
 
 void sdl_init(vector_t min, vector_t max) {
+    sdl_init_backend(min, max, BACKEND_WINDOW);
+}
+
+void sdl_init_backend(vector_t min, vector_t max, render_backend_t backend) {
     // Check parameters
     assert(min.x < max.x);
     assert(min.y < max.y);
-    zoom = 1;
-    center = vec_multiply(0.5, vec_add(min, max));
-    max_diff = vec_multiply(zoom, vec_subtract(max, center));
-    SDL_Init(SDL_INIT_EVERYTHING);
-    window =
-        SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                         WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_RESIZABLE);
-    renderer = SDL_CreateRenderer(window, -1, 0);
+    camera.zoom = 1;
+    camera.center = vec_multiply(0.5, vec_add(min, max));
+    camera.extent = vec_subtract(max, camera.center);
+    if (backend == BACKEND_OFFSCREEN) {
+        // no SDL_Init(): video would fail without a display, and drawing
+        // into a surface needs none of the subsystems
+        window = NULL;
+        framebuffer = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT,
+                                                     32, SDL_PIXELFORMAT_RGBA32);
+        assert(framebuffer != NULL);
+        renderer = SDL_CreateSoftwareRenderer(framebuffer);
+    } else {
+        SDL_Init(SDL_INIT_EVERYTHING);
+        window =
+            SDL_CreateWindow(WINDOW_TITLE, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                             WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_RESIZABLE);
+        renderer = SDL_CreateRenderer(window, -1, 0);
+    }
+    assert(renderer != NULL);
+    camera_resize();
     MONEY[0] = '$'; // *MONEY = "$0";
     MONEY[1] = '0';
     STAMINA[0] = '1'; // *STAMINA = "100";
     STAMINA[1] = '0';
     STAMINA[2] = '0';
     BULLETS[0] = '5'; // *BULLETS = "5";
+    renderer_set(&SDL_HUD);
+}
+
+uint64_t sdl_frame_checksum(void) {
+    assert(framebuffer != NULL);
+    uint64_t hash = FRAME_FNV_OFFSET;
+    size_t row = (size_t)framebuffer->w * 4;
+    for (int y = 0; y < framebuffer->h; y++) {
+        const unsigned char *pixels =
+            (const unsigned char *)framebuffer->pixels + (size_t)y * framebuffer->pitch;
+        for (size_t i = 0; i < row; i++) {
+            hash = (hash ^ pixels[i]) * FRAME_FNV_PRIME;
+        }
+    }
+    return hash;
 }
 
 bool sdl_is_done(scene_t *scene, void *aux) {
@@ -199,6 +370,11 @@ bool sdl_is_done(scene_t *scene, void *aux) {
             case SDL_QUIT:
                 free(event);
                 return true;
+            case SDL_WINDOWEVENT:
+                if (event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                    camera_resize();
+                }
+                break;
             case SDL_KEYDOWN:
             case SDL_KEYUP:
                 // Skip the keypress if no handler is configured
@@ -223,53 +399,185 @@ bool sdl_is_done(scene_t *scene, void *aux) {
 }
 
 void sdl_clear(void) {
+    // anything queued was meant for the frame being cleared
+    SPRITES.count = 0;
+    POLYGONS.num_vertices = 0;
+    POLYGONS.num_indices = 0;
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
 }
 
-void sdl_draw_polygon(list_t *points, rgb_color_t color) {
-    // Check parameters
-    size_t n = list_size(points);
+// Adds a quad to the batch. corners go clockwise from the top left, and
+// uv is the part of the batch's texture to show, from 0 to 1.
+void batch_quad(quad_batch_t *batch, const SDL_FPoint corners[4], SDL_FRect uv,
+                SDL_Color color){
+  if(batch->count == batch->capacity){
+    batch->capacity = batch->capacity ? batch->capacity * 2 : 256;
+    batch->vertices = realloc(batch->vertices, sizeof(*batch->vertices) * 4 * batch->capacity);
+    batch->indices = realloc(batch->indices, sizeof(*batch->indices) * 6 * batch->capacity);
+    assert(batch->vertices != NULL);
+    assert(batch->indices != NULL);
+  }
+  const float TEX[4][2] = {{uv.x, uv.y}, {uv.x + uv.w, uv.y},
+                           {uv.x + uv.w, uv.y + uv.h}, {uv.x, uv.y + uv.h}};
+  SDL_Vertex *vertex = &batch->vertices[4 * batch->count];
+  for(int i = 0; i < 4; i++){
+    vertex[i].position = corners[i];
+    vertex[i].color = color;
+    vertex[i].tex_coord.x = TEX[i][0];
+    vertex[i].tex_coord.y = TEX[i][1];
+  }
+  int first = 4 * batch->count;
+  int *index = &batch->indices[6 * batch->count];
+  index[0] = first;
+  index[1] = first + 1;
+  index[2] = first + 2;
+  index[3] = first;
+  index[4] = first + 2;
+  index[5] = first + 3;
+  batch->count++;
+}
+
+// Draws the batch's quads, keeping them.
+void batch_draw(quad_batch_t *batch){
+  if(batch->count > 0){
+    SDL_RenderGeometry(renderer, batch->texture, batch->vertices, 4 * batch->count,
+                       batch->indices, 6 * batch->count);
+  }
+}
+
+// Draws the batch's quads and empties it.
+void batch_flush(quad_batch_t *batch){
+  batch_draw(batch);
+  batch->count = 0;
+}
+
+void batch_free(quad_batch_t *batch){
+  free(batch->vertices);
+  free(batch->indices);
+  *batch = (quad_batch_t){NULL, NULL, NULL, 0, 0};
+}
+
+/**
+ * Makes room in the polygon batch for a polygon with n vertices.
+ * Like the other batches, it only ever grows, so after the first few
+ * frames this does nothing.
+ */
+void polygon_batch_reserve(polygon_batch_t *batch, size_t n) {
+    if (batch->num_vertices + n > batch->vertex_capacity) {
+        size_t capacity = batch->vertex_capacity ? batch->vertex_capacity * 2 : 1024;
+        while (capacity < batch->num_vertices + n) {
+            capacity *= 2;
+        }
+        batch->vertices = realloc(batch->vertices, sizeof(*batch->vertices) * capacity);
+        batch->window_points = realloc(batch->window_points,
+                                       sizeof(*batch->window_points) * capacity);
+        batch->scene_points = realloc(batch->scene_points,
+                                      sizeof(*batch->scene_points) * capacity);
+        assert(batch->vertices != NULL);
+        assert(batch->window_points != NULL);
+        assert(batch->scene_points != NULL);
+        batch->vertex_capacity = capacity;
+    }
+    // a fan of n vertices is n - 2 triangles
+    size_t indices = 3 * (n - 2);
+    if (batch->num_indices + indices > batch->index_capacity) {
+        size_t capacity = batch->index_capacity ? batch->index_capacity * 2 : 3072;
+        while (capacity < batch->num_indices + indices) {
+            capacity *= 2;
+        }
+        batch->indices = realloc(batch->indices, sizeof(*batch->indices) * capacity);
+        assert(batch->indices != NULL);
+        batch->index_capacity = capacity;
+    }
+}
+
+/**
+ * Queues a convex polygon, moved by offset (in scene coordinates), as a
+ * fan of triangles from its first vertex.
+ */
+void batch_polygon(polygon_batch_t *batch, const vector_t *points, size_t n,
+                   vector_t offset, rgb_color_t color) {
     assert(n >= 3);
     assert(0 <= color.r && color.r <= 255);
     assert(0 <= color.g && color.g <= 255);
     assert(0 <= color.b && color.b <= 255);
+    // sprites queued so far go underneath
+    batch_flush(&SPRITES);
+    polygon_batch_reserve(batch, n);
+    sdl_scene_to_window(points, batch->window_points, n);
+    // the offset only needs the linear part of the transform
+    float dx = camera.m[0][0] * offset.x + camera.m[0][1] * offset.y;
+    float dy = camera.m[1][0] * offset.x + camera.m[1][1] * offset.y;
+    SDL_Color fill = {color.r, color.g, color.b, 255};
+    int first = batch->num_vertices;
+    SDL_Vertex *vertex = &batch->vertices[first];
+    for (size_t i = 0; i < n; i++) {
+        vertex[i].position.x = batch->window_points[i].x + dx;
+        vertex[i].position.y = batch->window_points[i].y + dy;
+        vertex[i].color = fill;
+        vertex[i].tex_coord = (SDL_FPoint){0, 0};
+    }
+    int *index = &batch->indices[batch->num_indices];
+    for (size_t i = 1; i + 1 < n; i++) {
+        *index++ = first;
+        *index++ = first + i;
+        *index++ = first + i + 1;
+    }
+    batch->num_vertices += n;
+    batch->num_indices += 3 * (n - 2);
+}
 
-    vector_t window_center = get_window_center();
+// Draws every queued polygon and empties the batch.
+void flush_polygons(void) {
+    if (POLYGONS.num_indices > 0) {
+        SDL_RenderGeometry(renderer, NULL, POLYGONS.vertices, POLYGONS.num_vertices,
+                           POLYGONS.indices, POLYGONS.num_indices);
+    }
+    POLYGONS.num_vertices = 0;
+    POLYGONS.num_indices = 0;
+}
 
-    // Convert each vertex to a point on screen
-    int16_t *x_points = malloc(sizeof(*x_points) * n),
-            *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points != NULL);
-    assert(y_points != NULL);
+void sdl_draw_polygon(list_t *points, rgb_color_t color) {
+    size_t n = list_size(points);
+    assert(n >= 3);
+    // the list holds pointers, so copy the vertices out to map them at once
+    polygon_batch_reserve(&POLYGONS, n);
     for (size_t i = 0; i < n; i++) {
-        vector_t *vertex = list_get(points, i);
-        vector_t pixel = get_window_position(*vertex, window_center);
-        x_points[i] = pixel.x;
-        y_points[i] = pixel.y;
+        POLYGONS.scene_points[i] = *(vector_t *)list_get(points, i);
     }
+    batch_polygon(&POLYGONS, POLYGONS.scene_points, n, VEC_ZERO, color);
+}
 
-    // Draw polygon with the given color
-    filledPolygonRGBA(renderer, x_points, y_points, n, color.r * 1, color.g * 1,
-                      color.b * 1, 255);
-    free(x_points);
-    free(y_points);
+void sdl_draw_points(const vector_t *points, size_t n, vector_t offset,
+                     rgb_color_t color) {
+    batch_polygon(&POLYGONS, points, n, offset, color);
 }
 
 void sdl_show(void) {
+    flush_sprites();
     SDL_RenderPresent(renderer);
 }
 
 // stop obj rendering here if you want to put img instead
 void sdl_render_scene(scene_t *scene) {
+    PROFILE_ZONE("sdl_render_scene");
+    vector_t view_min, view_max;
+    sdl_get_view(&view_min, &view_max);
     size_t body_count = scene_bodies(scene);
     for (size_t i = 0; i < body_count; i++) {
         body_t *body = scene_get_body(scene, i);
-        if(strcmp(body_get_info(body), "player") != 0 && strcmp(body_get_info(body), "alien") != 0 && strcmp(body_get_info(body), "dumpster") != 0 && strcmp(body_get_info(body), "locker") != 0 && strcmp(body_get_info(body), "coin") != 0 && strcmp(body_get_info(body), "wall") != 0 && strcmp(body_get_info(body), "door") != 0){
-        // if(strcmp(body_get_info(body), "bullet") == 0){
-          list_t *shape = body_get_shape(body);
-          sdl_draw_polygon(shape, body_get_color(body));
-          list_free(shape);
+        // bodies drawn as images are hidden; the rest only if on screen
+        if (body_is_hidden(body)) {
+            continue;
+        }
+        vector_t centroid = body_get_centroid(body);
+        if (centroid.x >= view_min.x && centroid.x <= view_max.x &&
+            centroid.y >= view_min.y && centroid.y <= view_max.y) {
+          // drawn from the body's own vertices, where it is now
+          vec_list_t *points = body_get_points(body);
+          batch_polygon(&POLYGONS, vec_list_data(points), vec_list_size(points),
+                        VEC_ZERO, body_get_color(body));
         }
     }
     sdl_show();
@@ -280,208 +588,636 @@ void sdl_on_key(key_handler_t handler) {
 }
 
 double time_since_last_tick(void) {
-    clock_t now = clock();
-    double difference = last_clock ? (double)(now - last_clock) / CLOCKS_PER_SEC
-                                   : 0.0; // return 0 the first time this is called
-    last_clock = now;
+    // a wall clock: clock() counts CPU time, which stops while sleeping
+    uint64_t now = SDL_GetPerformanceCounter();
+    double difference = last_tick ? (double)(now - last_tick) / SDL_GetPerformanceFrequency()
+                                  : 0.0; // return 0 the first time this is called
+    last_tick = now;
     return difference;
 }
 
-void make_rect(int x, int y, int w, int h){
-  RECT.x = x;  //controls the rect's x coordinate
-  RECT.y = y; // controls the rect's y coordinte
-  RECT.w = w; // controls the width of the rect
-  RECT.h = h; // controls the height of the rect
+bool sdl_set_vsync(bool vsync) {
+    return SDL_RenderSetVSync(renderer, vsync) == 0;
+}
+
+// Rasterizes a font's glyphs side by side into one white RGBA sheet, and
+// fills in the atlas's metrics (not its texture).
+SDL_Surface *glyph_sheet(glyph_atlas_t *atlas, TTF_Font *font){
+  assert(font != NULL);
+  SDL_Surface *glyphs[NUM_GLYPHS];
+  atlas->width = 0;
+  atlas->height = 0;
+  for(int i = 0; i < NUM_GLYPHS; i++){
+    // NULL for glyphs with nothing to draw, like the space
+    glyphs[i] = TTF_RenderGlyph_Blended(font, GLYPH_FIRST + i, GLYPH_WHITE);
+    int minx, maxx, miny, maxy;
+    TTF_GlyphMetrics(font, GLYPH_FIRST + i, &minx, &maxx, &miny, &maxy, &atlas->advances[i]);
+    int w = glyphs[i] != NULL ? glyphs[i]->w : 0;
+    int h = glyphs[i] != NULL ? glyphs[i]->h : 0;
+    atlas->glyphs[i] = (SDL_Rect){atlas->width, 0, w, h};
+    atlas->width += w;
+    atlas->height = h > atlas->height ? h : atlas->height;
+  }
+  SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height,
+                                                      32, SDL_PIXELFORMAT_RGBA32);
+  assert(sheet != NULL);
+  for(int i = 0; i < NUM_GLYPHS; i++){
+    if(glyphs[i] != NULL){
+      SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+      SDL_BlitSurface(glyphs[i], NULL, sheet, &atlas->glyphs[i]);
+      SDL_FreeSurface(glyphs[i]);
+    }
+  }
+  atlas->line_skip = TTF_FontLineSkip(font);
+  return sheet;
+}
+
+// The names of a font's glyph sheet and metrics in the asset pack, e.g.
+// "fonts/FreeSans.ttf@20" and "fonts/FreeSans.ttf@20.metrics".
+void glyph_asset_names(const char *font, int size, char *sheet, char *metrics){
+  snprintf(sheet, ASSET_NAME_SIZE, "%s@%d", font, size);
+  snprintf(metrics, ASSET_NAME_SIZE, "%s@%d.metrics", font, size);
+}
+
+// An atlas's metrics as stored in the asset pack: the line skip, then x, y,
+// w, h and advance of each glyph.
+enum { GLYPH_METRICS = 1 + 5 * NUM_GLYPHS };
+
+void glyph_metrics_pack(glyph_atlas_t *atlas, int32_t metrics[GLYPH_METRICS]){
+  metrics[0] = atlas->line_skip;
+  for(int i = 0; i < NUM_GLYPHS; i++){
+    SDL_Rect glyph = atlas->glyphs[i];
+    int32_t *m = &metrics[1 + 5 * i];
+    m[0] = glyph.x;
+    m[1] = glyph.y;
+    m[2] = glyph.w;
+    m[3] = glyph.h;
+    m[4] = atlas->advances[i];
+  }
+}
+
+// Unpacks metrics into atlas, returning whether every glyph lies within a
+// sheet of width by height pixels.
+bool glyph_metrics_unpack(glyph_atlas_t *atlas, const int32_t metrics[GLYPH_METRICS],
+                          uint32_t width, uint32_t height){
+  atlas->line_skip = metrics[0];
+  for(int i = 0; i < NUM_GLYPHS; i++){
+    const int32_t *m = &metrics[1 + 5 * i];
+    if(m[0] < 0 || m[1] < 0 || m[2] < 0 || m[3] < 0
+       || (int64_t)m[0] + m[2] > width || (int64_t)m[1] + m[3] > height){
+      return false;
+    }
+    atlas->glyphs[i] = (SDL_Rect){m[0], m[1], m[2], m[3]};
+    atlas->advances[i] = m[4];
+  }
+  return true;
+}
+
+// Makes a texture straight from RGBA32 pixels, with no surface in between.
+SDL_Texture *texture_from_pixels(const void *pixels, int w, int h, int pitch){
+  SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                           SDL_TEXTUREACCESS_STATIC, w, h);
+  assert(texture != NULL);
+  SDL_UpdateTexture(texture, NULL, pixels, pitch);
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  return texture;
+}
+
+// Loads the atlas for a font at a size: from the asset pack if it has it,
+// otherwise by rasterizing the font.
+void glyph_atlas_init(glyph_atlas_t *atlas, asset_pack_t *pack, const char *font, int size){
+  char sheet_name[ASSET_NAME_SIZE], metrics_name[ASSET_NAME_SIZE];
+  glyph_asset_names(font, size, sheet_name, metrics_name);
+  asset_t sheet, metrics;
+  if(asset_pack_find_image(pack, sheet_name, &sheet)
+     && sheet.width <= INT_MAX / 4 && sheet.height <= INT_MAX
+     && asset_pack_find(pack, metrics_name, &metrics)
+     && metrics.size == GLYPH_METRICS * sizeof(int32_t)
+     && glyph_metrics_unpack(atlas, metrics.data, sheet.width, sheet.height)){
+    atlas->width = sheet.width;
+    atlas->height = sheet.height;
+    atlas->texture = texture_from_pixels(sheet.data, sheet.width, sheet.height, sheet.width * 4);
+    return;
+  }
+  if(!TTF_WasInit()){
+    TTF_Init();
+  }
+  TTF_Font *ttf = TTF_OpenFont(font, size);
+  SDL_Surface *surface = glyph_sheet(atlas, ttf);
+  atlas->texture = texture_from_pixels(surface->pixels, surface->w, surface->h, surface->pitch);
+  SDL_FreeSurface(surface);
+  TTF_CloseFont(ttf);
+}
+
+void glyph_atlas_free(glyph_atlas_t *atlas){
+  SDL_DestroyTexture(atlas->texture);
+  atlas->texture = NULL;
+}
+
+// Adds text to batch as one quad per glyph, with its top left corner at
+// (x, y). A '\n' starts a new line; other unprintable characters are skipped.
+void layout_text(quad_batch_t *batch, glyph_atlas_t *atlas, const char *text,
+                 int x, int y, SDL_Color color){
+  float pen_x = x, pen_y = y;
+  for(const char *ch = text; *ch != '\0'; ch++){
+    if(*ch == '\n'){
+      pen_x = x;
+      pen_y += atlas->line_skip;
+      continue;
+    }
+    if(*ch < GLYPH_FIRST || *ch > GLYPH_LAST){
+      continue;
+    }
+    int i = *ch - GLYPH_FIRST;
+    SDL_Rect glyph = atlas->glyphs[i];
+    if(glyph.w > 0){
+      SDL_FPoint corners[4] = {{pen_x, pen_y}, {pen_x + glyph.w, pen_y},
+                               {pen_x + glyph.w, pen_y + glyph.h}, {pen_x, pen_y + glyph.h}};
+      SDL_FRect uv = {(float)glyph.x / atlas->width, 0, (float)glyph.w / atlas->width,
+                      (float)glyph.h / atlas->height};
+      batch_quad(batch, corners, uv, color);
+    }
+    pen_x += atlas->advances[i];
+  }
+}
+
+// Draws text right away, in one batch.
+void draw_text(glyph_atlas_t *atlas, const char *text, int x, int y, SDL_Color color){
+  flush_sprites();
+  TEXT.texture = atlas->texture;
+  layout_text(&TEXT, atlas, text, x, y, color);
+  batch_flush(&TEXT);
 }
 
 void message_init(){
-  TTF_Init(); // initialize TTF
-  FONT = TTF_OpenFont(OPEN_SANS_LIGHT, FONT_SIZE); // opens font style and sets size
+  asset_pack_t *pack = asset_pack_open(ASSET_PACK);
+  glyph_atlas_init(&HUD_GLYPHS, pack, OPEN_SANS_LIGHT, FONT_SIZE);
+  glyph_atlas_init(&OVERLAY_GLYPHS, pack, FREE_SANS, OVERLAY_FONT_SIZE);
+  if(pack != NULL){
+    asset_pack_close(pack);
+  }
+  HUD_TEXT.texture = HUD_GLYPHS.texture;
+  hud_dirty = true;
 }
 
-// assuming that rect does not change places or size
 void replace_text(){
-  char *money_label = "MONEY: ";
-  char *stamina_label = " . STAMINA: ";
-  char *bullets_label = " . BULLETS: ";
-  char text[strlen(money_label) + strlen(MONEY) + strlen(stamina_label) + strlen(STAMINA) + strlen(bullets_label) + strlen(BULLETS) + 1];
-  strcpy(text, money_label);
-  strcat(text, MONEY);
-  strcat(text, stamina_label);
-  strcat(text, STAMINA);
-  strcat(text, bullets_label);
-  strcat(text, BULLETS);
-  assert(text != NULL);
-  if(SURFACE != NULL){    // free any existing surface
-    SDL_FreeSurface(SURFACE);
-  }
-  SURFACE = TTF_RenderText_Blended(FONT, text, FONT_BLUE); // creates surface from char
-  if(TEXTURE != NULL){   // free any existing texture
-    SDL_DestroyTexture(TEXTURE);
-  }
-  TEXTURE = SDL_CreateTextureFromSurface(renderer, SURFACE);  // creates texture from surface
+  char text[64];
+  snprintf(text, sizeof(text), "MONEY: %s . STAMINA: %s . BULLETS: %s",
+           MONEY, STAMINA, BULLETS);
+  HUD_TEXT.count = 0;
+  layout_text(&HUD_TEXT, &HUD_GLYPHS, text, hud_x, hud_y, FONT_BLUE);
+  hud_dirty = false;
 }
 
 // pass in purse money value
 void update_money(int money){
+  if(money == hud_money){
+    return;
+  }
+  hud_money = money;
   snprintf(MONEY, 20, "$%d", money);
-  replace_text();
+  hud_dirty = true;
 }
 
 // pass in % stamina left: 100 = 100, 50 = 0
+// (called every tick the player moves or rests, so usually a no-op)
 void update_stamina(int stamina){
+  if(stamina == hud_stamina){
+    return;
+  }
+  hud_stamina = stamina;
   snprintf(STAMINA, 10, "%d%%", stamina);
-  replace_text();
+  hud_dirty = true;
 }
 
 void update_bullets(int bullets){
+  if(bullets == hud_bullets){
+    return;
+  }
+  hud_bullets = bullets;
   snprintf(BULLETS, 10, "%d", bullets);
-  replace_text();
+  hud_dirty = true;
 }
 
 void render_text(int x, int y){
-  int width = 0;
-  int height = 0;
-  SDL_QueryTexture(TEXTURE, NULL, NULL, &width, &height); // set rectange to dimension of text
-  make_rect(x, y, width, height);
-  SDL_RenderCopy(renderer, TEXTURE, NULL, &RECT); // show gameloop there is text that needs to be rendered
+  flush_sprites();
+  if(hud_dirty || x != hud_x || y != hud_y){
+    hud_x = x;
+    hud_y = y;
+    replace_text();
+  }
+  batch_draw(&HUD_TEXT);
+}
+
+void render_overlay(const char *text, int x, int y){
+  draw_text(&OVERLAY_GLYPHS, text, x, y, FONT_BLACK);
 }
 
 void message_free(){
-  TTF_CloseFont(FONT);
-  TTF_Quit();
+  glyph_atlas_free(&HUD_GLYPHS);
+  glyph_atlas_free(&OVERLAY_GLYPHS);
+  batch_free(&HUD_TEXT);
+  batch_free(&TEXT);
+  if(TTF_WasInit()){
+    TTF_Quit();
+  }
 }
 
-void images_init(){
-  SURFACE_PLAYER = IMG_Load(PLAYER_IMAGE);
-  TEXTURE_PLAYER = SDL_CreateTextureFromSurface(renderer, SURFACE_PLAYER);
+// Decodes a sprite's image and scales it into a SPRITE_CELL square.
+SDL_Surface *sprite_image(sprite_t sprite){
+  SDL_Surface *cell = SDL_CreateRGBSurfaceWithFormat(0, SPRITE_CELL, SPRITE_CELL,
+                                                     32, SDL_PIXELFORMAT_RGBA32);
+  assert(cell != NULL);
+  SDL_Surface *image = IMG_Load(SPRITE_IMAGES[sprite]);
+  assert(image != NULL);
+  // convert first so the jpegs get an opaque alpha channel, then copy
+  // (not blend) into the cell
+  SDL_Surface *rgba = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_RGBA32, 0);
+  assert(rgba != NULL);
+  SDL_SetSurfaceBlendMode(rgba, SDL_BLENDMODE_NONE);
+  SDL_BlitScaled(rgba, NULL, cell, NULL);
+  SDL_FreeSurface(rgba);
+  SDL_FreeSurface(image);
+  return cell;
+}
 
-  SURFACE_ALIEN = IMG_Load(ALIEN_IMAGE);;
-  TEXTURE_ALIEN = SDL_CreateTextureFromSurface(renderer, SURFACE_ALIEN);;
+void images_init(){
+  ATLAS = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                            SPRITE_CELL * NUM_SPRITES, SPRITE_CELL);
+  assert(ATLAS != NULL);
+  SDL_SetTextureBlendMode(ATLAS, SDL_BLENDMODE_BLEND);
+  asset_pack_t *pack = asset_pack_open(ASSET_PACK);
+  for(int i = 0; i < NUM_SPRITES; i++){
+    SDL_Rect cell = {i * SPRITE_CELL, 0, SPRITE_CELL, SPRITE_CELL};
+    asset_t asset;
+    // the packed pixels go to the texture straight from the mapped file
+    if(asset_pack_find_image(pack, SPRITE_IMAGES[i], &asset)
+       && asset.width == SPRITE_CELL && asset.height == SPRITE_CELL){
+      SDL_UpdateTexture(ATLAS, &cell, asset.data, SPRITE_CELL * 4);
+    }
+    else{
+      SDL_Surface *image = sprite_image(i);
+      SDL_UpdateTexture(ATLAS, &cell, image->pixels, image->pitch);
+      SDL_FreeSurface(image);
+    }
+  }
+  if(pack != NULL){
+    asset_pack_close(pack);
+  }
+  SPRITES.texture = ATLAS;
+}
 
-  SURFACE_LOCKER = IMG_Load(LOCKER_IMAGE);
-  TEXTURE_LOCKER = SDL_CreateTextureFromSurface(renderer, SURFACE_LOCKER);
+// Adds a font's glyph sheet and metrics at a size to a pack.
+void pack_font(asset_pack_writer_t *writer, const char *font, int size){
+  char sheet_name[ASSET_NAME_SIZE], metrics_name[ASSET_NAME_SIZE];
+  glyph_asset_names(font, size, sheet_name, metrics_name);
+  TTF_Font *ttf = TTF_OpenFont(font, size);
+  glyph_atlas_t atlas;
+  SDL_Surface *sheet = glyph_sheet(&atlas, ttf);
+  int32_t metrics[GLYPH_METRICS];
+  glyph_metrics_pack(&atlas, metrics);
+  asset_pack_add_image(writer, sheet_name, sheet->w, sheet->h, sheet->pixels, sheet->pitch);
+  asset_pack_add_data(writer, metrics_name, metrics, sizeof(metrics));
+  SDL_FreeSurface(sheet);
+  TTF_CloseFont(ttf);
+}
 
-  SURFACE_DUMPSTER = IMG_Load(DUMPSTER_IMAGE);
-  TEXTURE_DUMPSTER = SDL_CreateTextureFromSurface(renderer, SURFACE_DUMPSTER);
+bool sdl_write_asset_pack(const char *path){
+  asset_pack_writer_t *writer = asset_pack_writer_init();
+  for(int i = 0; i < NUM_SPRITES; i++){
+    SDL_Surface *image = sprite_image(i);
+    asset_pack_add_image(writer, SPRITE_IMAGES[i], image->w, image->h, image->pixels,
+                         image->pitch);
+    SDL_FreeSurface(image);
+  }
+  TTF_Init();
+  pack_font(writer, OPEN_SANS_LIGHT, FONT_SIZE);
+  pack_font(writer, FREE_SANS, OVERLAY_FONT_SIZE);
+  TTF_Quit();
+  bool written = asset_pack_write(writer, path);
+  asset_pack_writer_free(writer);
+  return written;
+}
 
-  SURFACE_COIN = IMG_Load(COIN_IMAGE);
-  TEXTURE_COIN = SDL_CreateTextureFromSurface(renderer, SURFACE_COIN);
+// Queues a sprite with its center at pixel (x, y), turned clockwise by angle
+// degrees (like SDL_RenderCopyEx()).
+void queue_sprite(sprite_t sprite, double x, double y, double w, double h, double angle){
+  // polygons queued so far go underneath
+  flush_polygons();
+  double cos_a = 1, sin_a = 0;
+  if(angle != 0){
+    cos_a = cos(angle * M_PI / 180);
+    sin_a = sin(angle * M_PI / 180);
+  }
+  const double CORNERS[4][2] = {{-0.5, -0.5}, {0.5, -0.5}, {0.5, 0.5}, {-0.5, 0.5}};
+  SDL_FPoint corners[4];
+  for(int i = 0; i < 4; i++){
+    double dx = CORNERS[i][0] * w, dy = CORNERS[i][1] * h;
+    corners[i].x = x + dx * cos_a - dy * sin_a;
+    corners[i].y = y + dx * sin_a + dy * cos_a;
+  }
+  SDL_FRect uv = {(float)sprite / NUM_SPRITES, 0, 1.0f / NUM_SPRITES, 1};
+  batch_quad(&SPRITES, corners, uv, SPRITE_TINT);
+}
 
-  SURFACE_WALL = IMG_Load(WALL_IMAGE);
-  TEXTURE_WALL = SDL_CreateTextureFromSurface(renderer, SURFACE_WALL);
+// Pixels across one grid cell at the current zoom.
+double sprite_cell_pixels(void){
+  return cell_size * camera.scale;
+}
 
-  SURFACE_DOOR = IMG_Load(DOOR_IMAGE);
-  TEXTURE_DOOR = SDL_CreateTextureFromSurface(renderer, SURFACE_DOOR);
+// Queues a sprite centered on a scene position, radius cells in size.
+void queue_sprite_at(sprite_t sprite, vector_t location, double radius){
+  vector_t pos = vec_subtract(get_window_position(location),
+                              sprite_offset);
+  double size = 2 * radius * sprite_cell_pixels();
+  queue_sprite(sprite, pos.x, pos.y, size, size, 0);
+}
 
+void flush_sprites(void){
+  // only one of the two is ever pending, as queueing either flushes the other
+  batch_flush(&SPRITES);
+  flush_polygons();
 }
 
 void render_player_image(double angle){
-  RECT_PLAYER.x = get_window_center().x - PLAYER_W / 2;
-  RECT_PLAYER.y = get_window_center().y - PLAYER_H / 2;
-  RECT_PLAYER.w = PLAYER_W;
-  RECT_PLAYER.h = PLAYER_H;
-  SDL_RenderCopyEx(renderer, TEXTURE_PLAYER, NULL, &RECT_PLAYER, angle, NULL, SDL_FLIP_NONE);
+  queue_sprite(SPRITE_PLAYER, camera.window_center.x, camera.window_center.y,
+               PLAYER_W * sprite_cell_pixels(), PLAYER_H * sprite_cell_pixels(),
+               angle);
 }
 
 void render_alien_image(vector_t location){
-  vector_t alien_pos = get_window_position(location, get_window_center());
-  RECT_ALIEN.x = (alien_pos.x) - ALIEN_RADIUS;
-  RECT_ALIEN.y = (alien_pos.y) - ALIEN_RADIUS;
-  RECT_ALIEN.w = ALIEN_W;
-  RECT_ALIEN.h = ALIEN_H;
-  SDL_RenderCopy(renderer, TEXTURE_ALIEN, NULL, &RECT_ALIEN);
+  queue_sprite_at(SPRITE_ALIEN, location, ALIEN_RADIUS);
 }
 
 void render_locker_image(vector_t location){
-  vector_t locker_pos = get_window_position(location, get_window_center());
-  RECT_LOCKER.x = (locker_pos.x) - LOCKER_RADIUS;
-  RECT_LOCKER.y = (locker_pos.y) - LOCKER_RADIUS;
-  RECT_LOCKER.w = LOCKER_RADIUS * 2;
-  RECT_LOCKER.h = LOCKER_RADIUS * 2;
-  SDL_RenderCopy(renderer, TEXTURE_LOCKER, NULL, &RECT_LOCKER);
+  queue_sprite_at(SPRITE_LOCKER, location, LOCKER_RADIUS);
 }
 
 void render_dumpster_image(vector_t location){
-  vector_t dumpster_pos = get_window_position(location, get_window_center());
-  RECT_DUMPSTER.x = (dumpster_pos.x) - DUMPSTER_RADIUS;
-  RECT_DUMPSTER.y = (dumpster_pos.y) - DUMPSTER_RADIUS;
-  RECT_DUMPSTER.w = DUMPSTER_RADIUS * 2;
-  RECT_DUMPSTER.h = DUMPSTER_RADIUS * 2;
-  SDL_RenderCopy(renderer, TEXTURE_DUMPSTER, NULL, &RECT_DUMPSTER);
+  queue_sprite_at(SPRITE_DUMPSTER, location, DUMPSTER_RADIUS);
 }
 
 void render_coin_image(vector_t location){
-  vector_t coin_pos = get_window_position(location, get_window_center());
-  SDL_Rect rect_coin;
-  rect_coin.x = (coin_pos.x) - COIN_RADIUS;
-  rect_coin.y = (coin_pos.y) - COIN_RADIUS;
-  rect_coin.w = COIN_RADIUS * 2;
-  rect_coin.h = COIN_RADIUS * 2;
-  SDL_RenderCopy(renderer, TEXTURE_COIN, NULL, &rect_coin);
+  queue_sprite_at(SPRITE_COIN, location, COIN_RADIUS);
 }
 
 void render_wall_image(vector_t location){
-  vector_t wall_pos = get_window_position(location, get_window_center());
-  SDL_Rect rect_wall;
-  rect_wall.x = (wall_pos.x) - WALL_RADIUS;
-  rect_wall.y = (wall_pos.y) - WALL_RADIUS;
-  rect_wall.w = WALL_RADIUS * 2;
-  rect_wall.h = WALL_RADIUS * 2;
-  SDL_RenderCopy(renderer, TEXTURE_WALL, NULL, &rect_wall);
+  queue_sprite_at(SPRITE_WALL, location, WALL_RADIUS);
 }
 
 void render_door_image(vector_t location){
-  vector_t door_pos = get_window_position(location, get_window_center());
-  SDL_Rect rect_door;
-  rect_door.x = (door_pos.x) - DOOR_RADIUS;
-  rect_door.y = (door_pos.y) - DOOR_RADIUS;
-  rect_door.w = DOOR_RADIUS * 2;
-  rect_door.h = DOOR_RADIUS * 2;
-  SDL_RenderCopy(renderer, TEXTURE_DOOR, NULL, &rect_door);
+  queue_sprite_at(SPRITE_DOOR, location, DOOR_RADIUS);
 }
 
-void image_free(){
-  SDL_FreeSurface(SURFACE_PLAYER);
-  SDL_DestroyTexture(TEXTURE_PLAYER);
-  SDL_FreeSurface(SURFACE_ALIEN);
-  SDL_DestroyTexture(TEXTURE_ALIEN);
-  SDL_FreeSurface(SURFACE_LOCKER);
-  SDL_DestroyTexture(TEXTURE_LOCKER);
-  SDL_FreeSurface(SURFACE_DUMPSTER);
-  SDL_DestroyTexture(TEXTURE_DUMPSTER);
-  SDL_FreeSurface(SURFACE_COIN);
-  SDL_DestroyTexture(TEXTURE_COIN);
-  SDL_FreeSurface(SURFACE_WALL);
-  SDL_DestroyTexture(TEXTURE_WALL);
-  SDL_FreeSurface(SURFACE_DOOR);
-  SDL_DestroyTexture(TEXTURE_DOOR);
+// Where the background cache's top left corner is in the window.
+vector_t background_origin(void){
+  vector_t middle = get_window_position(background_center);
+  return (vector_t){middle.x - background_w / 2, middle.y - background_h / 2};
 }
 
-void win_message(){
-  char text[30];
-  strcpy(text, "YOU SURVIVED!");
-  if(SURFACE != NULL){    // free any existing surface
-    SDL_FreeSurface(SURFACE);
+// Redraws the part of the background cache in clip (all of it if NULL),
+// drawing whatever is in the scene from min to max.
+void background_redraw(SDL_Rect *clip, vector_t min, vector_t max){
+  flush_sprites();
+  SDL_SetRenderTarget(renderer, BACKGROUND);
+  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+  if(clip == NULL){
+    SDL_RenderClear(renderer);
   }
-  SURFACE = TTF_RenderText_Blended(FONT, text, VICTORY_GREEN); // creates surface from char
-  if(TEXTURE != NULL){   // free any existing texture
-    SDL_DestroyTexture(TEXTURE);
+  else{
+    // clear to transparent, rather than blending transparent over it
+    SDL_RenderSetClipRect(renderer, clip);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_RenderFillRect(renderer, clip);
   }
-  TEXTURE = SDL_CreateTextureFromSurface(renderer, SURFACE);  // creates texture from surface
-  render_text(0,0);
+  sprite_offset = background_origin();
+  background_drawer(min, max, background_aux);
+  flush_sprites();
+  sprite_offset = VEC_ZERO;
+  SDL_RenderSetClipRect(renderer, NULL);
+  SDL_SetRenderTarget(renderer, NULL);
 }
 
-void lose_message(){
-  char text[30];
-  strcpy(text, "You died...get good.");
-  if(SURFACE != NULL){    // free any existing surface
-    SDL_FreeSurface(SURFACE);
+// Draws the whole background cache again, centered on the view.
+void background_rebuild(vector_t window_center){
+  int w = 2 * window_center.x * (1 + 2 * BACKGROUND_MARGIN);
+  int h = 2 * window_center.y * (1 + 2 * BACKGROUND_MARGIN);
+  if(BACKGROUND == NULL || w != background_w || h != background_h){
+    if(BACKGROUND != NULL){
+      SDL_DestroyTexture(BACKGROUND);
+    }
+    BACKGROUND = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                   SDL_TEXTUREACCESS_TARGET, w, h);
+    assert(BACKGROUND != NULL);
+    SDL_SetTextureBlendMode(BACKGROUND, SDL_BLENDMODE_BLEND);
+    background_w = w;
+    background_h = h;
   }
-  SURFACE = TTF_RenderText_Blended(FONT, text, TILT_RED); // creates surface from char
-  if(TEXTURE != NULL){   // free any existing texture
-    SDL_DestroyTexture(TEXTURE);
+  background_center = camera.center;
+  background_scale = camera.scale;
+  // pad by the largest image so ones straddling the edge are drawn
+  double pad = WALL_RADIUS * cell_size;
+  vector_t half = {w / 2 / background_scale + pad, h / 2 / background_scale + pad};
+  background_redraw(NULL, vec_subtract(camera.center, half), vec_add(camera.center, half));
+  background_valid = true;
+  background_dirty = false;
+}
+
+void sdl_set_background(background_drawer_t drawer, void *aux){
+  background_drawer = drawer;
+  background_aux = aux;
+  background_valid = false;
+}
+
+void sdl_background_invalidate(vector_t min, vector_t max){
+  if(!background_dirty){
+    background_dirty_min = min;
+    background_dirty_max = max;
+    background_dirty = true;
+    return;
+  }
+  background_dirty_min.x = fmin(background_dirty_min.x, min.x);
+  background_dirty_min.y = fmin(background_dirty_min.y, min.y);
+  background_dirty_max.x = fmax(background_dirty_max.x, max.x);
+  background_dirty_max.y = fmax(background_dirty_max.y, max.y);
+}
+
+void sdl_render_background(void){
+  PROFILE_ZONE("sdl_render_background");
+  if(background_drawer == NULL){
+    return;
+  }
+  vector_t window_center = camera.window_center;
+  vector_t origin = background_origin();
+  // rebuild if the zoom or window changed, or the view left the cache
+  if(!background_valid || background_scale != camera.scale
+     || background_w != (int)(2 * window_center.x * (1 + 2 * BACKGROUND_MARGIN))
+     || background_h != (int)(2 * window_center.y * (1 + 2 * BACKGROUND_MARGIN))
+     || origin.x > 0 || origin.y > 0
+     || origin.x + background_w < 2 * window_center.x
+     || origin.y + background_h < 2 * window_center.y){
+    background_rebuild(window_center);
+    origin = background_origin();
+  }
+  else if(background_dirty){
+    // clear what the changed images covered, and redraw every image
+    // that reaches into that
+    double pad = WALL_RADIUS * cell_size;
+    vector_t top_left = get_window_position(
+        (vector_t){background_dirty_min.x - pad, background_dirty_max.y + pad});
+    vector_t bottom_right = get_window_position(
+        (vector_t){background_dirty_max.x + pad, background_dirty_min.y - pad});
+    SDL_Rect clip = {top_left.x - origin.x, top_left.y - origin.y,
+                     bottom_right.x - top_left.x, bottom_right.y - top_left.y};
+    vector_t reach = {2 * pad, 2 * pad};
+    background_redraw(&clip, vec_subtract(background_dirty_min, reach),
+                      vec_add(background_dirty_max, reach));
+    background_dirty = false;
+  }
+  flush_sprites();
+  SDL_Rect source = {-origin.x, -origin.y, 2 * window_center.x, 2 * window_center.y};
+  SDL_RenderCopy(renderer, BACKGROUND, &source, NULL);
+}
+
+void sdl_set_cell_grid(int rows, int cols, double size){
+  assert(rows > 0 && cols > 0 && size > 0);
+  if(CELL_MAP != NULL){
+    SDL_DestroyTexture(CELL_MAP);
+  }
+  CELL_MAP = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                               SDL_TEXTUREACCESS_STREAMING, cols, rows);
+  assert(CELL_MAP != NULL);
+  SDL_SetTextureBlendMode(CELL_MAP, SDL_BLENDMODE_BLEND);
+  // one texel is one cell, with hard edges
+  SDL_SetTextureScaleMode(CELL_MAP, SDL_ScaleModeNearest);
+  free(cell_pixels);
+  cell_pixels = calloc(rows * cols, sizeof(SDL_Color));
+  assert(cell_pixels != NULL);
+  cell_rows = rows;
+  cell_cols = cols;
+  cell_size = size;
+  cell_dirty_rect = (SDL_Rect){0, 0, cols, rows};
+  cell_dirty = true;
+}
+
+// Sets a cell's texel, growing the rectangle to upload if it changed.
+void cell_map_set(int r, int c, SDL_Color color){
+  assert(0 <= r && r < cell_rows && 0 <= c && c < cell_cols);
+  // row 0 is at the bottom of the scene but the top of the texture
+  int y = cell_rows - 1 - r;
+  SDL_Color *texel = &cell_pixels[y * cell_cols + c];
+  if(texel->r == color.r && texel->g == color.g && texel->b == color.b
+     && texel->a == color.a){
+    return;
+  }
+  *texel = color;
+  if(!cell_dirty){
+    cell_dirty_rect = (SDL_Rect){c, y, 1, 1};
+    cell_dirty = true;
+    return;
+  }
+  int x_min = fmin(cell_dirty_rect.x, c);
+  int y_min = fmin(cell_dirty_rect.y, y);
+  int x_max = fmax(cell_dirty_rect.x + cell_dirty_rect.w, c + 1);
+  int y_max = fmax(cell_dirty_rect.y + cell_dirty_rect.h, y + 1);
+  cell_dirty_rect = (SDL_Rect){x_min, y_min, x_max - x_min, y_max - y_min};
+}
+
+void sdl_set_cell_color(int r, int c, rgb_color_t color){
+  cell_map_set(r, c, (SDL_Color){color.r, color.g, color.b, 255});
+}
+
+void sdl_clear_cell(int r, int c){
+  cell_map_set(r, c, (SDL_Color){0, 0, 0, 0});
+}
+
+// Uploads the texels changed since the last upload, if any.
+void cell_map_upload(void){
+  if(!cell_dirty){
+    return;
+  }
+  SDL_Rect *rect = &cell_dirty_rect;
+  SDL_UpdateTexture(CELL_MAP, rect, cell_pixels + rect->y * cell_cols + rect->x,
+                    cell_cols * sizeof(SDL_Color));
+  cell_dirty = false;
+}
+
+bool sdl_cells_coarse(void){
+  return CELL_MAP != NULL && camera.scale * cell_size < LOD_CELL_PIXELS;
+}
+
+void sdl_render_cells(void){
+  PROFILE_ZONE("sdl_render_cells");
+  if(CELL_MAP == NULL){
+    return;
   }
-  TEXTURE = SDL_CreateTextureFromSurface(renderer, SURFACE);  // creates texture from surface
-  render_text(0,0);
+  cell_map_upload();
+  flush_sprites();
+  // from the top left corner of the grid to the bottom right
+  vector_t corners[2] = {{0, cell_rows * cell_size}, {cell_cols * cell_size, 0}};
+  SDL_FPoint window[2];
+  sdl_scene_to_window(corners, window, 2);
+  SDL_FRect dest = {window[0].x, window[0].y, window[1].x - window[0].x,
+                    window[1].y - window[0].y};
+  SDL_RenderCopyF(renderer, CELL_MAP, NULL, &dest);
+}
+
+void sdl_render_minimap(int size){
+  PROFILE_ZONE("sdl_render_minimap");
+  if(CELL_MAP == NULL){
+    return;
+  }
+  cell_map_upload();
+  flush_sprites();
+  SDL_Rect map = {0, MINIMAP_MARGIN, size, size * cell_rows / cell_cols};
+  map.x = 2 * camera.window_center.x - size - MINIMAP_MARGIN;
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(renderer, MINIMAP_BACKDROP.r, MINIMAP_BACKDROP.g,
+                         MINIMAP_BACKDROP.b, MINIMAP_BACKDROP.a);
+  SDL_RenderFillRect(renderer, &map);
+  SDL_RenderCopy(renderer, CELL_MAP, NULL, &map);
+  // outline what the window shows, cut to the minimap
+  vector_t view_min, view_max;
+  sdl_get_view(&view_min, &view_max);
+  double per_x = map.w / (cell_cols * cell_size);
+  double per_y = map.h / (cell_rows * cell_size);
+  double left = fmax(map.x + view_min.x * per_x, map.x);
+  double right = fmin(map.x + view_max.x * per_x, map.x + map.w);
+  double top = fmax(map.y + map.h - view_max.y * per_y, map.y);
+  double bottom = fmin(map.y + map.h - view_min.y * per_y, map.y + map.h);
+  if(left < right && top < bottom){
+    SDL_Rect view = {left, top, right - left, bottom - top};
+    SDL_SetRenderDrawColor(renderer, MINIMAP_VIEW.r, MINIMAP_VIEW.g,
+                           MINIMAP_VIEW.b, MINIMAP_VIEW.a);
+    SDL_RenderDrawRect(renderer, &view);
+  }
+}
+
+void image_free(){
+  if(CELL_MAP != NULL){
+    SDL_DestroyTexture(CELL_MAP);
+    CELL_MAP = NULL;
+  }
+  free(cell_pixels);
+  cell_pixels = NULL;
+  if(BACKGROUND != NULL){
+    SDL_DestroyTexture(BACKGROUND);
+    BACKGROUND = NULL;
+  }
+  background_valid = false;
+  SDL_DestroyTexture(ATLAS);
+  batch_free(&SPRITES);
+  free(POLYGONS.vertices);
+  free(POLYGONS.indices);
+  free(POLYGONS.window_points);
+  free(POLYGONS.scene_points);
+  POLYGONS = (polygon_batch_t){NULL, NULL, 0, 0, 0, 0, NULL, NULL};
+}
+
+void win_message(){
+  draw_text(&HUD_GLYPHS, "YOU SURVIVED!", 0, 0, VICTORY_GREEN);
+}
+
+void lose_message(){
+  draw_text(&HUD_GLYPHS, "You died...get good.", 0, 0, TILT_RED);
 }
@@ -0,0 +1,242 @@
+#include "session.h"
+#include "body.h"
+#include "collision.h"
+#include "forces.h"
+#include "list.h"
+#include "profiler.h"
+#include "vector.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+const vector_t SESSION_ALIEN_OFFSET = {100, 100};
+const int STALK_RADIUS_EASY = 20;
+const int STALK_RADIUS_MEDIUM = 15;
+const int STALK_RADIUS_HARD = 10;
+const double PLAYER_VEL = 100;
+const double PLAYER_ANG = M_PI / 2;
+const double STAMINA_RATE = .03;
+const int MAX_STAMINA = 100;
+const int MIN_STAMINA = 50;
+const int START_EXPLOSIVES = 5;
+
+const rgb_color_t C_EXP = {255, 0, 0}; // red
+const double B_ELAS = 10;
+const double WIDTH_BULLET = 2;
+const double LENGTH_BULLET = 4;
+const int BULLET_SIDES = 4; // Rectangle
+const double B_MASS = 20;
+const double B_VEL = 200;
+// the bullet type a session starts with
+const char *START_BULLET_TYPE = "e";
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+session_t *session_init(uint64_t seed){
+  session_t *session = malloc(sizeof(session_t));
+  assert(session != NULL);
+  session->map = map_init_seeded(seed);
+  // the player starts in the middle of the map
+  vector_t start = vec_multiply(0.5, map_extent(session->map));
+  body_set_centroid(session->map->player->body, start);
+  // the alien a little way off, but still inside maps smaller than that
+  vector_t offset = {fmin(SESSION_ALIEN_OFFSET.x, start.x / 2),
+                     fmin(SESSION_ALIEN_OFFSET.y, start.y / 2)};
+  body_set_centroid(session->map->alien->body, vec_add(start, offset));
+  session->alien = ai_init_bounds(session->map);
+  session->stamina = MAX_STAMINA;
+  session->explosives = START_EXPLOSIVES;
+  session->bullet_type = START_BULLET_TYPE;
+  session->player_angle = 0.0;
+  session->tick = 0;
+  session->quit = false;
+  return session;
+}
+
+void session_free(session_t *session){
+  ai_free(session->alien);
+  map_free(session->map);
+  free(session);
+}
+
+// Regain stamina faster when hiding, but still regain some when standing still. Otherwise, lose stamina.
+void set_stamina(session_t *session){
+  PROFILE_ZONE("set_stamina");
+  map_t *map = session->map;
+  body_t *player = map->player->body;
+  vector_t cur_vel = body_get_velocity(player);
+  if(cur_vel.x == 0 && cur_vel.y == 0 && (session->stamina < MAX_STAMINA)){
+    if(is_hiding(map)){
+      session->stamina += 1.5 * STAMINA_RATE;
+    }
+    else{
+      session->stamina += STAMINA_RATE / 5;
+    }
+    hud_update_stamina(session_stamina_percent(session));
+  }
+  else if(session->stamina > MIN_STAMINA){
+    session->stamina -= STAMINA_RATE;
+    hud_update_stamina(session_stamina_percent(session));
+  }
+}
+
+int session_stamina_percent(session_t *session){
+  return (int)(100 *(session->stamina - MIN_STAMINA)/MIN_STAMINA);
+}
+
+// Make a bullet of the session's type, length by width, at the origin.
+body_t *make_bullet(session_t *session){
+  // Make bullet's points
+  list_t *points = list_init(BULLET_SIDES, vec_free);
+  vector_t *temp1 = malloc(sizeof(vector_t));
+  assert(temp1 != NULL);
+  *temp1 = (vector_t){LENGTH_BULLET / 2.0, WIDTH_BULLET / 2.0};
+  list_add(points, temp1);
+  vector_t *temp2 = malloc(sizeof(vector_t));
+  assert(temp2 != NULL);
+  *temp2 = (vector_t){LENGTH_BULLET / 2.0, - WIDTH_BULLET / 2.0};
+  list_add(points, temp2);
+  vector_t *temp3 = malloc(sizeof(vector_t));
+  assert(temp3 != NULL);
+  *temp3 = (vector_t){-LENGTH_BULLET / 2.0, -WIDTH_BULLET / 2.0};
+  list_add(points, temp3);
+  vector_t *temp4 = malloc(sizeof(vector_t));
+  assert(temp4 != NULL);
+  *temp4 = (vector_t){-LENGTH_BULLET / 2.0, WIDTH_BULLET / 2.0};
+  list_add(points, temp4);
+  // Set color, name
+  rgb_color_t col;
+  char *name = malloc(10*sizeof(char));
+  assert(name != NULL);
+  strcpy(name, session->bullet_type);
+  col = C_EXP;
+  return body_init_with_info(points, B_MASS, col, name, free);
+}
+
+// Spawns bullet, moves to correct position/orientation and adds collisions.
+void shoot(session_t *session, double angle){
+  map_t *map = session->map;
+  if(session->explosives > 0){
+    body_t *bullet = make_bullet(session);
+    // Set centroid, rotate, velocity
+    body_set_centroid(bullet, body_get_centroid(map->player->body));
+    body_set_rotation(bullet, angle);
+    vector_t vel = vec_multiply(B_VEL, vec_rotate((vector_t){1,0}, angle));
+    body_set_velocity(bullet, vel);
+    // Get rid of bullet and bounce alien back if they collide
+    session->explosives--;
+    create_physics_collision(map->scene, B_ELAS, bullet, map->alien->body, 3);
+    for(size_t i = 0; i < scene_bodies(map->scene); i++){
+      body_t *body = scene_get_body(map->scene, i);
+      // Get rid of bullet if it hits something else
+      if(strcmp((char *)body_get_info(body), "alien") != 0 && strcmp((char *)body_get_info(body), "player") != 0
+      && strcmp((char *)body_get_info(body), "g") != 0 && strcmp((char *)body_get_info(body), "e") != 0 ){
+        create_destructive_collision(map->scene, bullet, body, 1);
+      }
+    }
+    // Show it afterwards
+    scene_add_body(map->scene, bullet);
+    // Update text displaying number of bullets left
+    hud_update_bullets(session->explosives);
+  }
+}
+
+// Movement velocity is constant and then is halved once stamina reaches 0.
+void session_key(session_t *session, char key, key_event_type_t type){
+  body_t *player = session->map->player->body;
+  vector_t vx, vy;
+  if(session->stamina > MIN_STAMINA){
+    vx = (vector_t){PLAYER_VEL, 0};
+    vy = (vector_t){0, PLAYER_VEL};
+  }
+  else{
+    vx = vec_multiply(.5, (vector_t){PLAYER_VEL, 0});
+    vy = vec_multiply(.5, (vector_t){0, PLAYER_VEL});
+  }
+  // Uncomment below if speed to scale down with stamina is desired
+  // vector_t vx = vec_multiply(session->stamina / 100.0, (vector_t){PLAYER_VEL, 0});
+  // vector_t vy = vec_multiply(session->stamina / 100.0, (vector_t){0, PLAYER_VEL});
+  if (type == KEY_PRESSED) {
+    switch(key) {
+      case 'q':
+        session->quit = true;
+        break;
+      case LEFT_ARROW:
+        body_set_velocity(player, vec_negate(vx));
+        body_set_rotation(player, -2 * PLAYER_ANG);
+        session->player_angle = 270.0;
+        break;
+      case RIGHT_ARROW:
+        body_set_velocity(player, vx);
+        body_set_rotation(player, 0 * PLAYER_ANG);
+        session->player_angle = 90.0;
+        break;
+      case UP_ARROW:
+        body_set_velocity(player, vy);
+        body_set_rotation(player, PLAYER_ANG);
+        session->player_angle = 0.0;
+        break;
+      case DOWN_ARROW:
+        body_set_velocity(player, vec_negate(vy));
+        body_set_rotation(player, -1 * PLAYER_ANG);
+        session->player_angle = 180.0;
+        break;
+      // control weapon shooting with WASD, and have other keys to switch guns.
+      case 'w': // up
+        shoot(session, M_PI / 2);
+        break;
+      case 's': // down
+        shoot(session, 3 * M_PI / 2);
+        break;
+      case 'a': // left
+        shoot(session, M_PI);
+        break;
+      case 'd': // right
+        shoot(session, 0);
+        break;
+    }
+  } else{
+    body_set_velocity(player, (VEC_ZERO));
+  }
+}
+
+void session_step(session_t *session, double dt){
+  set_stamina(session);
+  ai_stalk(session->map, session->alien, STALK_RADIUS_MEDIUM, dt);
+  map_tick(session->map, dt);
+  session->tick++;
+}
+
+// Folds size bytes into an FNV-1a hash.
+uint64_t hash_bytes(uint64_t hash, const void *data, size_t size){
+  const unsigned char *bytes = data;
+  for(size_t i = 0; i < size; i++){
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+uint64_t hash_vector(uint64_t hash, vector_t v){
+  hash = hash_bytes(hash, &v.x, sizeof(v.x));
+  return hash_bytes(hash, &v.y, sizeof(v.y));
+}
+
+uint64_t session_hash(session_t *session){
+  map_t *map = session->map;
+  uint64_t hash = FNV_OFFSET;
+  int32_t purse = map->purse;
+  int32_t explosives = session->explosives;
+  uint64_t bodies = scene_bodies(map->scene);
+  hash = hash_bytes(hash, &session->tick, sizeof(session->tick));
+  hash = hash_vector(hash, body_get_centroid(map->player->body));
+  hash = hash_vector(hash, body_get_velocity(map->player->body));
+  hash = hash_vector(hash, body_get_centroid(map->alien->body));
+  hash = hash_vector(hash, body_get_velocity(map->alien->body));
+  hash = hash_bytes(hash, &purse, sizeof(purse));
+  hash = hash_bytes(hash, &session->stamina, sizeof(session->stamina));
+  hash = hash_bytes(hash, &explosives, sizeof(explosives));
+  return hash_bytes(hash, &bodies, sizeof(bodies));
+}
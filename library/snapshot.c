@@ -0,0 +1,236 @@
+#include "snapshot.h"
+#include "body.h"
+#include "scene.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+DEFINE_LIST(snapshot_polygon_list, snapshot_polygon_t)
+DEFINE_LIST(snapshot_change_list, snapshot_change_t)
+
+const size_t SNAPSHOT_POINTS = 256;
+const size_t SNAPSHOT_POLYGONS = 32;
+// background changes remembered for snapshots to copy
+#define SNAPSHOT_CHANGES 64
+// the middle slot of a snapshot_buffer_t, with a bit set when it was
+// published since the reader last took it
+const int SNAPSHOT_FRESH = 4;
+const int SNAPSHOT_INDEX = 3;
+
+struct snapshot_buffer {
+    snapshot_t snapshots[3];
+    // only the writer touches back, only the reader front and has_front
+    int back;
+    int front;
+    bool has_front;
+    atomic_int middle;
+};
+
+typedef struct key_event {
+    char key;
+    key_event_type_t type;
+} key_event_t;
+
+struct key_queue {
+    key_event_t *events;
+    size_t mask;
+    // only the pusher stores head, only the popper tail
+    atomic_size_t head;
+    atomic_size_t tail;
+};
+
+// What the simulation last told SNAPSHOT_RENDERER. Only the simulation
+// thread reads or writes these.
+int snapshot_money = -1;
+int snapshot_stamina = -1;
+int snapshot_bullets = -1;
+uint32_t snapshot_background_version = 0;
+// change number v is at v % SNAPSHOT_CHANGES
+snapshot_change_t snapshot_changes[SNAPSHOT_CHANGES];
+
+void snapshot_money_changed(int money) {
+    snapshot_money = money;
+}
+
+void snapshot_bullets_changed(int bullets) {
+    snapshot_bullets = bullets;
+}
+
+void snapshot_stamina_changed(int stamina) {
+    snapshot_stamina = stamina;
+}
+
+void snapshot_background_changed(vector_t min, vector_t max) {
+    snapshot_background_version++;
+    snapshot_changes[snapshot_background_version % SNAPSHOT_CHANGES] =
+        (snapshot_change_t){snapshot_background_version, min, max};
+}
+
+const renderer_t SNAPSHOT_RENDERER = {
+    snapshot_money_changed, snapshot_bullets_changed, snapshot_stamina_changed,
+    snapshot_background_changed};
+
+void snapshot_session_start(session_t *session) {
+    snapshot_money = session->map->purse;
+    snapshot_stamina = session_stamina_percent(session);
+    snapshot_bullets = session->explosives;
+}
+
+void snapshot_capture(snapshot_t *snapshot, session_t *session, double time) {
+    map_t *map = session->map;
+    snapshot->tick = session->tick;
+    snapshot->time = time;
+    snapshot->player_prev = body_get_interp_centroid(map->player->body, 0);
+    snapshot->player = body_get_centroid(map->player->body);
+    snapshot->player_angle = session->player_angle;
+    snapshot->alien_prev = body_get_interp_centroid(map->alien->body, 0);
+    snapshot->alien = body_get_centroid(map->alien->body);
+    snapshot->money = snapshot_money;
+    snapshot->stamina = snapshot_stamina;
+    snapshot->bullets = snapshot_bullets;
+    snapshot->background_version = snapshot_background_version;
+    if (snapshot->background_changes == NULL) {
+        snapshot->background_changes = snapshot_change_list_init(SNAPSHOT_CHANGES);
+    }
+    snapshot_change_list_clear(snapshot->background_changes);
+    uint32_t kept = snapshot_background_version < SNAPSHOT_CHANGES
+                        ? snapshot_background_version
+                        : SNAPSHOT_CHANGES;
+    for (uint32_t v = snapshot_background_version - kept + 1;
+         v <= snapshot_background_version; v++) {
+        snapshot_change_list_add(snapshot->background_changes,
+                                 snapshot_changes[v % SNAPSHOT_CHANGES]);
+    }
+    snapshot->won = map_win(map);
+    snapshot->lost = map_lose(map);
+    snapshot->quit = session->quit;
+
+    size_t cells = (size_t)map_rows(map) * map_cols(map);
+    if (snapshot->coins == NULL) {
+        snapshot->coins = malloc(cells);
+        assert(snapshot->coins != NULL);
+    }
+    snapshot->rows = map_rows(map);
+    snapshot->cols = map_cols(map);
+    memcpy(snapshot->coins, map->coin_counts, cells);
+
+    if (snapshot->points == NULL) {
+        snapshot->points = vec_list_init(SNAPSHOT_POINTS);
+        snapshot->polygons = snapshot_polygon_list_init(SNAPSHOT_POLYGONS);
+    }
+    vec_list_clear(snapshot->points);
+    snapshot_polygon_list_clear(snapshot->polygons);
+    size_t body_count = scene_bodies(map->scene);
+    for (size_t i = 0; i < body_count; i++) {
+        body_t *body = scene_get_body(map->scene, i);
+        // bodies drawn as images are hidden
+        if (body_is_hidden(body)) {
+            continue;
+        }
+        vec_list_t *points = body_get_points(body);
+        size_t n = vec_list_size(points);
+        snapshot_polygon_t polygon = {
+            vec_list_size(snapshot->points), n,
+            body_get_interp_centroid(body, 0), body_get_centroid(body),
+            body_get_color(body)};
+        for (size_t j = 0; j < n; j++) {
+            vec_list_add(snapshot->points, vec_list_get(points, j));
+        }
+        snapshot_polygon_list_add(snapshot->polygons, polygon);
+    }
+}
+
+int snapshot_coins_at(snapshot_t *snapshot, int r, int c) {
+    assert(0 <= r && r < snapshot->rows && 0 <= c && c < snapshot->cols);
+    return snapshot->coins[r * snapshot->cols + c];
+}
+
+snapshot_buffer_t *snapshot_buffer_init(void) {
+    snapshot_buffer_t *buffer = calloc(1, sizeof(snapshot_buffer_t));
+    assert(buffer != NULL);
+    buffer->back = 0;
+    atomic_init(&buffer->middle, 1);
+    buffer->front = 2;
+    buffer->has_front = false;
+    return buffer;
+}
+
+void snapshot_buffer_free(snapshot_buffer_t *buffer) {
+    for (size_t i = 0; i < 3; i++) {
+        snapshot_t *snapshot = &buffer->snapshots[i];
+        free(snapshot->coins);
+        if (snapshot->background_changes != NULL) {
+            snapshot_change_list_free(snapshot->background_changes);
+        }
+        if (snapshot->points != NULL) {
+            vec_list_free(snapshot->points);
+            snapshot_polygon_list_free(snapshot->polygons);
+        }
+    }
+    free(buffer);
+}
+
+snapshot_t *snapshot_write_begin(snapshot_buffer_t *buffer) {
+    return &buffer->snapshots[buffer->back];
+}
+
+void snapshot_publish(snapshot_buffer_t *buffer) {
+    // the release half makes the filled snapshot visible with its index,
+    // the acquire half makes sure the reader is done with the one we get
+    int old = atomic_exchange_explicit(
+        &buffer->middle, buffer->back | SNAPSHOT_FRESH, memory_order_acq_rel);
+    buffer->back = old & SNAPSHOT_INDEX;
+}
+
+snapshot_t *snapshot_read(snapshot_buffer_t *buffer) {
+    if (atomic_load_explicit(&buffer->middle, memory_order_relaxed) &
+        SNAPSHOT_FRESH) {
+        int old = atomic_exchange_explicit(&buffer->middle, buffer->front,
+                                           memory_order_acq_rel);
+        buffer->front = old & SNAPSHOT_INDEX;
+        buffer->has_front = true;
+    }
+    return buffer->has_front ? &buffer->snapshots[buffer->front] : NULL;
+}
+
+key_queue_t *key_queue_init(size_t capacity) {
+    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    key_queue_t *queue = malloc(sizeof(key_queue_t));
+    assert(queue != NULL);
+    queue->events = malloc(capacity * sizeof(key_event_t));
+    assert(queue->events != NULL);
+    queue->mask = capacity - 1;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    return queue;
+}
+
+void key_queue_free(key_queue_t *queue) {
+    free(queue->events);
+    free(queue);
+}
+
+bool key_queue_push(key_queue_t *queue, char key, key_event_type_t type) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head - tail > queue->mask) {
+        return false;
+    }
+    queue->events[head & queue->mask] = (key_event_t){key, type};
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool key_queue_pop(key_queue_t *queue, char *key, key_event_type_t *type) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail == head) {
+        return false;
+    }
+    key_event_t event = queue->events[tail & queue->mask];
+    *key = event.key;
+    *type = event.type;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
@@ -5,13 +5,24 @@ slist_t *sl_init(int size, free_func_t freer){
   slist_t *ans = malloc(sizeof(slist_t));
   // Not going to compile, add a freer
   ans->list = list_init(size, freer);
+  ans->arena = NULL;
+  return ans;
+}
+
+// Initializes a sorted list in an arena
+slist_t *sl_init_in(arena_t *arena, int size, free_func_t freer){
+  slist_t *ans = arena_alloc(arena, sizeof(slist_t));
+  ans->list = list_init_in(arena, size, freer);
+  ans->arena = arena;
   return ans;
 }
 
 // Frees a sorted list
 void sl_free(slist_t *sl){
   list_free(sl->list);
-  free(sl);
+  if(sl->arena == NULL){
+    free(sl);
+  }
 }
 
 // Enqueues the item, changing priority if necessary
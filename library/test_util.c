@@ -22,14 +22,6 @@ bool vec_isclose(vector_t v1, vector_t v2) {
     return vec_within(DEFAULT_EPSILON, v1, v2);
 }
 
-bool within(double epsilon, double d1, double d2) {
-    return fabs(d1 - d2) < epsilon;
-}
-
-bool vec_within(double epsilon, vector_t v1, vector_t v2) {
-    return within(epsilon, v1.x, v2.x) && within(epsilon, v1.y, v2.y);
-}
-
 void read_testname(char *filename, char *testname, size_t testname_size) {
     FILE *f = fopen(filename, "r");
     if (f == NULL) {
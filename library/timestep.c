@@ -0,0 +1,90 @@
+#include "timestep.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct timestep {
+    double step;
+    int max_steps;
+    double accumulator;
+    double last_time;
+    bool started;
+    size_t steps;
+    double dropped;
+} timestep_t;
+
+timestep_t *timestep_init(double rate_hz, int max_steps) {
+    assert(rate_hz > 0);
+    assert(max_steps > 0);
+    timestep_t *ts = malloc(sizeof(timestep_t));
+    assert(ts != NULL);
+    ts->step = 1.0 / rate_hz;
+    ts->max_steps = max_steps;
+    ts->accumulator = 0;
+    ts->last_time = 0;
+    ts->started = false;
+    ts->steps = 0;
+    ts->dropped = 0;
+    return ts;
+}
+
+void timestep_free(timestep_t *ts) {
+    free(ts);
+}
+
+int timestep_advance(timestep_t *ts, double frame_time) {
+    if (frame_time > 0) {
+        ts->accumulator += frame_time;
+    }
+    int steps = (int)(ts->accumulator / ts->step);
+    if (steps > ts->max_steps) {
+        // Running every owed step would make the next frame slower still,
+        // so drop the backlog past the cap instead.
+        double excess = ts->accumulator - ts->max_steps * ts->step;
+        ts->dropped += excess;
+        ts->accumulator -= excess;
+        steps = ts->max_steps;
+    }
+    ts->accumulator -= steps * ts->step;
+    if (ts->accumulator < 0) {
+        ts->accumulator = 0;
+    }
+    ts->steps += steps;
+    return steps;
+}
+
+int timestep_tick(timestep_t *ts) {
+    double now = timestep_now();
+    if (!ts->started) {
+        ts->started = true;
+        ts->last_time = now;
+        return 0;
+    }
+    double frame_time = now - ts->last_time;
+    ts->last_time = now;
+    return timestep_advance(ts, frame_time);
+}
+
+double timestep_dt(timestep_t *ts) {
+    return ts->step;
+}
+
+double timestep_alpha(timestep_t *ts) {
+    double alpha = ts->accumulator / ts->step;
+    return alpha < 1 ? alpha : 1;
+}
+
+size_t timestep_steps(timestep_t *ts) {
+    return ts->steps;
+}
+
+double timestep_dropped(timestep_t *ts) {
+    return ts->dropped;
+}
+
+double timestep_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
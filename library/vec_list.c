@@ -0,0 +1,3 @@
+#include "vec_list.h"
+
+DEFINE_LIST(vec_list, vector_t)
@@ -77,7 +77,3 @@ bool within(double epsilon, double d1, double d2) {
 bool vec_within(double epsilon, vector_t v1, vector_t v2) {
     return within(epsilon, v1.x, v2.x) && within(epsilon, v1.y, v2.y);
 }
-
-bool vec_isclose(double epsilon, vector_t v1, vector_t v2) {
-    return vec_within(epsilon, v1, v2);
-}
@@ -0,0 +1,127 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "list.h"
+#include "test_util.h"
+
+const size_t CHUNK = 256;
+
+// Tests that allocations are aligned, distinct, and counted rounded up.
+void test_alloc() {
+    arena_t *arena = arena_init(CHUNK);
+    assert(arena_used(arena) == 0 && arena_chunks(arena) == 1);
+    unsigned char *a = arena_alloc(arena, 1);
+    unsigned char *b = arena_alloc(arena, 3);
+    double *c = arena_alloc(arena, sizeof(double));
+    assert((uintptr_t)a % alignof(max_align_t) == 0);
+    assert((uintptr_t)b % alignof(max_align_t) == 0);
+    assert((uintptr_t)c % alignof(max_align_t) == 0);
+    assert(b >= a + 1 && (unsigned char *)c >= b + 3);
+    assert(arena_used(arena) == 3 * alignof(max_align_t));
+    *a = 1;
+    memset(b, 2, 3);
+    *c = 3.5;
+    assert(*a == 1 && b[2] == 2 && *c == 3.5);
+    arena_free(arena);
+}
+
+// Tests that a full chunk is followed by a new one, and that a request
+// bigger than a chunk gets its own without wasting the current one.
+void test_chunks() {
+    arena_t *arena = arena_init(CHUNK);
+    arena_alloc(arena, CHUNK);
+    assert(arena_chunks(arena) == 1);
+    arena_alloc(arena, 1);
+    assert(arena_chunks(arena) == 2);
+    unsigned char *small = arena_alloc(arena, 16);
+    unsigned char *big = arena_alloc(arena, 4 * CHUNK);
+    assert(arena_chunks(arena) == 3);
+    memset(big, 7, 4 * CHUNK);
+    // the chunk before the big one is still in use
+    unsigned char *next = arena_alloc(arena, 16);
+    assert(arena_chunks(arena) == 3);
+    assert(next == small + 16);
+    arena_free(arena);
+}
+
+// Tests that a reset keeps one chunk and hands its memory out again.
+void test_reset() {
+    arena_t *arena = arena_init(CHUNK);
+    for (int i = 0; i < 10; i++) {
+        arena_alloc(arena, CHUNK / 2);
+    }
+    arena_alloc(arena, 3 * CHUNK);
+    assert(arena_chunks(arena) > 1);
+    arena_reset(arena);
+    assert(arena_used(arena) == 0 && arena_chunks(arena) == 1);
+    void *again = arena_alloc(arena, 16);
+    assert(arena_chunks(arena) == 1);
+    // whichever chunk was kept, its memory is reused from the start
+    void *after = arena_alloc(arena, 16);
+    assert((unsigned char *)after == (unsigned char *)again + 16);
+    arena_free(arena);
+}
+
+// Tests arena_calloc() and arena_strdup().
+void test_calloc_strdup() {
+    arena_t *arena = arena_init(CHUNK);
+    unsigned char *dirty = arena_alloc(arena, 64);
+    memset(dirty, 0xff, 64);
+    arena_reset(arena);
+    unsigned char *zeroed = arena_calloc(arena, 64);
+    for (size_t i = 0; i < 64; i++) {
+        assert(zeroed[i] == 0);
+    }
+    const char *text = "dumpster";
+    char *copy = arena_strdup(arena, text);
+    assert(copy != text && strcmp(copy, text) == 0);
+    arena_free(arena);
+}
+
+size_t freed_count = 0;
+
+void count_free(void *elem) {
+    freed_count++;
+}
+
+// Tests that an arena list grows past its first capacity, and that freeing
+// it calls the freer on the elements but leaves its memory to the arena.
+void test_list_in() {
+    arena_t *arena = arena_init(CHUNK);
+    int values[100];
+    list_t *list = list_init_in(arena, 2, count_free);
+    for (int i = 0; i < 100; i++) {
+        values[i] = i;
+        list_add(list, &values[i]);
+    }
+    assert(list_size(list) == 100);
+    for (int i = 0; i < 100; i++) {
+        assert(*(int *)list_get(list, i) == i);
+    }
+    freed_count = 0;
+    list_free(list);
+    assert(freed_count == 100);
+    arena_free(arena);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_alloc)
+    DO_TEST(test_chunks)
+    DO_TEST(test_reset)
+    DO_TEST(test_calloc_strdup)
+    DO_TEST(test_list_in)
+
+    puts("arena_test PASS");
+}
@@ -0,0 +1,115 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "counters.h"
+#include "test_util.h"
+
+// Tests that a summed counter adds up within a frame and across frames.
+void test_summed() {
+    counters_reset();
+    counter_add(COUNTER_SAT_TESTS, 3);
+    counter_add(COUNTER_SAT_TESTS, 4);
+    counters_frame();
+    counter_add(COUNTER_SAT_TESTS, 5);
+    counters_frame();
+    counters_frame();
+    assert(counters_frames() == 3);
+    assert(counter_frame(COUNTER_SAT_TESTS) == 0);
+    assert(counter_frame_max(COUNTER_SAT_TESTS) == 7);
+    assert(counter_total(COUNTER_SAT_TESTS) == 12);
+    counters_reset();
+}
+
+// Tests that a peak counter keeps the largest value, within a frame and
+// across frames, rather than a sum.
+void test_peak() {
+    counters_reset();
+    counter_peak(COUNTER_ASTAR_OPEN_PEAK, 10);
+    counter_peak(COUNTER_ASTAR_OPEN_PEAK, 30);
+    counter_peak(COUNTER_ASTAR_OPEN_PEAK, 20);
+    counters_frame();
+    assert(counter_frame(COUNTER_ASTAR_OPEN_PEAK) == 30);
+    counter_peak(COUNTER_ASTAR_OPEN_PEAK, 25);
+    counters_frame();
+    assert(counter_frame(COUNTER_ASTAR_OPEN_PEAK) == 25);
+    assert(counter_frame_max(COUNTER_ASTAR_OPEN_PEAK) == 30);
+    assert(counter_total(COUNTER_ASTAR_OPEN_PEAK) == 30);
+    counter_peak(COUNTER_ASTAR_OPEN_PEAK, 40);
+    counters_frame();
+    assert(counter_total(COUNTER_ASTAR_OPEN_PEAK) == 40);
+    counters_reset();
+}
+
+// Tests that a reset zeroes everything, including a frame in progress.
+void test_reset() {
+    counter_add(COUNTER_FORCES_RUN, 9);
+    counters_frame();
+    counter_add(COUNTER_FORCES_RUN, 2);
+    counters_reset();
+    assert(counters_frames() == 0);
+    assert(counter_total(COUNTER_FORCES_RUN) == 0);
+    assert(counter_frame_max(COUNTER_FORCES_RUN) == 0);
+    counters_frame();
+    assert(counter_frame(COUNTER_FORCES_RUN) == 0);
+    counters_reset();
+}
+
+// Tests that every counter has its own name, and gets a row in the table
+// with a mean only for summed counters.
+void test_print() {
+    for (int i = 0; i < NUM_COUNTERS; i++) {
+        assert(counter_name(i) != NULL);
+        for (int j = 0; j < i; j++) {
+            assert(strcmp(counter_name(i), counter_name(j)) != 0);
+        }
+    }
+    counters_reset();
+    counter_add(COUNTER_BBOX_REJECTS, 6);
+    counter_peak(COUNTER_ASTAR_OPEN_PEAK, 6);
+    counters_frame();
+    counters_frame();
+    FILE *file = tmpfile();
+    assert(file != NULL);
+    counters_print(file);
+    rewind(file);
+    char line[128];
+    char name[64];
+    char mean[32];
+    int rows = 0;
+    // the header
+    char *read = fgets(line, sizeof(line), file);
+    assert(read != NULL);
+    while (fgets(line, sizeof(line), file) != NULL) {
+        int fields = sscanf(line, "%63s %*s %31s", name, mean);
+        assert(fields == 2);
+        assert(strcmp(name, counter_name(rows)) == 0);
+        if (rows == COUNTER_BBOX_REJECTS) {
+            assert(strcmp(mean, "3.0") == 0);
+        }
+        if (rows == COUNTER_ASTAR_OPEN_PEAK) {
+            assert(strcmp(mean, "-") == 0);
+        }
+        rows++;
+    }
+    assert(rows == NUM_COUNTERS);
+    fclose(file);
+    counters_reset();
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_summed)
+    DO_TEST(test_peak)
+    DO_TEST(test_reset)
+    DO_TEST(test_print)
+
+    puts("counters_test PASS");
+}
@@ -0,0 +1,155 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "layout.h"
+#include "test_util.h"
+
+// Writes text to a new temporary file and loads it as a map file.
+layout_t *load_text(const char *text) {
+    char path[] = "/tmp/test_layout_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    size_t length = strlen(text);
+    ssize_t written = write(fd, text, length);
+    assert(written == (ssize_t)length);
+    close(fd);
+    layout_t *layout = layout_load(path);
+    unlink(path);
+    return layout;
+}
+
+// Tests that the example in layout.h loads, with its cell size.
+void test_example() {
+    layout_t *layout = load_text("3 5 10\n#####\n#...#\n#####\n");
+    assert(layout != NULL);
+    assert(layout->rows == 3 && layout->cols == 5 && layout->cell_size == 10);
+    for (int c = 0; c < 5; c++) {
+        assert(layout_is_wall(layout, 0, c) && layout_is_wall(layout, 2, c));
+    }
+    assert(layout_is_wall(layout, 1, 0) && layout_is_wall(layout, 1, 4));
+    for (int c = 1; c < 4; c++) {
+        assert(!layout_is_wall(layout, 1, c));
+    }
+    layout_free(layout);
+}
+
+// Tests that the file's first line is the top row, which is row rows - 1.
+void test_rows_top_to_bottom() {
+    layout_t *layout = load_text("3 2\n#.\n..\n.#\n");
+    assert(layout != NULL);
+    assert(layout->cell_size == 0);
+    assert(layout_is_wall(layout, 2, 0) && !layout_is_wall(layout, 2, 1));
+    assert(!layout_is_wall(layout, 1, 0) && !layout_is_wall(layout, 1, 1));
+    assert(!layout_is_wall(layout, 0, 0) && layout_is_wall(layout, 0, 1));
+    layout_free(layout);
+}
+
+// Tests that "\r\n" line ends and a missing final line end are accepted.
+void test_line_ends() {
+    layout_t *crlf = load_text("2 3\r\n#.#\r\n...\r\n");
+    layout_t *no_final = load_text("2 3\n#.#\n...");
+    layout_t *both = load_text("2 3 7\r\n#.#\r\n...");
+    assert(crlf != NULL && no_final != NULL && both != NULL);
+    assert(both->cell_size == 7);
+    layout_t *layouts[] = {crlf, no_final, both};
+    for (size_t i = 0; i < 3; i++) {
+        assert(layouts[i]->rows == 2 && layouts[i]->cols == 3);
+        assert(memcmp(layouts[i]->cells, crlf->cells, 6) == 0);
+        assert(layout_is_wall(layouts[i], 1, 0) && !layout_is_wall(layouts[i], 0, 0));
+    }
+    layout_free(crlf);
+    layout_free(no_final);
+    layout_free(both);
+}
+
+// Tests that a header that isn't two or three positive numbers is rejected.
+void test_bad_header() {
+    assert(load_text("") == NULL);
+    assert(load_text("\n#\n") == NULL);
+    assert(load_text("1\n#\n") == NULL);
+    assert(load_text("one 1\n#\n") == NULL);
+    assert(load_text("1 x\n#\n") == NULL);
+    assert(load_text("0 1\n") == NULL);
+    assert(load_text("1 0\n\n") == NULL);
+    assert(load_text("-1 1\n#\n") == NULL);
+    assert(load_text("1 1 0\n#\n") == NULL);
+    assert(load_text("1 1 10 4\n#\n") == NULL);
+    assert(load_text("1 1") == NULL);
+}
+
+// Tests that dimensions too large for an int, or whose product is, are
+// rejected rather than wrapped around.
+void test_overflow() {
+    assert(load_text("2147483648 1\n#\n") == NULL);
+    assert(load_text("99999999999999999999 1\n#\n") == NULL);
+    assert(load_text("1 1 4294967306\n#\n") == NULL);
+    assert(load_text("65536 65536\n#\n") == NULL);
+    assert(load_text("46341 46341\n#\n") == NULL);
+}
+
+// Tests that rows shorter or longer than the header says are rejected.
+void test_row_length() {
+    assert(load_text("2 3\n#.#\n..\n") == NULL);
+    assert(load_text("2 3\n#.\n...\n") == NULL);
+    assert(load_text("2 3\n#.##\n...\n") == NULL);
+    assert(load_text("2 3\n#.#\n....\n") == NULL);
+    assert(load_text("2 3\n#.#\n...\r") == NULL);
+    assert(load_text("2 3\n#.#\r\r\n...\n") == NULL);
+}
+
+// Tests that missing rows, extra rows and unknown cells are rejected.
+void test_row_count_and_cells() {
+    assert(load_text("3 3\n#.#\n...\n") == NULL);
+    assert(load_text("3 3\n#.#\n...\n\n") == NULL);
+    assert(load_text("1 3\n#.#\n...\n") == NULL);
+    assert(load_text("1 3\n#.#\n\n") == NULL);
+    assert(load_text("1 3\n#o#\n") == NULL);
+    assert(load_text("1 3\n# #\n") == NULL);
+    // the file ends partway through the only row
+    assert(load_text("1 3\n#") == NULL);
+}
+
+// Tests building a layout in code.
+void test_init_and_set() {
+    layout_t *layout = layout_init(4, 2);
+    assert(layout->rows == 4 && layout->cols == 2 && layout->cell_size == 0);
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 2; c++) {
+            assert(!layout_is_wall(layout, r, c));
+        }
+    }
+    layout_set_wall(layout, 3, 1, true);
+    assert(layout_is_wall(layout, 3, 1) && !layout_is_wall(layout, 3, 0));
+    layout_set_wall(layout, 3, 1, false);
+    assert(!layout_is_wall(layout, 3, 1));
+    layout_free(layout);
+}
+
+// Tests that a missing file is reported rather than crashing.
+void test_missing_file() {
+    assert(layout_load("/nonexistent/test.map") == NULL);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_example)
+    DO_TEST(test_rows_top_to_bottom)
+    DO_TEST(test_line_ends)
+    DO_TEST(test_bad_header)
+    DO_TEST(test_overflow)
+    DO_TEST(test_row_length)
+    DO_TEST(test_row_count_and_cells)
+    DO_TEST(test_init_and_set)
+    DO_TEST(test_missing_file)
+
+    puts("layout_test PASS");
+}
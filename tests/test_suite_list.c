@@ -1,6 +1,186 @@
+#include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include "list.h"
+#include "test_util.h"
 
-int main(){
-  printf("No test here...");
-  return 0;
+int VALUES[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// Asserts that the list holds exactly the given values, in order.
+void assert_values(list_t *list, const int *expected, size_t size) {
+    assert(list_size(list) == size);
+    for (size_t i = 0; i < size; i++) {
+        assert(*(int *)list_get(list, i) == expected[i]);
+    }
+}
+
+// A deque of capacity 4 holding 2, 3, 4, 5, where 4 and 5 have wrapped
+// around to the start of its array.
+list_t *wrapped_deque() {
+    list_t *list = list_init_deque(4, NULL);
+    for (size_t i = 0; i < 4; i++) {
+        list_add(list, &VALUES[i]);
+    }
+    list_pop_front(list);
+    list_pop_front(list);
+    list_add(list, &VALUES[4]);
+    list_add(list, &VALUES[5]);
+    assert(list_capacity(list) == 4);
+    return list;
+}
+
+// Tests that popping from the front of a deque keeps order and never
+// grows it, however many times it goes round.
+void test_pop_front() {
+    list_t *list = list_init_deque(4, NULL);
+    list_add(list, &VALUES[0]);
+    list_add(list, &VALUES[1]);
+    for (int i = 2; i < 16; i++) {
+        assert(*(int *)list_pop_front(list) == i - 2);
+        list_add(list, &VALUES[i]);
+        assert(list_size(list) == 2 && list_capacity(list) == 4);
+    }
+    assert(*(int *)list_pop_front(list) == 14);
+    assert(*(int *)list_pop_front(list) == 15);
+    assert(list_size(list) == 0);
+    list_free(list);
+}
+
+// Tests that a plain list pops from the front too.
+void test_pop_front_plain() {
+    list_t *list = list_init(4, NULL);
+    for (size_t i = 0; i < 3; i++) {
+        list_add(list, &VALUES[i]);
+    }
+    assert(*(int *)list_pop_front(list) == 0);
+    int expected[] = {1, 2};
+    assert_values(list, expected, 2);
+    list_free(list);
+}
+
+// Tests that a full wrapped deque grows with its order intact.
+void test_grow_wrapped() {
+    list_t *list = wrapped_deque();
+    list_add(list, &VALUES[6]);
+    assert(list_capacity(list) > 4);
+    int expected[] = {2, 3, 4, 5, 6};
+    assert_values(list, expected, 5);
+    list_free(list);
+}
+
+// Tests removing from the middle of a wrapped deque.
+void test_remove_wrapped() {
+    list_t *list = wrapped_deque();
+    assert(*(int *)list_remove(list, 2) == 4);
+    int expected[] = {2, 3, 5};
+    assert_values(list, expected, 3);
+    assert(*(int *)list_remove(list, 0) == 2);
+    assert(*(int *)list_remove(list, 1) == 5);
+    assert_values(list, expected + 1, 1);
+    list_free(list);
+}
+
+// Tests that swap removal moves the last element into the gap, on a plain
+// list and across the wrap of a deque.
+void test_swap_remove() {
+    list_t *list = list_init(4, NULL);
+    for (size_t i = 0; i < 4; i++) {
+        list_add(list, &VALUES[i]);
+    }
+    assert(*(int *)list_swap_remove(list, 1) == 1);
+    int plain[] = {0, 3, 2};
+    assert_values(list, plain, 3);
+    assert(*(int *)list_swap_remove(list, 2) == 2);
+    assert_values(list, plain, 2);
+    list_free(list);
+
+    list = wrapped_deque();
+    assert(*(int *)list_swap_remove(list, 0) == 2);
+    int wrapped[] = {5, 3, 4};
+    assert_values(list, wrapped, 3);
+    list_free(list);
+}
+
+size_t freed_count = 0;
+
+void count_free(void *elem) {
+    freed_count++;
+}
+
+// Tests that truncating drops the tail without freeing it, and that the
+// list can be added to again after.
+void test_truncate() {
+    list_t *list = list_init(4, count_free);
+    for (size_t i = 0; i < 6; i++) {
+        list_add(list, &VALUES[i]);
+    }
+    freed_count = 0;
+    list_truncate(list, 2);
+    assert(freed_count == 0);
+    list_add(list, &VALUES[9]);
+    int expected[] = {0, 1, 9};
+    assert_values(list, expected, 3);
+    list_truncate(list, 0);
+    assert(list_size(list) == 0);
+    list_free(list);
+    assert(freed_count == 0);
+
+    list = wrapped_deque();
+    list_truncate(list, 3);
+    int wrapped[] = {2, 3, 4};
+    assert_values(list, wrapped, 3);
+    list_free(list);
+}
+
+// Tests that clearing frees each element once, keeps the capacity, and
+// leaves a deque usable from the start.
+void test_clear() {
+    list_t *list = list_init_deque(4, count_free);
+    for (size_t i = 0; i < 4; i++) {
+        list_add(list, &VALUES[i]);
+    }
+    list_pop_front(list);
+    list_add(list, &VALUES[4]);
+    freed_count = 0;
+    list_clear(list);
+    assert(freed_count == 4);
+    assert(list_size(list) == 0 && list_capacity(list) == 4);
+    list_add(list, &VALUES[7]);
+    assert_values(list, &VALUES[7], 1);
+    list_free(list);
+    assert(freed_count == 5);
+}
+
+// Tests that reserving grows once, to at least the size asked for, and
+// never shrinks.
+void test_reserve() {
+    list_t *list = wrapped_deque();
+    list_reserve(list, 10);
+    assert(list_capacity(list) >= 10);
+    int expected[] = {2, 3, 4, 5};
+    assert_values(list, expected, 4);
+    list_reserve(list, 2);
+    assert(list_capacity(list) >= 10);
+    list_free(list);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_pop_front)
+    DO_TEST(test_pop_front_plain)
+    DO_TEST(test_grow_wrapped)
+    DO_TEST(test_remove_wrapped)
+    DO_TEST(test_swap_remove)
+    DO_TEST(test_truncate)
+    DO_TEST(test_clear)
+    DO_TEST(test_reserve)
+
+    puts("list_test PASS");
 }
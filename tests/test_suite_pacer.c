@@ -0,0 +1,97 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pacer.h"
+#include "test_util.h"
+#include "timestep.h"
+
+const double RATE = 200;
+const size_t FRAMES = 10;
+
+// Takes the given number of seconds, as a slow frame would.
+void spend(double seconds) {
+    struct timespec duration = {0, (long)(seconds * 1e9)};
+    nanosleep(&duration, NULL);
+}
+
+// Tests that paced iterations take at least a period each, mostly asleep.
+void test_paced() {
+    pacer_t *pacer = pacer_init(RATE);
+    pacer_wait(pacer);
+    assert(pacer_frames(pacer) == 0);
+    double start = timestep_now();
+    for (size_t i = 0; i < FRAMES; i++) {
+        pacer_wait(pacer);
+    }
+    double elapsed = timestep_now() - start;
+    assert(pacer_frames(pacer) == FRAMES);
+    // the first deadline was a period after the clock started
+    assert(elapsed >= (FRAMES - 1) / RATE);
+    assert(pacer_slept(pacer) > 0);
+    assert(pacer_slept(pacer) <= elapsed);
+    pacer_free(pacer);
+}
+
+// Tests that a rate of 0 only counts.
+void test_unpaced() {
+    pacer_t *pacer = pacer_init(0);
+    for (size_t i = 0; i <= FRAMES; i++) {
+        pacer_wait(pacer);
+    }
+    assert(pacer_frames(pacer) == FRAMES);
+    assert(pacer_missed(pacer) == 0 && pacer_slept(pacer) == 0);
+    pacer_free(pacer);
+}
+
+// Tests that a late iteration is counted with how late it was, and that
+// the next deadline is a whole period after it rather than already past.
+void test_missed() {
+    pacer_t *pacer = pacer_init(RATE);
+    pacer_wait(pacer);
+    spend(5 / RATE);
+    pacer_wait(pacer);
+    assert(pacer_missed(pacer) == 1);
+    assert(pacer_worst_late(pacer) >= 4 / RATE);
+    assert(pacer_slept(pacer) == 0);
+    double start = timestep_now();
+    pacer_wait(pacer);
+    assert(timestep_now() - start >= .5 / RATE);
+    assert(pacer_slept(pacer) > 0);
+    pacer_free(pacer);
+}
+
+// Tests the summary line.
+void test_print() {
+    pacer_t *pacer = pacer_init(RATE);
+    pacer_wait(pacer);
+    pacer_wait(pacer);
+    FILE *file = tmpfile();
+    assert(file != NULL);
+    pacer_print(pacer, "render", file);
+    rewind(file);
+    char line[128];
+    char *read = fgets(line, sizeof(line), file);
+    assert(read != NULL);
+    assert(strncmp(line, "render: 1 frames at 200 Hz, 0 missed", 36) == 0);
+    fclose(file);
+    pacer_free(pacer);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_paced)
+    DO_TEST(test_unpaced)
+    DO_TEST(test_missed)
+    DO_TEST(test_print)
+
+    puts("pacer_test PASS");
+}
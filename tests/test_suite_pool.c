@@ -0,0 +1,127 @@
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "body.h"
+#include "object.h"
+#include "pool.h"
+#include "scene.h"
+#include "session.h"
+#include "test_util.h"
+
+// Tests that released elements are handed out again before a slab is added.
+void test_reuse() {
+    pool_t *pool = pool_init(sizeof(double), 4);
+    void *elems[4];
+    for (size_t i = 0; i < 4; i++) {
+        elems[i] = pool_alloc(pool);
+    }
+    assert(pool_stats(pool).slabs == 1);
+    pool_release(pool, elems[2]);
+    pool_release(pool, elems[0]);
+    // most recently released first
+    void *first = pool_alloc(pool);
+    void *second = pool_alloc(pool);
+    assert(first == elems[0] && second == elems[2]);
+    assert(pool_stats(pool).slabs == 1);
+    pool_free(pool);
+}
+
+// Tests that a full pool adds slabs, keeping every element distinct,
+// aligned and writable.
+void test_grow() {
+    const size_t COUNT = 100;
+    pool_t *pool = pool_init(3, 8);
+    unsigned char **elems = malloc(COUNT * sizeof(unsigned char *));
+    assert(elems != NULL);
+    for (size_t i = 0; i < COUNT; i++) {
+        elems[i] = pool_alloc(pool);
+        assert((uintptr_t)elems[i] % alignof(max_align_t) == 0);
+        memset(elems[i], (int)i, 3);
+    }
+    for (size_t i = 0; i < COUNT; i++) {
+        assert(elems[i][0] == (unsigned char)i && elems[i][2] == (unsigned char)i);
+    }
+    pool_stats_t stats = pool_stats(pool);
+    assert(stats.slabs == (COUNT + 7) / 8);
+    assert(stats.capacity == stats.slabs * 8);
+    free(elems);
+    pool_free(pool);
+}
+
+// Tests the live and peak counts as elements come and go.
+void test_stats() {
+    pool_t *pool = pool_init(sizeof(int), 16);
+    pool_stats_t stats = pool_stats(pool);
+    assert(stats.live == 0 && stats.peak == 0);
+    assert(stats.capacity == 0 && stats.slabs == 0);
+    void *a = pool_alloc(pool);
+    void *b = pool_alloc(pool);
+    void *c = pool_alloc(pool);
+    pool_release(pool, b);
+    stats = pool_stats(pool);
+    assert(stats.live == 2 && stats.peak == 3);
+    assert(stats.capacity == 16 && stats.slabs == 1);
+    pool_release(pool, a);
+    pool_release(pool, c);
+    b = pool_alloc(pool);
+    stats = pool_stats(pool);
+    assert(stats.live == 1 && stats.peak == 3);
+    pool_release(pool, b);
+    pool_free(pool);
+}
+
+void release_twice(void *aux) {
+    pool_t *pool = aux;
+    void *elem = pool_alloc(pool);
+    pool_release(pool, elem);
+    pool_release(pool, elem);
+}
+
+// Tests that releasing an element twice is caught.
+void test_double_release() {
+    pool_t *pool = pool_init(sizeof(int), 4);
+    assert(test_assert_fail(release_twice, pool));
+    pool_free(pool);
+}
+
+// Tests that a whole session gives back every body, object and force it
+// took from the library's pools.
+void test_session_returns_all() {
+    size_t bodies = body_pool_stats().live;
+    size_t objects = object_pool_stats().live;
+    size_t forces = force_pool_stats().live;
+    session_t *session = session_init(1);
+    assert(body_pool_stats().live > bodies);
+    assert(object_pool_stats().live > objects);
+    // a bullet brings its collision forces along
+    session_key(session, 'w', KEY_PRESSED);
+    assert(force_pool_stats().live > forces);
+    for (int i = 0; i < 10; i++) {
+        session_step(session, 1.0 / 120);
+    }
+    session_free(session);
+    assert(body_pool_stats().live == bodies);
+    assert(object_pool_stats().live == objects);
+    assert(force_pool_stats().live == forces);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_reuse)
+    DO_TEST(test_grow)
+    DO_TEST(test_stats)
+    DO_TEST(test_double_release)
+    DO_TEST(test_session_returns_all)
+
+    puts("pool_test PASS");
+}
@@ -0,0 +1,219 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "replay.h"
+#include "session.h"
+#include "test_util.h"
+
+// Makes a path for a temporary recording; the caller unlinks it.
+void temp_path(char path[]) {
+    strcpy(path, "/tmp/test_replay_XXXXXX");
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+}
+
+// Writes size bytes to path, replacing it.
+void write_bytes(const char *path, const unsigned char *bytes, size_t size) {
+    FILE *file = fopen(path, "wb");
+    assert(file != NULL);
+    size_t written = fwrite(bytes, 1, size, file);
+    assert(written == size);
+    fclose(file);
+}
+
+// Reads path into bytes, returning how many there were.
+size_t read_bytes(const char *path, unsigned char *bytes, size_t capacity) {
+    FILE *file = fopen(path, "rb");
+    assert(file != NULL);
+    size_t size = fread(bytes, 1, capacity, file);
+    fclose(file);
+    return size;
+}
+
+// Tests that a recording reads back with its seed, rate, events and length.
+void test_round_trip() {
+    char path[32];
+    temp_path(path);
+    recorder_t *recorder = recorder_open(path, 0x0123456789abcdefULL, 120);
+    recorder_key(recorder, 0, 'w', KEY_PRESSED);
+    recorder_key(recorder, 5, 'w', KEY_RELEASED);
+    recorder_key(recorder, 5, 'q', KEY_PRESSED);
+    recorder_close(recorder, 9);
+    replay_t *replay = replay_open(path);
+    unlink(path);
+    assert(replay != NULL);
+    assert(replay_seed(replay) == 0x0123456789abcdefULL);
+    assert(replay_rate(replay) == 120);
+    assert(replay_ticks(replay) == 9);
+    assert(replay_events(replay) == 3);
+    replay_event_t event;
+    assert(replay_next(replay, 0, &event) == 1);
+    assert(event.tick == 0 && event.key == 'w' && event.type == KEY_PRESSED);
+    assert(replay_next(replay, 0, &event) == 0);
+    for (uint32_t tick = 1; tick < 5; tick++) {
+        assert(replay_next(replay, tick, &event) == 0);
+    }
+    assert(replay_next(replay, 5, &event) == 1);
+    assert(event.tick == 5 && event.key == 'w' && event.type == KEY_RELEASED);
+    assert(replay_next(replay, 5, &event) == 1);
+    assert(event.tick == 5 && event.key == 'q' && event.type == KEY_PRESSED);
+    assert(replay_next(replay, 9, &event) == 0);
+    replay_free(replay);
+}
+
+// Tests the bytes of a recording against the format in replay.h.
+void test_format() {
+    char path[32];
+    temp_path(path);
+    recorder_t *recorder = recorder_open(path, 0x0807060504030201ULL, 0x1234);
+    recorder_key(recorder, 0x0a0b0c0d, 'e', KEY_RELEASED);
+    recorder_close(recorder, 0x0a0b0c0e);
+    unsigned char bytes[64];
+    size_t size = read_bytes(path, bytes, sizeof(bytes));
+    unlink(path);
+    const unsigned char EXPECTED[] = {
+        'A', 'L', 'R', 'P', REPLAY_VERSION, 0, 0x34, 0x12,
+        1, 2, 3, 4, 5, 6, 7, 8,
+        0x0d, 0x0c, 0x0b, 0x0a, 'e', 1,
+        0x0e, 0x0c, 0x0b, 0x0a, 0, 0};
+    assert(size == sizeof(EXPECTED));
+    assert(memcmp(bytes, EXPECTED, size) == 0);
+}
+
+// Tests that a recording with no events but the end marker is valid.
+void test_no_events() {
+    char path[32];
+    temp_path(path);
+    recorder_close(recorder_open(path, 3, 60), 0);
+    replay_t *replay = replay_open(path);
+    unlink(path);
+    assert(replay != NULL);
+    assert(replay_events(replay) == 0 && replay_ticks(replay) == 0);
+    replay_event_t event;
+    assert(replay_next(replay, 0, &event) == 0);
+    replay_free(replay);
+}
+
+// Tests that damaged recordings are rejected: each is a valid one with a
+// byte changed, or cut short.
+void test_rejected() {
+    char path[32];
+    temp_path(path);
+    recorder_t *recorder = recorder_open(path, 42, 60);
+    recorder_key(recorder, 2, 'a', KEY_PRESSED);
+    recorder_key(recorder, 3, 'a', KEY_RELEASED);
+    recorder_close(recorder, 4);
+    unsigned char valid[64];
+    size_t size = read_bytes(path, valid, sizeof(valid));
+    assert(size == 16 + 3 * 6);
+    unsigned char bytes[64];
+
+    // not a recording
+    memcpy(bytes, valid, size);
+    bytes[0] = 'X';
+    write_bytes(path, bytes, size);
+    assert(replay_open(path) == NULL);
+    // another version
+    memcpy(bytes, valid, size);
+    bytes[4] = REPLAY_VERSION + 1;
+    write_bytes(path, bytes, size);
+    assert(replay_open(path) == NULL);
+    // no step rate
+    memcpy(bytes, valid, size);
+    bytes[6] = bytes[7] = 0;
+    write_bytes(path, bytes, size);
+    assert(replay_open(path) == NULL);
+    // the second event before the first
+    memcpy(bytes, valid, size);
+    bytes[16 + 6] = 1;
+    write_bytes(path, bytes, size);
+    assert(replay_open(path) == NULL);
+    // the session ending before the last event
+    memcpy(bytes, valid, size);
+    bytes[16 + 12] = 1;
+    write_bytes(path, bytes, size);
+    assert(replay_open(path) == NULL);
+    // cut short anywhere: in the header, mid-event, or before the end marker
+    for (size_t cut = 0; cut < size; cut++) {
+        write_bytes(path, valid, cut);
+        assert(replay_open(path) == NULL);
+    }
+    // and the whole thing again, still valid
+    write_bytes(path, valid, size);
+    replay_t *replay = replay_open(path);
+    assert(replay != NULL && replay_events(replay) == 2);
+    replay_free(replay);
+    unlink(path);
+    assert(replay_open(path) == NULL);
+}
+
+// Plays a recording back like bin/replay and returns the final state hash.
+uint64_t play(const char *path) {
+    replay_t *replay = replay_open(path);
+    assert(replay != NULL);
+    session_t *session = session_init(replay_seed(replay));
+    double dt = 1.0 / replay_rate(replay);
+    replay_event_t event;
+    for (uint32_t tick = 0; ; tick++) {
+        while (replay_next(replay, tick, &event)) {
+            session_key(session, event.key, event.type);
+        }
+        if (tick == replay_ticks(replay) || session->quit) {
+            break;
+        }
+        session_step(session, dt);
+    }
+    uint64_t hash = session_hash(session);
+    session_free(session);
+    replay_free(replay);
+    return hash;
+}
+
+// Tests that a session left in the middle of something, here hiding, does
+// not change how the next session in the same process plays out.
+void test_sessions_back_to_back() {
+    char path[32];
+    temp_path(path);
+    recorder_t *recorder = recorder_open(path, 42, 60);
+    recorder_key(recorder, 0, RIGHT_ARROW, KEY_PRESSED);
+    recorder_key(recorder, 60, RIGHT_ARROW, KEY_RELEASED);
+    recorder_key(recorder, 70, 'w', KEY_PRESSED);
+    recorder_key(recorder, 71, 'w', KEY_RELEASED);
+    recorder_close(recorder, 120);
+    uint64_t first = play(path);
+
+    session_t *session = session_init(42);
+    map_t *map = session->map;
+    object_t *spot = list_get(map->hiding_spots, 0);
+    spot->is_purchased = true;
+    body_set_centroid(map->player->body, body_get_centroid(spot->body));
+    object_calc_min_max(map->player);
+    map_hide_player(map);
+    assert(is_hiding(map));
+    session_free(session);
+
+    uint64_t second = play(path);
+    unlink(path);
+    assert(second == first);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_round_trip)
+    DO_TEST(test_format)
+    DO_TEST(test_no_events)
+    DO_TEST(test_rejected)
+    DO_TEST(test_sessions_back_to_back)
+
+    puts("replay_test PASS");
+}
@@ -1,6 +1,64 @@
+#include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include "body.h"
+#include "forces.h"
+#include "scene.h"
+#include "test_util.h"
 
-int main(){
-  printf("No test here...");
-  return 0;
+const size_t BODIES = 8;
+
+// A unit square centered at x along the x axis.
+body_t *make_square(double x) {
+    list_t *shape = list_init(4, free);
+    vector_t corners[] = {{-.5, -.5}, {.5, -.5}, {.5, .5}, {-.5, .5}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *corner = malloc(sizeof(vector_t));
+        assert(corner != NULL);
+        *corner = vec_add(corners[i], (vector_t){x, 0});
+        list_add(shape, corner);
+    }
+    return body_init(shape, 1, (rgb_color_t){0, 0, 0});
+}
+
+// Tests that removing bodies keeps the rest in the order they were added,
+// which is the order they are drawn in, and drops the forces acting on them.
+void test_remove_keeps_order() {
+    scene_t *scene = scene_init();
+    body_t *bodies[BODIES];
+    for (size_t i = 0; i < BODIES; i++) {
+        bodies[i] = make_square(10 * i);
+        scene_add_body(scene, bodies[i]);
+    }
+    // one force on each of the bodies going away, one between two staying
+    create_drag(scene, 1, bodies[0], 1);
+    create_spring(scene, 1, bodies[3], bodies[6]);
+    create_drag(scene, 1, bodies[5], 1);
+    create_newtonian_gravity(scene, 1, bodies[1], bodies[7]);
+    body_remove(bodies[0]);
+    body_remove(bodies[3]);
+    body_remove(bodies[5]);
+    scene_tick(scene, 0);
+    size_t kept[] = {1, 2, 4, 6, 7};
+    assert(scene_bodies(scene) == 5);
+    for (size_t i = 0; i < 5; i++) {
+        assert(scene_get_body(scene, i) == bodies[kept[i]]);
+    }
+    // the forces on removed bodies went with them, so this only runs gravity
+    scene_tick(scene, 1);
+    scene_free(scene);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_remove_keeps_order)
+
+    puts("scene_test PASS");
 }
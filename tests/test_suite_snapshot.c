@@ -0,0 +1,230 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "renderer.h"
+#include "session.h"
+#include "snapshot.h"
+#include "test_util.h"
+
+const size_t THREAD_ITEMS = 200000;
+
+// Tests that nothing is read before the first publish, and that a publish
+// is read once and then kept.
+void test_read_before_and_after_publish() {
+    snapshot_buffer_t *buffer = snapshot_buffer_init();
+    assert(snapshot_read(buffer) == NULL);
+    snapshot_t *written = snapshot_write_begin(buffer);
+    written->tick = 1;
+    snapshot_publish(buffer);
+    snapshot_t *read = snapshot_read(buffer);
+    assert(read == written && read->tick == 1);
+    assert(snapshot_read(buffer) == read);
+    snapshot_buffer_free(buffer);
+}
+
+// Tests that the reader skips to the latest publish, and that the writer
+// is never handed the snapshot the reader holds.
+void test_latest_and_never_shared() {
+    snapshot_buffer_t *buffer = snapshot_buffer_init();
+    snapshot_write_begin(buffer)->tick = 1;
+    snapshot_publish(buffer);
+    snapshot_t *read = snapshot_read(buffer);
+    for (uint32_t tick = 2; tick <= 10; tick++) {
+        snapshot_t *written = snapshot_write_begin(buffer);
+        assert(written != read);
+        written->tick = tick;
+        snapshot_publish(buffer);
+        assert(read->tick == 1);
+    }
+    read = snapshot_read(buffer);
+    assert(read->tick == 10);
+    assert(snapshot_write_begin(buffer) != read);
+    snapshot_buffer_free(buffer);
+}
+
+// Publishes THREAD_ITEMS snapshots whose tick and player.x agree.
+void *publish_ticks(void *aux) {
+    snapshot_buffer_t *buffer = aux;
+    for (uint32_t tick = 1; tick <= THREAD_ITEMS; tick++) {
+        snapshot_t *snapshot = snapshot_write_begin(buffer);
+        snapshot->tick = tick;
+        snapshot->player = (vector_t){tick, 0};
+        snapshot_publish(buffer);
+    }
+    return NULL;
+}
+
+// Tests that a reader on another thread never sees a snapshot half written
+// or an older one than it saw before.
+void test_threads() {
+    snapshot_buffer_t *buffer = snapshot_buffer_init();
+    pthread_t writer;
+    assert(pthread_create(&writer, NULL, publish_ticks, buffer) == 0);
+    uint32_t last = 0;
+    while (last < THREAD_ITEMS) {
+        snapshot_t *snapshot = snapshot_read(buffer);
+        if (snapshot == NULL || snapshot->tick == last) {
+            sched_yield();
+            continue;
+        }
+        assert(snapshot->tick >= last);
+        assert(snapshot->player.x == snapshot->tick);
+        last = snapshot->tick;
+    }
+    pthread_join(writer, NULL);
+    snapshot_buffer_free(buffer);
+}
+
+// Tests that a capture copies the session's state and its latest
+// background changes, oldest first.
+void test_capture() {
+    renderer_set(&SNAPSHOT_RENDERER);
+    session_t *session = session_init(1);
+    map_t *map = session->map;
+    snapshot_buffer_t *buffer = snapshot_buffer_init();
+    snapshot_t *snapshot = snapshot_write_begin(buffer);
+    snapshot_capture(snapshot, session, 0);
+    uint32_t version = snapshot->background_version;
+    assert(snapshot->tick == session->tick);
+    assert(vec_equal(snapshot->player, body_get_centroid(map->player->body)));
+    assert(snapshot->rows == map_rows(map) && snapshot->cols == map_cols(map));
+    for (int r = 0; r < map_rows(map); r++) {
+        for (int c = 0; c < map_cols(map); c++) {
+            assert(snapshot_coins_at(snapshot, r, c) == map_coins_at(map, r, c));
+        }
+    }
+    // more changes than the log keeps
+    const uint32_t CHANGES = 100;
+    for (uint32_t i = 1; i <= CHANGES; i++) {
+        background_update((vector_t){i, 0}, (vector_t){i, 1});
+    }
+    hud_update_money(7);
+    snapshot_capture(snapshot, session, 0);
+    assert(snapshot->money == 7);
+    assert(snapshot->background_version == version + CHANGES);
+    snapshot_change_list_t *changes = snapshot->background_changes;
+    size_t count = snapshot_change_list_size(changes);
+    assert(count > 0 && count < CHANGES);
+    for (size_t i = 0; i < count; i++) {
+        snapshot_change_t *change = snapshot_change_list_at(changes, i);
+        uint32_t expected = snapshot->background_version - (count - 1 - i);
+        assert(change->version == expected);
+        assert(change->min.x == expected - version);
+    }
+    snapshot_buffer_free(buffer);
+    session_free(session);
+    renderer_set(NULL);
+}
+
+// Tests that a new session's HUD starts from its own values, not from
+// whatever the last session reported.
+void test_session_start() {
+    renderer_set(&SNAPSHOT_RENDERER);
+    session_t *session = session_init(1);
+    snapshot_session_start(session);
+    hud_update_money(7);
+    hud_update_bullets(0);
+    hud_update_stamina(3);
+    session_free(session);
+
+    session = session_init(2);
+    snapshot_session_start(session);
+    snapshot_buffer_t *buffer = snapshot_buffer_init();
+    snapshot_t *snapshot = snapshot_write_begin(buffer);
+    snapshot_capture(snapshot, session, 0);
+    assert(snapshot->money == session->map->purse);
+    assert(snapshot->bullets == session->explosives);
+    assert(snapshot->stamina == session_stamina_percent(session));
+    snapshot_buffer_free(buffer);
+    session_free(session);
+    renderer_set(NULL);
+}
+
+// Tests that keys come out in the order they went in.
+void test_key_queue_order() {
+    key_queue_t *queue = key_queue_init(4);
+    char key;
+    key_event_type_t type;
+    assert(!key_queue_pop(queue, &key, &type));
+    // enough to wrap around the ring several times
+    for (int i = 0; i < 10; i++) {
+        assert(key_queue_push(queue, 'a' + i, KEY_PRESSED));
+        assert(key_queue_push(queue, 'a' + i, KEY_RELEASED));
+        assert(key_queue_pop(queue, &key, &type) && key == 'a' + i && type == KEY_PRESSED);
+        assert(key_queue_pop(queue, &key, &type) && key == 'a' + i && type == KEY_RELEASED);
+        assert(!key_queue_pop(queue, &key, &type));
+    }
+    key_queue_free(queue);
+}
+
+// Tests that a full queue drops new keys and keeps the old ones.
+void test_key_queue_full() {
+    key_queue_t *queue = key_queue_init(4);
+    for (int i = 0; i < 4; i++) {
+        assert(key_queue_push(queue, '0' + i, KEY_PRESSED));
+    }
+    assert(!key_queue_push(queue, 'x', KEY_PRESSED));
+    char key;
+    key_event_type_t type;
+    assert(key_queue_pop(queue, &key, &type) && key == '0');
+    assert(key_queue_push(queue, 'y', KEY_RELEASED));
+    for (int i = 1; i < 4; i++) {
+        assert(key_queue_pop(queue, &key, &type) && key == '0' + i);
+    }
+    assert(key_queue_pop(queue, &key, &type) && key == 'y' && type == KEY_RELEASED);
+    assert(!key_queue_pop(queue, &key, &type));
+    key_queue_free(queue);
+}
+
+// Pushes THREAD_ITEMS keys, retrying while the queue is full.
+void *push_keys(void *aux) {
+    key_queue_t *queue = aux;
+    for (size_t i = 0; i < THREAD_ITEMS; i++) {
+        key_event_type_t type = i % 2 == 0 ? KEY_PRESSED : KEY_RELEASED;
+        while (!key_queue_push(queue, (char)(i % 128), type)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Tests that keys pushed on one thread are popped on another in order.
+void test_key_queue_threads() {
+    key_queue_t *queue = key_queue_init(16);
+    pthread_t pusher;
+    assert(pthread_create(&pusher, NULL, push_keys, queue) == 0);
+    for (size_t i = 0; i < THREAD_ITEMS; i++) {
+        char key;
+        key_event_type_t type;
+        while (!key_queue_pop(queue, &key, &type)) {
+            sched_yield();
+        }
+        assert(key == (char)(i % 128));
+        assert(type == (i % 2 == 0 ? KEY_PRESSED : KEY_RELEASED));
+    }
+    pthread_join(pusher, NULL);
+    key_queue_free(queue);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_read_before_and_after_publish)
+    DO_TEST(test_latest_and_never_shared)
+    DO_TEST(test_threads)
+    DO_TEST(test_capture)
+    DO_TEST(test_session_start)
+    DO_TEST(test_key_queue_order)
+    DO_TEST(test_key_queue_full)
+    DO_TEST(test_key_queue_threads)
+
+    puts("snapshot_test PASS");
+}
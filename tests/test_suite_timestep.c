@@ -0,0 +1,84 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "test_util.h"
+#include "timestep.h"
+
+// A power of two, so steps and their sums are exact doubles.
+const double RATE = 64;
+const double STEP = 1.0 / 64;
+const int MAX_CATCH_UP = 4;
+
+// Tests that time comes out in whole steps, with the remainder carried over
+// and reported as the interpolation factor.
+void test_whole_steps() {
+    timestep_t *ts = timestep_init(RATE, MAX_CATCH_UP);
+    assert(timestep_dt(ts) == STEP);
+    assert(timestep_advance(ts, STEP / 2) == 0);
+    assert(timestep_alpha(ts) == .5);
+    assert(timestep_advance(ts, STEP) == 1);
+    assert(timestep_alpha(ts) == .5);
+    assert(timestep_advance(ts, STEP / 2 + 2 * STEP) == 3);
+    assert(timestep_alpha(ts) == 0);
+    assert(timestep_steps(ts) == 4);
+    assert(timestep_dropped(ts) == 0);
+    timestep_free(ts);
+}
+
+// Tests that a long frame runs at most MAX_CATCH_UP steps and drops the
+// rest of its backlog, part step included, instead of owing it to the next
+// frame.
+void test_catch_up_clamped() {
+    timestep_t *ts = timestep_init(RATE, MAX_CATCH_UP);
+    assert(timestep_advance(ts, 10 * STEP + STEP / 4) == MAX_CATCH_UP);
+    assert(within(1e-12, timestep_dropped(ts), 6 * STEP + STEP / 4));
+    assert(timestep_alpha(ts) == 0);
+    // the next frame only gets its own time
+    assert(timestep_advance(ts, STEP) == 1);
+    assert(timestep_steps(ts) == MAX_CATCH_UP + 1);
+    // exactly the cap is not a drop
+    double dropped = timestep_dropped(ts);
+    assert(timestep_advance(ts, MAX_CATCH_UP * STEP) == MAX_CATCH_UP);
+    assert(timestep_dropped(ts) == dropped);
+    timestep_free(ts);
+}
+
+// Tests that negative frame times count as none.
+void test_negative_time() {
+    timestep_t *ts = timestep_init(RATE, MAX_CATCH_UP);
+    assert(timestep_advance(ts, STEP / 2) == 0);
+    assert(timestep_advance(ts, -1) == 0);
+    assert(timestep_alpha(ts) == .5);
+    timestep_free(ts);
+}
+
+// Tests that the first tick only starts the clock, and that the clock
+// never goes backwards.
+void test_tick() {
+    timestep_t *ts = timestep_init(RATE, MAX_CATCH_UP);
+    assert(timestep_tick(ts) == 0);
+    assert(timestep_steps(ts) == 0);
+    double before = timestep_now();
+    double after = timestep_now();
+    assert(after >= before);
+    int steps = timestep_tick(ts);
+    assert(steps >= 0 && steps <= MAX_CATCH_UP);
+    timestep_free(ts);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_whole_steps)
+    DO_TEST(test_catch_up_clamped)
+    DO_TEST(test_negative_time)
+    DO_TEST(test_tick)
+
+    puts("timestep_test PASS");
+}
@@ -0,0 +1,133 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "list.h"
+#include "polygon.h"
+#include "test_util.h"
+#include "typed_list.h"
+#include "vec_list.h"
+
+// A second instance, to check the macros work for another type.
+typedef struct pair {
+    int a;
+    char b;
+} pair_t;
+
+DECLARE_LIST(pair_list, pair_t)
+DEFINE_LIST(pair_list, pair_t)
+
+// Tests adding past the first capacity, and reading back by value and by
+// pointer.
+void test_add_get() {
+    vec_list_t *list = vec_list_init(2);
+    for (int i = 0; i < 10; i++) {
+        vec_list_add(list, (vector_t){i, -i});
+    }
+    assert(vec_list_size(list) == 10 && vec_list_capacity(list) >= 10);
+    for (size_t i = 0; i < 10; i++) {
+        assert(vec_equal(vec_list_get(list, i), (vector_t){i, -(double)i}));
+        assert(vec_list_at(list, i) == vec_list_data(list) + i);
+    }
+    vec_list_at(list, 3)->x = 30;
+    vec_list_set(list, 4, VEC_ZERO);
+    assert(vec_list_get(list, 3).x == 30);
+    assert(vec_equal(vec_list_get(list, 4), VEC_ZERO));
+    vec_list_free(list);
+}
+
+// Tests that remove keeps order and swap_remove fills the gap from the end.
+void test_remove() {
+    pair_list_t *list = pair_list_init(0);
+    for (int i = 0; i < 5; i++) {
+        pair_list_add(list, (pair_t){i, 'a' + i});
+    }
+    assert(pair_list_remove(list, 1).a == 1);
+    int kept[] = {0, 2, 3, 4};
+    for (size_t i = 0; i < 4; i++) {
+        assert(pair_list_get(list, i).a == kept[i]);
+        assert(pair_list_get(list, i).b == 'a' + kept[i]);
+    }
+    assert(pair_list_swap_remove(list, 0).a == 0);
+    int swapped[] = {4, 2, 3};
+    for (size_t i = 0; i < 3; i++) {
+        assert(pair_list_get(list, i).a == swapped[i]);
+    }
+    assert(pair_list_swap_remove(list, 2).a == 3);
+    assert(pair_list_size(list) == 2);
+    pair_list_free(list);
+}
+
+// Tests truncate, clear and reserve.
+void test_truncate_clear_reserve() {
+    vec_list_t *list = vec_list_init(4);
+    for (int i = 0; i < 4; i++) {
+        vec_list_add(list, (vector_t){i, i});
+    }
+    vec_list_truncate(list, 1);
+    assert(vec_list_size(list) == 1);
+    vec_list_add(list, (vector_t){9, 9});
+    assert(vec_equal(vec_list_get(list, 1), (vector_t){9, 9}));
+    vec_list_reserve(list, 100);
+    assert(vec_list_capacity(list) == 100);
+    assert(vec_equal(vec_list_get(list, 0), VEC_ZERO));
+    vec_list_reserve(list, 10);
+    assert(vec_list_capacity(list) == 100);
+    vec_list_clear(list);
+    assert(vec_list_size(list) == 0 && vec_list_capacity(list) == 100);
+    vec_list_free(list);
+}
+
+// Tests that an arena list grows inside the arena, and that freeing it
+// leaves the arena to release the memory.
+void test_arena() {
+    arena_t *arena = arena_init(1 << 12);
+    vec_list_t *list = vec_list_init_in(arena, 1);
+    for (int i = 0; i < 50; i++) {
+        vec_list_add(list, (vector_t){i, 0});
+    }
+    for (size_t i = 0; i < 50; i++) {
+        assert(vec_list_get(list, i).x == i);
+    }
+    vec_list_free(list);
+    assert(arena_used(arena) > 50 * sizeof(vector_t));
+    arena_free(arena);
+}
+
+// Tests that a polygon keeps its own copies of the points it is given, as
+// polygon_set_points() frees the list it is passed.
+void test_polygon_copies() {
+    list_t *points = list_init(3, free);
+    vector_t corners[] = {{0, 0}, {2, 0}, {0, 2}};
+    for (size_t i = 0; i < 3; i++) {
+        vector_t *corner = malloc(sizeof(vector_t));
+        assert(corner != NULL);
+        *corner = corners[i];
+        list_add(points, corner);
+    }
+    polygon_t *polygon = polygon_init(3);
+    polygon_set_points(polygon, points);
+    vec_list_t *kept = polygon_get_points(polygon);
+    assert(vec_list_size(kept) == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(vec_equal(vec_list_get(kept, i), corners[i]));
+    }
+    polygon_free(polygon);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_add_get)
+    DO_TEST(test_remove)
+    DO_TEST(test_truncate_clear_reserve)
+    DO_TEST(test_arena)
+    DO_TEST(test_polygon_copies)
+
+    puts("vec_list_test PASS");
+}